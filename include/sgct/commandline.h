@@ -27,12 +27,36 @@ struct Configuration {
     std::optional<bool> ignoreSync;
     std::optional<Settings::CaptureFormat> captureFormat;
     std::optional<int> nCaptureThreads;
+    std::optional<int> nCaptureBuffers;
+    std::optional<int> captureQueueSize;
+    std::optional<bool> dropCaptureFrames;
+    std::optional<ivec4> captureRegion;
+    std::optional<int> nCaptureTiles;
+    std::optional<std::string> captureEncoder;
+    std::optional<bool> captureEncoderRawFrames;
+    std::optional<int> captureFrameRate;
+    std::optional<int> nJobThreads;
+    std::optional<int> imageBufferPoolSize;
+    std::optional<bool> useHugePages;
+    std::optional<int> textureUploadBudget;
+    std::optional<int> textureMemoryBudget;
     std::optional<bool> exportCorrectionMeshes;
+    std::optional<bool> useCorrectionMeshCache;
+    std::optional<std::string> correctionMeshCachePath;
+    std::optional<float> correctionMeshMaxError;
+    std::optional<bool> useCorrectionMeshStrips;
     std::optional<std::string> screenshotPath;
     std::optional<std::string> screenshotPrefix;
     std::optional<bool> addNodeNameInScreenshot;
     std::optional<bool> omitWindowNameInScreenshot;
     std::optional<bool> useOpenGLDebugContext;
+    std::optional<bool> useFramePacing;
+    std::optional<double> framePacingMargin;
+    std::optional<bool> useDynamicResolution;
+    std::optional<double> dynamicResolutionTarget;
+    std::optional<float> dynamicResolutionMinScale;
+    std::optional<std::string> recordSharedData;
+    std::optional<std::string> replaySharedData;
 };
 
 /**
@@ -0,0 +1,111 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__COMPRESSEDTEXTURE__H__
+#define __SGCT__COMPRESSEDTEXTURE__H__
+
+#include <sgct/math.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Reading and writing of textures that are compressed with the GPU block compression
+ * formats BC1, BC3, and BC7 and stored in DDS, KTX, or KTX2 containers together with
+ * their mipmap levels. These textures can be uploaded without decoding and use a quarter
+ * to an eighth of the memory of uncompressed textures.
+ *
+ * The levels are stored with the rows of blocks from bottom to top, which is the layout
+ * of the Image class and the order in which OpenGL expects them. Containers that store
+ * their rows from top to bottom are flipped when they are read and written. The blocks
+ * of BC7 textures and of levels whose height is larger than 4 and not a multiple of 4
+ * cannot be flipped exactly, so these textures keep the order of the file instead.
+ */
+namespace sgct {
+
+struct CompressedTexture {
+    enum class Format {
+        BC1,      // RGB, 8 bytes per block
+        BC1Alpha, // RGB with 1 bit alpha, 8 bytes per block
+        BC3,      // RGBA, 16 bytes per block
+        BC7       // RGBA, 16 bytes per block
+    };
+
+    struct Level {
+        ivec2 size = ivec2{ 0, 0 };
+        /// The offset of the level's blocks in the data
+        size_t offset = 0;
+        /// The number of bytes of the level's blocks
+        size_t dataSize = 0;
+    };
+
+    Format format = Format::BC1;
+    bool isSrgb = false;
+    /// The rows of blocks are stored from top to bottom as they could not be flipped.
+    /// The texture is upside down unless the V texture coordinate is flipped
+    bool isTopDown = false;
+    /// The mipmap levels, starting with the largest one
+    std::vector<Level> levels;
+    std::vector<unsigned char> data;
+};
+
+/// Returns the number of bytes of a 4x4 block of pixels in the \p format
+size_t blockSize(CompressedTexture::Format format);
+
+/// Returns the number of bytes of a level with the \p size in pixels in the \p format
+size_t levelSize(CompressedTexture::Format format, ivec2 size);
+
+/// Returns the number of levels of a full mipmap chain for an image of the \p size
+int numberOfMipmapLevels(ivec2 size);
+
+/// Returns true if \p data starts with the identifier of a DDS, KTX, or KTX2 file
+bool isCompressedTexture(const unsigned char* data, size_t size);
+
+/**
+ * Reads the contents of a DDS, KTX, or KTX2 file. Only two-dimensional textures without
+ * array layers, cube faces, or supercompression are supported.
+ *
+ * \param data The contents of the file
+ * \param size The number of bytes in \p data
+ * \param name The name of the file that is used in error messages
+ * \throw Error If the file is invalid or uses an unsupported feature or format
+ */
+CompressedTexture readCompressedTexture(const unsigned char* data, size_t size,
+    const std::string& name);
+
+/**
+ * Loads a DDS, KTX, or KTX2 file.
+ *
+ * \throw Error If the file cannot be opened, is invalid, or is not supported
+ */
+CompressedTexture loadCompressedTexture(const std::string& filename);
+
+/**
+ * Returns the contents of a DDS file with a DX10 header that contains the \p texture.
+ *
+ * \throw Error If the texture is stored from bottom to top and cannot be flipped
+ */
+std::vector<unsigned char> writeDDS(const CompressedTexture& texture);
+
+/**
+ * Compresses an image into BC1 or BC3 blocks. BC7 is not supported as an encoder that
+ * produces good results is far more involved; external tools can be used for it.
+ *
+ * \param pixels The pixel data with 8 bits per channel in the layout of the Image class
+ * \param size The size of the image in pixels
+ * \param channels The number of channels; 1 and 2 channels are treated as gray and gray
+ *        with alpha
+ * \param format The format to compress into, either BC1 or BC3
+ * \return The blocks of the compressed image
+ */
+std::vector<unsigned char> compressBlocks(const unsigned char* pixels, ivec2 size,
+    int channels, CompressedTexture::Format format);
+
+} // namespace sgct
+
+#endif // __SGCT__COMPRESSEDTEXTURE__H__
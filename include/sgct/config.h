@@ -34,7 +34,7 @@ void validateUser(const User& user);
 
 
 struct Capture {
-    enum class Format { PNG, JPG, TGA };
+    enum class Format { PNG, JPG, TGA, QOI };
     struct ScreenShotRange {
         int first = -1; // inclusive
         int last = -1;  // exclusive
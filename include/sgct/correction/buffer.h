@@ -9,6 +9,9 @@
 #ifndef __SGCT__BUFFER__H__
 #define __SGCT__BUFFER__H__
 
+#include <sgct/math.h>
+#include <limits>
+#include <optional>
 #include <vector>
 
 namespace sgct::correction {
@@ -24,10 +27,45 @@ struct CorrectionMeshVertex {
     float a = 0.f;
 };
 
+/**
+ * The projection that some mesh formats define for the viewport in addition to the
+ * geometry. It is applied to the viewport after the mesh has been loaded.
+ */
+struct ViewSetup {
+    struct FieldOfView {
+        float up = 0.f;
+        float down = 0.f;
+        float left = 0.f;
+        float right = 0.f;
+        quat orientation = quat{ 0.f, 0.f, 0.f, 1.f };
+    };
+
+    std::optional<vec3> userPosition;
+    std::optional<FieldOfView> fieldOfView;
+    std::optional<vec3> projectionPlaneOffset;
+};
+
+/**
+ * A range of vertices that forms a regular grid with the vertices stored row by row,
+ * starting at index \p first. Meshes that consist of such grids can be decimated.
+ */
+struct Grid {
+    unsigned int first = 0;
+    unsigned int nCols = 0;
+    unsigned int nRows = 0;
+};
+
+/// Separates the strips of a mesh with the geometry type GL_TRIANGLE_STRIP
+constexpr const unsigned int PrimitiveRestartIndex =
+    std::numeric_limits<unsigned int>::max();
+
 struct Buffer {
     std::vector<CorrectionMeshVertex> vertices;
     std::vector<unsigned int> indices;
     unsigned int geometryType = 0x0004; // = GL_TRIANGLES
+    std::optional<ViewSetup> viewSetup;
+    /// The grids that the vertices form, or empty if the mesh is not made of grids
+    std::vector<Grid> grids;
 };
 
 } // namespace sgct::correction
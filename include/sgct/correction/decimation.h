@@ -0,0 +1,35 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_DECIMATION__H__
+#define __SGCT__CORRECTION_DECIMATION__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+
+namespace sgct::correction {
+
+/**
+ * Replaces the regular grids of the \p buffer with a coarser triangulation where the warp
+ * is locally linear. Every grid is split into a quadtree of blocks that are rendered as
+ * a triangle fan around their center, which also contains the corners of neighboring
+ * smaller blocks so that no cracks appear. A block is subdivided as long as the texture
+ * coordinates that the coarse triangles produce at any of the original vertex positions
+ * differ by more than \p maxError pixels of a texture with the size \p resolution, or
+ * the color differs by more than half of an 8-bit step.
+ *
+ * The decimated mesh consists of triangles and only contains the vertices of the grids.
+ * Buffers whose indices refer to vertices outside of the grids are not modified.
+ *
+ * \return The number of vertices that were removed
+ */
+size_t decimateMesh(Buffer& buffer, float maxError, ivec2 resolution);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_DECIMATION__H__
@@ -0,0 +1,61 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_MESHCACHE__H__
+#define __SGCT__CORRECTION_MESHCACHE__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * On-disk cache for correction meshes that stores the generated Buffer in a binary format
+ * so that the text formats do not have to be parsed again on the next start. An entry is
+ * identified by the path of the mesh file together with the viewport parameters that the
+ * generated vertices depend on. It is valid as long as the size and modification time of
+ * the mesh file are unchanged or, if they differ, the contents of the file still have the
+ * same hash. Entries are read through a memory mapping and written to a temporary file
+ * first, so that several nodes can share a cache directory.
+ */
+namespace sgct::correction {
+
+/// The parameters besides the contents of the mesh file that a mesh depends on
+struct MeshCacheKey {
+    std::string path;
+    vec2 position = vec2{ 0.f, 0.f };
+    vec2 size = vec2{ 1.f, 1.f };
+    float aspectRatio = 1.f;
+    /// The decimation error and the resolution it refers to, see decimateMesh
+    float maxError = 0.f;
+    ivec2 resolution = ivec2{ 0, 0 };
+    /// Whether the mesh is optimized into triangle strips, see optimizeMesh
+    bool useStrips = false;
+};
+
+/// Returns the 64-bit FNV-1a hash of \p size bytes of \p data
+uint64_t hashMeshData(const unsigned char* data, size_t size);
+
+/**
+ * Returns the mesh that was cached for the \p key in the \p directory or nothing if there
+ * is no entry or if the entry is outdated or invalid.
+ */
+std::optional<Buffer> readMeshCache(const std::string& directory,
+    const MeshCacheKey& key);
+
+/**
+ * Stores the \p buffer that was generated for the \p key in the \p directory, which is
+ * created if it does not exist. Failing to write the entry only logs a warning.
+ */
+void writeMeshCache(const std::string& directory, const MeshCacheKey& key,
+    const Buffer& buffer);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_MESHCACHE__H__
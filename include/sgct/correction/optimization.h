@@ -0,0 +1,39 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_OPTIMIZATION__H__
+#define __SGCT__CORRECTION_OPTIMIZATION__H__
+
+#include <sgct/correction/buffer.h>
+
+namespace sgct::correction {
+
+/**
+ * Reorders the triangles of the \p buffer so that the post-transform vertex cache of the
+ * GPU is reused as often as possible, using the linear-speed algorithm by Tom Forsyth.
+ * The vertices are then stored in the order in which they are first used and vertices
+ * that no triangle references are removed. Triangle strips are converted into lists
+ * before they are optimized.
+ *
+ * If \p useStrips is true, the triangles are afterwards joined into triangle strips that
+ * are separated by the PrimitiveRestartIndex, as long as this needs fewer indices than
+ * the triangle list. The winding of all triangles is preserved. Meshes that are neither
+ * triangle lists nor strips are not modified.
+ */
+void optimizeMesh(Buffer& buffer, bool useStrips);
+
+/**
+ * Returns the average number of vertices per triangle that miss a first-in-first-out
+ * vertex cache with \p cacheSize entries when the \p buffer is rendered. The value is
+ * between 0.5 for a perfectly ordered large grid and 3.
+ */
+float averageCacheMissRatio(const Buffer& buffer, int cacheSize = 16);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_OPTIMIZATION__H__
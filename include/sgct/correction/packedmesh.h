@@ -0,0 +1,70 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_PACKEDMESH__H__
+#define __SGCT__CORRECTION_PACKEDMESH__H__
+
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <optional>
+#include <vector>
+
+namespace sgct::correction {
+
+/**
+ * The vertex and index data of a correction mesh in the most compact layout that
+ * represents it without a visible difference. Positions within [-1, 1] and texture
+ * coordinates within [0, 1] are stored as normalized 16-bit integers, which is precise to
+ * a sixteenth of a pixel on a 4K display. A color that is the same for all vertices is
+ * not stored per vertex, colors within [0, 1] are stored with 8 bits per channel. Meshes
+ * with at most 65536 vertices use 16-bit indices, in which the PrimitiveRestartIndex is
+ * replaced by the largest 16-bit value.
+ */
+struct PackedMesh {
+    enum class PositionFormat {
+        /// 2 floats for the position followed by 2 floats for the texture coordinates
+        Float,
+        /// 2 signed normalized shorts for the position and 2 unsigned normalized shorts
+        /// for the texture coordinates
+        Normalized16
+    };
+
+    enum class ColorFormat {
+        /// The color is not stored per vertex, but given by the constantColor
+        Constant,
+        /// 4 unsigned normalized bytes following the texture coordinates
+        Normalized8,
+        /// 4 floats following the texture coordinates
+        Float
+    };
+
+    std::vector<unsigned char> vertices;
+    std::vector<unsigned char> indices;
+
+    PositionFormat positionFormat = PositionFormat::Float;
+    ColorFormat colorFormat = ColorFormat::Float;
+    vec4 constantColor = vec4{ 1.f, 1.f, 1.f, 1.f };
+    bool has16BitIndices = false;
+    /// Whether the indices contain restart indices, which are the largest value of the
+    /// index type
+    bool hasPrimitiveRestart = false;
+
+    /// The number of bytes of each vertex
+    int vertexSize = 0;
+    /// The byte offset of the texture coordinates in each vertex
+    int texCoordOffset = 0;
+    /// The byte offset of the color in each vertex, if it is stored per vertex
+    int colorOffset = 0;
+};
+
+/// Converts the vertices and indices of the \p buffer into their most compact layout
+PackedMesh packMesh(const Buffer& buffer);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_PACKEDMESH__H__
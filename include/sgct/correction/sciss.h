@@ -16,7 +16,7 @@ namespace sgct { class BaseViewport; }
 
 namespace sgct::correction {
 
-Buffer generateScissMesh(const std::string& path, BaseViewport& parent);
+Buffer generateScissMesh(const std::string& path, const BaseViewport& parent);
 
 } // namespace sgct::correction
 
@@ -16,7 +16,7 @@ namespace sgct { class BaseViewport; }
 
 namespace sgct::correction {
 
-Buffer generateSkySkanMesh(const std::string& meshPath, BaseViewport& parent);
+Buffer generateSkySkanMesh(const std::string& meshPath, const BaseViewport& parent);
 
 } // namespace sgct::correction
 
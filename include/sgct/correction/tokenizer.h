@@ -0,0 +1,75 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_TOKENIZER__H__
+#define __SGCT__CORRECTION_TOKENIZER__H__
+
+#include <cstddef>
+#include <string_view>
+
+namespace sgct::correction {
+
+/**
+ * Splits the contents of a text mesh file into lines and tokens without copying or
+ * allocating. The tokens are views into the data, which usually is a MappedFile, and are
+ * converted into numbers with std::from_chars, which is independent of the locale.
+ */
+class Tokenizer {
+public:
+    /// The \p data has to stay valid as long as the tokenizer and its tokens are used
+    Tokenizer(const char* data, size_t size);
+
+    /**
+     * Advances to the next line, which can end in either \\n or \\r\\n.
+     *
+     * \return false if the end of the data has been reached
+     */
+    bool nextLine();
+
+    /**
+     * Returns the next token of the current line. Tokens are separated by spaces, tabs,
+     * and the additional \p separators. An empty view is returned at the end of the line.
+     */
+    std::string_view nextToken(std::string_view separators = std::string_view());
+
+    /// Parses the next token of the current line, returns false if it is not a number
+    bool nextNumber(float& value, std::string_view separators = std::string_view());
+    bool nextNumber(int& value, std::string_view separators = std::string_view());
+    bool nextNumber(unsigned int& value,
+        std::string_view separators = std::string_view());
+
+    /// Returns the rest of the current line without leading and trailing whitespace
+    std::string_view rest() const;
+
+    /// Returns the 1-based number of the current line
+    int lineNumber() const;
+
+    /// Returns the number of lines in the data, which is used to estimate capacities
+    size_t countLines() const;
+
+private:
+    const char* const _begin;
+    const char* const _end;
+    const char* _pos;
+    std::string_view _line;
+    int _lineNumber = 0;
+};
+
+/**
+ * Converts the entire \p token into a number. Unlike std::stof and sscanf, this does not
+ * depend on the locale or require a null-terminated string.
+ *
+ * \return false if the token is empty, contains other characters, or is out of range
+ */
+bool parseNumber(std::string_view token, float& value);
+bool parseNumber(std::string_view token, int& value);
+bool parseNumber(std::string_view token, unsigned int& value);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_TOKENIZER__H__
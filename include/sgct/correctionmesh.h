@@ -9,6 +9,9 @@
 #ifndef __SGCT__CORRECTION_MESH__H__
 #define __SGCT__CORRECTION_MESH__H__
 
+#include <sgct/correction/buffer.h>
+#include <exception>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -16,8 +19,6 @@ namespace sgct {
 
 class BaseViewport;
 
-namespace correction { struct Buffer; }
-
 /**
  * Helper class for reading and rendering a correction mesh. A correction mesh is used for
  * warping and edge-blending.
@@ -25,7 +26,19 @@ namespace correction { struct Buffer; }
 class CorrectionMesh {
 public:
     /**
-     * This function finds a suitable parser for warping meshes and loads them.
+     * Parses the warping mesh without uploading it. This does not require an OpenGL
+     * context and does not modify the viewport, so the meshes of several viewports can be
+     * parsed in parallel. The next call to loadMesh uses the parsed mesh and throws the
+     * error that occurred while parsing, if any.
+     *
+     * \param path the path to the mesh data
+     * \param parent the viewport that the mesh belongs to
+     */
+    void parseMesh(const std::string& path, const BaseViewport& parent);
+
+    /**
+     * This function finds a suitable parser for warping meshes and loads them. If the
+     * mesh has been parsed with parseMesh before, it is only uploaded.
      *
      * \param path the path to the mesh data
      * \param parent the pointer to parent viewport
@@ -55,13 +68,22 @@ private:
         unsigned int nVertices = 0;
         unsigned int nIndices = 0;
         unsigned int type = 0x0005; // = GL_TRIANGLE_STRIP;
+        unsigned int indexType = 0x1405; // = GL_UNSIGNED_INT
+        /// The largest value of the index type separates strips if this is set
+        bool hasPrimitiveRestart = false;
+        /// The color of all vertices if it is not stored per vertex
+        std::optional<vec4> color;
     };
 
     void createMesh(CorrectionMeshGeometry& geom, const correction::Buffer& buffer);
+    static void render(const CorrectionMeshGeometry& geom);
 
     CorrectionMeshGeometry _quadGeometry;
     CorrectionMeshGeometry _warpGeometry;
     CorrectionMeshGeometry _maskGeometry;
+
+    std::optional<correction::Buffer> _parsedMesh;
+    std::exception_ptr _parseError;
 };
 
 } // namespace sgct
@@ -230,7 +230,10 @@ public:
      */
     const std::function<void(const RenderData&)>& drawFunction() const;
 
-    /// Get the time from program start in seconds
+    /**
+     * Get the time from program start in seconds. While a shared data recording is
+     * replayed, the recorded time of the current frame is returned instead.
+     */
     static double getTime();
 
     /// \return a reference to this node (running on this computer).
@@ -304,6 +307,23 @@ private:
 
     void renderViewports(Window& window, Frustum::Mode frustum, Window::TextureIndex ti);
 
+    /**
+     * If frame pacing is enabled, this function delays the start of the next frame such
+     * that input polling and synchronization happen as late as the predicted cost of the
+     * frame allows before the next vertical sync.
+     */
+    void waitForFramePacing();
+
+    /// Records the timings of the frame that was just swapped for the frame pacing
+    void updateFramePacing(double beforeSwap, double afterSwap);
+
+    /**
+     * Records the cost of the last frame for the dynamic resolution scaling. The clients
+     * report their cost to the master, which decides the resolution scale for the whole
+     * cluster.
+     */
+    void updateDynamicResolution(double frameCost);
+
     /// This function renders stats, OSD and overlays
     void render2D(const Window& window, Frustum::Mode frustum);
 
@@ -360,6 +380,23 @@ private:
 
     std::unique_ptr<std::thread> _thread;
 
+    struct FramePacing {
+        // Time between the start of the frame and the buffer swap, newest first
+        std::array<double, 16> workTimes = {};
+        double refreshPeriod = 0.0;
+        double frameStart = 0.0;
+        double lastSwap = 0.0;
+    };
+    std::optional<FramePacing> _framePacing;
+
+    struct DynamicResolution {
+        double targetFrameTime = 0.0;
+        double accumulatedCost = 0.0;
+        int nFrames = 0;
+        float scale = 1.f;
+    };
+    std::optional<DynamicResolution> _dynamicResolution;
+
     unsigned int _frameCounter = 0;
     unsigned int _shotCounter = 0;
 };
@@ -87,6 +87,7 @@ namespace sgct {
  * 2031: OBJ / Vertex count doesn't match number of texture coordinates in '%s'
  * 2032: OBJ / Faces in mesh '%s' referenced vertices that were undefined
  * 2033: OBJ / Faces in mesh '%s' are using relative index positions that are unsupported
+ * 2034: OBJ / Error parsing line %i in mesh '%s'
  * 2040: PaulBourke / Failed to open file '%s'
  * 2041: PaulBourke / Error reading mapping type in file '%s'
  * 2042: PaulBourke / Invalid data in file '%s'
@@ -97,6 +98,7 @@ namespace sgct {
  * 2054: Pfm / Error reading correction values in file '%s'
  * 2060: Scalable / Failed to open file '%s'
  * 2061: Scalable / Incorrect mesh data geometry in file '%s'
+ * 2062: Scalable / Error parsing line %i in mesh '%s'
  * 2070: SCISS / Failed to open '%s'
  * 2071: SCISS / Incorrect file id in file '%s'
  * 2072: SCISS / Error parsing file version from file '%s'
@@ -179,6 +181,10 @@ namespace sgct {
  * 5026: NetworkManager / Empty address for connection to %i
  * 5027: NetworkManager / Failed to get host name
  * 5028: NetworkManager / Failed to get address info: %s
+ * 5030: Network / Could not open recording file '%s'
+ * 5031: Network / Could not open recording file '%s' for replay
+ * 5032: Network / File '%s' is not a valid recording
+ * 5033: Network / Recording truncated in frame %i
 
  * 6000s: XML configuration parsing
  * 6000: PlanarProjection / Missing specification of field-of-view values
@@ -196,7 +202,7 @@ namespace sgct {
  * 6041: Node / Missing field port in node
  * 6050: Settings / Wrong buffer precision value. Must be 16 or 32
  * 6051: Settings / Wrong buffer precision value type
- * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg
+ * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg, qoi
  * 6070: Tracker / Tracker is missing 'name'
  * 6080: Parsing / No file provided
  * 6081: Parsing / Could not find configureation file: %s
@@ -235,6 +241,19 @@ namespace sgct {
  * 9010: Image / Failed to create PNG info struct
  * 9011: Image / One of the called PNG functions failed
  * 9012: Image / Invalid image size %i x %i %i channels
+ * 9013: Image / Failed to compress PNG data
+ * 9014: Image / Failed to write PNG file '%s'
+ * 9015: RawCapture / Could not open raw capture file '%s'
+ * 9016: RawCapture / Could not map %i bytes of raw capture file '%s'
+ * 9017: RawCapture / File '%s' is not a raw capture file
+ * 9018: VideoPipe / Could not start encoder '%s'
+ * 9019: Image / Could not decode QOI image '%s'
+ * 9020: Image / Could not save file '%s' as QOI
+ * 9021: Image / QOI only supports 8 bit images with 3 or 4 channels, not %i bit with %i
+ * 9022: Image / Could not decode image '%s'
+ * 9023: Image / Could not load compressed texture '%s': %s
+ * 9024: RawCapture / Dropped frame %i as raw capture file '%s' could not be grown
+ * 9025: Image / The rows of the compressed texture cannot be stored from top to bottom
 
  OBS:  When adding a new error code, don't forget to update docs/errors.md accordingly
  */
@@ -10,21 +10,44 @@
 #define __SGCT__IMAGE__H__
 
 #include <sgct/math.h>
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace sgct {
 
 class Image {
 public:
-    enum class FormatType { PNG = 0, JPEG, TGA, Unknown };
+    enum class FormatType { PNG = 0, JPEG, TGA, QOI, Unknown };
 
     Image() = default;
     ~Image();
 
+    // The pixel data is owned by the image, so it can only be moved but not copied
+    Image(const Image&) = delete;
+    Image(Image&& rhs) noexcept;
+    Image& operator=(const Image&) = delete;
+    Image& operator=(Image&& rhs) noexcept;
+
     void allocateOrResizeData();
     void load(const std::string& filename);
     void load(unsigned char* data, int length);
 
+    /**
+     * Loads all images in \p filenames in parallel on the JobSystem and calls the
+     * \p callback on the calling thread for every image in the same order as the
+     * \p filenames. The callback receives the index of the image and is called as soon
+     * as the image and all images before it have been loaded, so the previous images can
+     * be uploaded while the rest are still being decoded. The callback can move the image
+     * out; otherwise its memory is released as soon as the callback returns.
+     *
+     * If an image cannot be loaded, the error is thrown when the image's turn comes and
+     * no further callbacks are made.
+     */
+    static void loadMultiple(const std::vector<std::string>& filenames,
+        const std::function<void(size_t index, Image& image)>& callback);
+
     /// Save the buffer to file. Type is automatically set by filename suffix.
     void save(const std::string& filename);
 
@@ -47,6 +70,18 @@ private:
      *    9 = Best compression
      */
     void savePNG(std::string filename, int compressionLevel = -1);
+    void saveQOI(const std::string& filename);
+    void loadQOI(const unsigned char* data, size_t size, const std::string& name);
+
+    /// Decodes an image file in any of the supported formats from memory
+    void decode(const unsigned char* data, size_t size, const std::string& name);
+
+    /**
+     * Decodes an 8 bit PNG image with libPNG.
+     *
+     * \return false if the image has to be decoded by stb_image instead
+     */
+    bool loadPNG(const unsigned char* data, size_t size);
 
     int _nChannels = 0;
     ivec2 _size = ivec2{ 0, 0 };
@@ -0,0 +1,97 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__IMAGEBUFFERPOOL__H__
+#define __SGCT__IMAGEBUFFERPOOL__H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * A thread-safe pool of memory buffers for pixel data. Buffers that are released are
+ * kept in buckets of similar size and handed out again for the next request that fits
+ * into the bucket, so that loading, capturing, and streaming images of the same size
+ * repeatedly does not allocate new memory every time. The bucket sizes grow in steps of
+ * one eighth of a power of two, which limits the wasted space to 12.5%.
+ *
+ * Small buffers are not kept in the pool. Large buffers are allocated directly from the
+ * operating system and can optionally be backed by huge pages on Linux. It is a singleton
+ * and can be accessed anywhere, including worker threads, using its static instance. The
+ * size of the pool and the use of huge pages are taken from the Settings when the
+ * instance is created. The instance must only be destroyed after all buffers have been
+ * released.
+ */
+class ImageBufferPool {
+public:
+    struct Statistics {
+        /// The number of buffers that have been requested
+        uint64_t nAcquired = 0;
+        /// The number of requests that were served by a buffer from the pool
+        uint64_t nReused = 0;
+        /// The number of bytes in buffers that are currently handed out
+        size_t bytesInUse = 0;
+        /// The largest number of bytes that were handed out at the same time
+        size_t maxBytesInUse = 0;
+        /// The number of bytes in buffers that are kept in the pool for reuse
+        size_t bytesCached = 0;
+    };
+
+    static ImageBufferPool& instance();
+    static void destroy();
+
+    /**
+     * Returns a buffer of at least \p size bytes that is aligned to 64 bytes. The buffer
+     * has to be returned with #release.
+     */
+    unsigned char* acquire(size_t size);
+
+    /**
+     * Returns a buffer that was created by #acquire to the pool. Passing a nullptr is
+     * allowed and does nothing.
+     */
+    void release(unsigned char* buffer);
+
+    /**
+     * Changes the size of the buffer to \p size bytes, preserving its content up to the
+     * smaller of the old and the new size. If the buffer is large enough already, it is
+     * returned unchanged.
+     */
+    unsigned char* resize(unsigned char* buffer, size_t size);
+
+    /// Frees all buffers that are currently kept in the pool
+    void trim();
+
+    Statistics statistics() const;
+
+private:
+    ImageBufferPool(size_t maxCachedSize, bool useHugePages);
+    ~ImageBufferPool();
+
+    unsigned char* allocate(size_t bucketSize);
+    void free(unsigned char* block, size_t bucketSize);
+
+    static std::atomic<ImageBufferPool*> _instance;
+    static std::mutex _instanceMutex;
+
+    const size_t _maxCachedSize;
+    const bool _useHugePages;
+
+    mutable std::mutex _mutex;
+    std::map<size_t, std::vector<unsigned char*>> _buckets;
+    Statistics _stats;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__IMAGEBUFFERPOOL__H__
@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__JOBSYSTEM__H__
+#define __SGCT__JOBSYSTEM__H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * The JobSystem is a pool of worker threads that is shared between SGCT and the
+ * application, so that CPU work can be spread over the available cores without every
+ * component creating its own threads. Every worker owns a queue of jobs; idle workers
+ * steal jobs from the queues of the other workers. It is a singleton and can be accessed
+ * anywhere using its static instance. The number of workers is taken from
+ * Settings::numberJobThreads when the instance is created.
+ *
+ * Exceptions that are thrown by a job are logged and do not propagate to the caller.
+ * All jobs have to be finished before the Engine is destroyed, jobs that are still queued
+ * at that point are discarded.
+ */
+class JobSystem {
+public:
+    /// Handle that is used to wait for the completion of one or more jobs
+    using Handle = std::shared_ptr<std::atomic<int>>;
+
+    static JobSystem& instance();
+    static void destroy();
+
+    /**
+     * Queues the \p job for execution on one of the worker threads.
+     *
+     * \return The handle that can be passed to #wait to wait for the job to finish
+     */
+    Handle submit(std::function<void()> job);
+
+    /**
+     * Queues the \p job for execution on one of the worker threads and adds it to the
+     * already existing \p handle. Waiting on the handle waits for all jobs that have been
+     * added to it.
+     */
+    void submit(std::function<void()> job, const Handle& handle);
+
+    /**
+     * Waits until all jobs of the \p handle have finished. The calling thread executes
+     * queued jobs while waiting, so it is safe to call this function from inside a job.
+     */
+    void wait(const Handle& handle);
+
+    /**
+     * Calls \p function for all indices in [begin, end) and returns once all calls have
+     * finished. The range is split into chunks of at least \p grainSize indices that are
+     * executed in parallel, one of which is executed on the calling thread.
+     */
+    void parallelFor(size_t begin, size_t end,
+        const std::function<void(size_t)>& function, size_t grainSize = 1);
+
+    /// \return The number of worker threads
+    int numberOfThreads() const;
+
+private:
+    struct Job {
+        std::function<void()> function;
+        Handle handle;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    JobSystem(int nThreads);
+    ~JobSystem();
+
+    void workerLoop(int index);
+    bool runJob(int index);
+
+    static JobSystem* _instance;
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<bool> _isRunning = true;
+    std::atomic<int> _nPending = 0;
+    std::atomic<unsigned int> _nextQueue = 0;
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__JOBSYSTEM__H__
@@ -0,0 +1,45 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__MAPPEDFILE__H__
+#define __SGCT__MAPPEDFILE__H__
+
+#include <cstddef>
+#include <string>
+
+namespace sgct {
+
+/**
+ * Read-only view of the contents of a file that is mapped into memory. Reading from the
+ * mapping avoids copying the file into a separate buffer first, as the pages are taken
+ * from the operating system's file cache directly. The data is nullptr if the file could
+ * not be opened or is empty.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const;
+    size_t size() const;
+
+private:
+    const unsigned char* _data = nullptr;
+    size_t _size = 0;
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif // WIN32
+};
+
+} // namespace sgct
+
+#endif // __SGCT__MAPPEDFILE__H__
@@ -76,6 +76,15 @@ public:
     /// Get the time in seconds from send to receive of sync data.
     double loopTime() const;
 
+    /**
+     * The last four bytes of the header of a sync message carry additional information
+     * about the frame. The master sends the cluster-wide resolution scale to the clients
+     * and the clients report the cost of their previous frame with the acknowledgement.
+     *
+     * \return the frame information that was received with the last sync message
+     */
+    float frameInfo() const;
+
     /**
      * This function compares the received frame number with the sent frame number. The
      * server starts by sending a frame sync number to the client. The client receives the
@@ -94,8 +103,12 @@ public:
     /// Iterates the send frame number and returns the new frame number
     int iterateFrameCounter();
 
-    /// The client sends ack message to server + console messages
-    void pushClientMessage();
+    /**
+     * The client sends ack message to server + console messages
+     *
+     * \param frameInfo The additional information that is sent to the server
+     */
+    void pushClientMessage(float frameInfo = 0.f);
 
     /// \return the port of this connection
     int port() const;
@@ -105,8 +118,7 @@ public:
 private:
     void setRecvFrame(int i);
     void updateBuffer(std::vector<char>& buffer, uint32_t reqSize, uint32_t& currSize);
-    int readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
-        uint32_t& uncompressedDataSize);
+    int readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize);
     int readDataTransferMessage(char* header, int32_t& packageId, uint32_t& dataSize,
         uint32_t& uncompressedDataSize);
     int readExternalMessage();
@@ -126,6 +138,7 @@ private:
     std::atomic<int32_t> _previousSendFrame = 0;
     std::atomic<int32_t> _currentRecvFrame = 0;
     std::atomic<int32_t> _previousRecvFrame = -1;
+    std::atomic<float> _frameInfo = 0.f;
     std::atomic_bool _shouldTerminate = false; // set to true upon exit
 
     mutable std::mutex _connectionMutex;
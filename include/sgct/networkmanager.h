@@ -60,6 +60,25 @@ public:
 
     bool matchesAddress(std::string_view address) const;
 
+    /**
+     * Sets the resolution scale that the master sends to all clients with the next
+     * synchronization. A value of 0 means that no resolution scale is distributed.
+     */
+    void setResolutionScale(float scale);
+
+    /**
+     * \return the resolution scale that was received from the master with the last
+     *         synchronization or 0 if the master did not distribute a resolution scale
+     */
+    float resolutionScale() const;
+
+    /// Sets the cost of the last frame that the client reports with the next
+    /// acknowledgement to the master
+    void setFrameCost(float cost);
+
+    /// \return the highest frame cost that was reported by any of the connected clients
+    float maxClientFrameCost() const;
+
     /// Retrieve the node id if this node is part of the cluster configuration
     bool isComputerServer() const;
     bool isRunning() const;
@@ -108,6 +127,8 @@ private:
     bool _isServer = true;
     bool _isRunning = true;
     bool _allNodesConnected = false;
+    float _resolutionScale = 0.f;
+    float _frameCost = 0.f;
     const NetworkMode _mode;
     unsigned int _nActiveConnections = 0;
     unsigned int _nActiveSyncConnections = 0;
@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__PIXELCONVERSION__H__
+#define __SGCT__PIXELCONVERSION__H__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Conversion kernels for pixel data that are used when reading and writing images. The
+ * kernels use SSE2, SSSE3, AVX2, F16C, or NEON if the compiler targets these instruction
+ * sets and fall back to scalar code otherwise.
+ */
+namespace sgct {
+
+/**
+ * Swaps the first and the third channel of every pixel in place, which converts between
+ * BGR(A) and RGB(A). Images with fewer than 3 channels are not modified.
+ *
+ * \param data The pixel data with 8 bits per channel
+ * \param nPixels The number of pixels in \p data
+ * \param channels The number of channels of each pixel
+ */
+void swapRedBlue(unsigned char* data, size_t nPixels, int channels);
+
+/// Swaps the byte order of \p n 16-bit values in place
+void byteSwap16(uint16_t* data, size_t n);
+
+/**
+ * Copies the first two channels of 32-bit floating point pixels with three channels, as
+ * they are stored in PFM images, into two separate planes.
+ *
+ * \param r Receives the \p nPixels values of the first channel
+ * \param g Receives the \p nPixels values of the second channel
+ * \param src The pixel data, which does not have to be aligned
+ * \param nPixels The number of pixels in \p src
+ * \param swapBytes Whether the byte order of the values has to be swapped
+ */
+void deinterleaveRG32F(float* r, float* g, const unsigned char* src, size_t nPixels,
+                       bool swapBytes);
+
+/**
+ * Converts \p n half-precision floating point values into 8-bit unsigned normalized
+ * values. Values outside of [0, 1] are clamped.
+ */
+void halfToUnorm8(unsigned char* dst, const uint16_t* src, size_t n);
+
+/**
+ * Converts an image with 8-bit BGR(A) pixels whose rows are stored bottom to top into
+ * the three planes of a YUV 4:2:0 image whose rows are stored top to bottom. The BT.601
+ * limited range coefficients are used and each chroma sample is the average of a block
+ * of 2x2 pixels. The chroma planes are (width + 1) / 2 by (height + 1) / 2 pixels.
+ *
+ * \param src The pixel data with 3 or 4 channels
+ * \param width The width of the image in pixels
+ * \param height The height of the image in pixels
+ * \param channels The number of channels of each pixel, either 3 or 4
+ * \param y Receives the luma plane of width * height bytes
+ * \param u Receives the blue-difference chroma plane
+ * \param v Receives the red-difference chroma plane
+ */
+void bgrToYuv420(const unsigned char* src, int width, int height, int channels,
+                 unsigned char* y, unsigned char* u, unsigned char* v);
+
+} // namespace sgct
+
+#endif // __SGCT__PIXELCONVERSION__H__
@@ -11,6 +11,7 @@
 
 #include <sgct/frustum.h>
 #include <sgct/math.h>
+#include <optional>
 
 namespace sgct {
 
@@ -19,6 +20,11 @@ class ProjectionPlane;
 /// This class holds and manages 3D projections
 class Projection {
 public:
+    /**
+     * Calculates the view and projection matrices for the eye position \p base looking
+     * at the projection plane \p proj. The matrices are only recalculated if any of the
+     * parameters changed since the last call.
+     */
     void calculateProjection(vec3 base, const ProjectionPlane& proj, float nearClip,
         float farClip, vec3 viewOffset = vec3{ 0.f, 0.f, 0.f });
 
@@ -32,6 +38,18 @@ private:
     mat4 _projectionMatrix = mat4(1.f);
 
     Frustum _frustum;
+
+    // The parameters of the last calculation, used to skip redundant recalculations
+    struct Parameters {
+        vec3 base;
+        vec3 offset;
+        vec3 lowerLeft;
+        vec3 upperLeft;
+        vec3 upperRight;
+        float nearClip;
+        float farClip;
+    };
+    std::optional<Parameters> _parameters;
 };
 
 } // namespace sgct
@@ -49,6 +49,15 @@ public:
      */
     void setCubemapResolution(int resolution);
 
+    /**
+     * Scales the resolution of the cubemap faces relative to the resolution that was
+     * used when the projection was initialized. All render targets are recreated if the
+     * resulting resolution differs from the current resolution.
+     *
+     * \param scale the scale of the cubemap resolution in the range (0, 1]
+     */
+    virtual void setResolutionScale(float scale);
+
     /**
      * Set the interpolation mode.
      *
@@ -129,6 +138,7 @@ protected:
     Frustum::Mode _preferedMonoFrustumMode = Frustum::Mode::MonoEye;
 
     ivec2 _cubemapResolution = { 512, 512 };
+    ivec2 _unscaledCubemapResolution = { 512, 512 };
     vec4 _clearColor = vec4{ 0.3f, 0.3f, 0.3f, 1.f };
     ivec4 _vpCoords = ivec4{ 0, 0, 0, 0 };
     bool _useDepthTransformation = false;
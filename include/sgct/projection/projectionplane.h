@@ -10,12 +10,24 @@
 #define __SGCT__PROJECTIONPLANE__H__
 
 #include <sgct/math.h>
+#include <optional>
 
 namespace sgct {
 
 /// This class holds and manages the 3D projection plane
 class ProjectionPlane {
 public:
+    /**
+     * The coordinate system of the projection plane. The matrix transforms world
+     * coordinates into the plane's coordinate system in which the plane is parallel to
+     * the xy-plane. The basis is cached and only recalculated when the plane changes.
+     */
+    struct Basis {
+        mat4 worldToPlane;
+        vec3 lowerLeft;
+        vec3 upperRight;
+    };
+
     void setCoordinates(vec3 lowerLeft, vec3 upperLeft, vec3 upperRight);
     void offset(const vec3& p);
 
@@ -28,10 +40,15 @@ public:
     /// \return coordinates for the upper right projection plane corner
     const vec3& coordinateUpperRight() const;
 
+    /// \return the coordinate system of the plane
+    const Basis& basis() const;
+
 private:
     vec3 _lowerLeft = vec3{ -1.f, -1.f, -2.f };
     vec3 _upperLeft = vec3{ -1.f, 1.f, -2.f };
     vec3 _upperRight = vec3{ 1.f, 1.f, -2.f };
+
+    mutable std::optional<Basis> _basis;
 };
 
 } // namespace sgct
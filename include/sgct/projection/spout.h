@@ -37,6 +37,9 @@ public:
     /// Update projection when aspect ratio changes for the viewport.
     void update(vec2 size) override;
 
+    /// The resolution is shared with the receiving applications and is never scaled
+    void setResolutionScale(float scale) override;
+
     /// Render the non linear projection to currently bounded FBO
     void render(const Window& window, const BaseViewport& viewport,
         Frustum::Mode frustumMode) override;
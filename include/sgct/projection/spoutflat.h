@@ -30,6 +30,9 @@ public:
     virtual void renderCubemap(Window& window, Frustum::Mode frustumMode) override;
     virtual void update(vec2 size) override;
 
+    /// The resolution is shared with the receiving applications and is never scaled
+    virtual void setResolutionScale(float scale) override;
+
     void setSpoutMappingName(std::string name); 
     void setResolutionWidth(int resolutionX);
     void setResolutionHeight(int resolutionY);
@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__QOI__H__
+#define __SGCT__QOI__H__
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/**
+ * Encoder and decoder for the lossless "Quite OK Image" format (https://qoiformat.org).
+ * The format compresses to roughly the size of a PNG file but is an order of magnitude
+ * faster to encode, which makes it suitable for capturing every frame. It only supports
+ * 8-bit images with 3 or 4 channels.
+ *
+ * The functions work on pixel data in the layout of the Image class: BGR(A) channel order
+ * with the rows stored bottom to top. The QOI files themselves are stored as RGB(A) from
+ * top to bottom, so they can be read by other applications.
+ */
+namespace sgct {
+
+struct QOIInfo {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+};
+
+/**
+ * Encodes the \p pixels into a QOI file.
+ *
+ * \param pixels The pixel data with 8 bits per channel
+ * \param width The width of the image in pixels
+ * \param height The height of the image in pixels
+ * \param channels The number of channels of each pixel, either 3 or 4
+ * \return The contents of the QOI file
+ */
+std::vector<unsigned char> encodeQOI(const unsigned char* pixels, int width, int height,
+    int channels);
+
+/**
+ * Reads the header of a QOI file.
+ *
+ * \return The size and number of channels of the image or std::nullopt if \p data does
+ *         not start with a valid QOI header
+ */
+std::optional<QOIInfo> readQOIHeader(const unsigned char* data, size_t size);
+
+/**
+ * Decodes a QOI file into \p pixels, which has to be large enough to hold the image that
+ * is described by the header of the file.
+ *
+ * \return false if the file is not a valid QOI file or ends prematurely
+ */
+bool decodeQOI(const unsigned char* data, size_t size, unsigned char* pixels);
+
+} // namespace sgct
+
+#endif // __SGCT__QOI__H__
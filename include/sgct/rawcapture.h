@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__RAWCAPTURE__H__
+#define __SGCT__RAWCAPTURE__H__
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Header that precedes the pixel data of every frame in a raw capture file. The pixel
+ * data is stored as it is downloaded from the GPU: the channels are in BGR(A) order, the
+ * rows are stored bottom to top, and 16 bit channels are little-endian.
+ */
+struct RawFrameHeader {
+    static constexpr const uint32_t Magic = 0x52464753; // 'SGFR'
+
+    uint32_t magic = Magic;
+    uint32_t windowId = 0;
+    uint64_t frameNumber = 0;
+    uint32_t eye = 0; // 0 = mono, 1 = left eye, 2 = right eye
+    int32_t width = 0;
+    int32_t height = 0;
+    uint32_t channels = 0;
+    uint32_t bytesPerChannel = 0;
+    uint32_t reserved = 0;
+    uint64_t dataSize = 0;
+};
+
+/**
+ * Writes frames into a single large container file that is mapped into memory. The file
+ * is preallocated in increments of \p growSize bytes, so appending a frame is a copy into
+ * the page cache without any per-frame file system overhead. Frames can be appended from
+ * multiple threads concurrently. When the writer is destroyed, the unused preallocated
+ * space is removed from the end of the file.
+ */
+class RawCaptureWriter {
+public:
+    static constexpr const uint64_t DefaultGrowSize = 1024ull * 1024ull * 1024ull;
+
+    explicit RawCaptureWriter(std::string path, uint64_t growSize = DefaultGrowSize);
+    ~RawCaptureWriter();
+
+    /**
+     * Appends a frame to the file. The \p data has to contain header.dataSize bytes.
+     * This function is thread-safe. If the file cannot be grown to hold the frame, an
+     * Error is thrown for this and all later frames that do not fit into the file.
+     */
+    void append(const RawFrameHeader& header, const unsigned char* data);
+
+private:
+    /// Replaces the mapping with one of \p size bytes; keeps the old one on failure
+    void map(uint64_t size);
+    void unmap();
+
+    const std::string _path;
+    const uint64_t _growSize;
+
+    std::mutex _offsetMutex;
+    uint64_t _writeOffset = 0;
+
+    // Appending frames only requires shared access; remapping the file needs exclusive
+    std::shared_mutex _mappingMutex;
+    uint64_t _fileSize = 0;
+    unsigned char* _mapping = nullptr;
+    bool _hasFailed = false;
+
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _fileMapping = nullptr;
+#else // WIN32
+    int _file = -1;
+#endif // WIN32
+};
+
+/// Reads the frames of a file that was written by the RawCaptureWriter in order
+class RawCaptureReader {
+public:
+    explicit RawCaptureReader(const std::string& path);
+
+    /**
+     * Reads the next frame into \p data.
+     *
+     * \return The header of the frame or std::nullopt if there are no more frames
+     */
+    std::optional<RawFrameHeader> nextFrame(std::vector<unsigned char>& data);
+
+private:
+    std::ifstream _file;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__RAWCAPTURE__H__
@@ -10,32 +10,45 @@
 #define __SGCT__SCREENCAPTURE__H__
 
 #include <sgct/math.h>
-#include <functional>
-#include <mutex>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
 namespace sgct {
 
 class Image;
+class RawCaptureWriter;
+class VideoPipe;
 
 /// This class is used internally by SGCT and is called when taking screenshots
 class ScreenCapture {
 public:
     /// The different file formats supported
-    enum class CaptureFormat { PNG, TGA, JPEG };
+    enum class CaptureFormat { PNG, TGA, JPEG, QOI, Raw };
     enum class CaptureSource { Texture, BackBuffer, LeftBackBuffer, RightBackBuffer };
     enum class EyeIndex { Mono, StereoLeft, StereoRight };
 
-    struct ScreenCaptureThreadInfo {
-        std::string filename;
-        std::unique_ptr<Image> frameBufferImage;
-        std::unique_ptr<std::thread> captureThread;
-        std::mutex* mutex = nullptr;
-        bool isRunning = false; // needed for test if running without join
+    /// Statistics of the capture threads that are shared by all windows
+    struct Statistics {
+        /// The number of screenshots currently waiting for a capture thread
+        int queueOccupancy = 0;
+        /// The largest number of screenshots that were waiting at the same time
+        int maxQueueOccupancy = 0;
+        /// The number of screenshots that have been written to disk
+        uint64_t nEncoded = 0;
+        /// The number of screenshots that were dropped because the queue was full
+        uint64_t nDropped = 0;
+        /// The average time in seconds it took to encode and write a screenshot
+        double averageEncodeTime = 0.0;
+        /// The longest time in seconds it took to encode and write a screenshot
+        double maxEncodeTime = 0.0;
     };
 
+    /// \return The statistics of the capture threads
+    static Statistics statistics();
+
     ScreenCapture();
     ~ScreenCapture();
 
@@ -68,22 +81,72 @@ public:
     void saveScreenCapture(unsigned int textureId,
         CaptureSource capSrc = CaptureSource::Texture);
 
+    /**
+     * Hands the screenshots whose download from the GPU has finished over to the capture
+     * threads and downloads the next strip of a tiled capture. This function does not
+     * wait for downloads that are still in progress and should be called once per frame.
+     */
+    void processPendingReadbacks();
+
 private:
-    std::string createFilename(uint64_t frameNumber);
-    int availableCaptureThread();
-    void checkImageBuffer(CaptureSource captureSource);
-    Image* prepareImage(int index, std::string file);
+    struct ImagePool;
+    struct WorkerPool;
 
-    std::mutex _mutex;
-    std::vector<ScreenCaptureThreadInfo> _captureInfos;
+    /// A download of a screenshot into a pixel buffer that might not have finished yet
+    struct Readback {
+        unsigned int pbo = 0;
+        void* fence = nullptr; // GLsync that is signaled once the transfer is completed
+        std::string filename;
+        uint64_t frameNumber = 0;
+    };
+
+    /// A screenshot that is downloaded in strips over multiple frames
+    struct TiledCapture {
+        unsigned int textureId = 0;
+        CaptureSource source = CaptureSource::Texture;
+        int nextTile = 0;
+    };
 
-    unsigned int _nThreads;
-    unsigned int _pbo = 0;
+    std::string createFilename(uint64_t frameNumber);
+    std::string createRawFilename();
+    std::string createEncoderCommand();
+    void checkImageBuffer(CaptureSource captureSource);
+    void readNextTile();
+    void finishReadback(Readback& readback);
+    void finishAllReadbacks();
+
+    // The capture threads are shared between all instances, the images are recycled
+    // once they have been written to disk
+    std::shared_ptr<WorkerPool> _workers;
+    std::shared_ptr<ImagePool> _images;
+    static std::weak_ptr<WorkerPool> _sharedWorkers;
+
+    // All windows append their frames to the same file when capturing raw frames
+    std::shared_ptr<RawCaptureWriter> _rawWriter;
+    static std::weak_ptr<RawCaptureWriter> _sharedRawWriter;
+
+    // Streams the frames to an external encoder if one is set in the Settings. The
+    // encoder is restarted whenever the capture is resized
+    std::unique_ptr<VideoPipe> _encoder;
+    // Set if the encoder could not be started, in which case this capture writes image
+    // files instead
+    bool _hasEncoderFailed = false;
+
+    std::vector<Readback> _readbacks;
+    size_t _nextReadback = 0;
+    std::optional<TiledCapture> _tiledCapture;
+    int _nTiles = 1;
+    int _tileHeight = 0;
+    // Used to read a region of a texture that is not captured in its entirety
+    unsigned int _readFramebuffer = 0;
     unsigned int _downloadFormat = 0x80E1; // GL_BGRA;
     unsigned int _downloadType = 0x1401; // GL_UNSIGNED_BYTE;
     unsigned int _downloadTypeSetByUser = _downloadType;
     int _dataSize = 0;
+    // The resolution of the captured region and its offset in the framebuffer
     ivec2 _resolution = ivec2{ 0, 0 };
+    ivec2 _offset = ivec2{ 0, 0 };
+    ivec2 _sourceResolution = ivec2{ 0, 0 };
     int _nChannels = 0;
     int _bytesPerColor = 1;
 
@@ -9,6 +9,7 @@
 #ifndef __SGCT__SETTINGS__H__
 #define __SGCT__SETTINGS__H__
 
+#include <sgct/math.h>
 #include <algorithm>
 #include <optional>
 #include <string>
@@ -24,7 +25,13 @@ namespace config {
 /// This singleton class will hold global SGCT settings.
 class Settings {
 public:
-    enum class CaptureFormat { PNG, TGA, JPG };
+    enum class CaptureFormat { PNG, TGA, JPG, QOI, Raw };
+
+    /// Determines what happens to a screenshot if the capture queue is full
+    enum class CaptureQueuePolicy {
+        Block, ///< The render thread waits until a capture thread is available
+        Drop   ///< The screenshot is discarded
+    };
 
     enum class DrawBufferType {
         Diffuse,
@@ -75,6 +82,94 @@ public:
     /// Set the number of capture threads used by SGCT (multi-threaded screenshots)
     void setNumberOfCaptureThreads(int count);
 
+    /**
+     * Set the number of pixel buffers that are used to download screenshots from the GPU.
+     * A screenshot is only copied out of its buffer once the transfer has finished, so
+     * more buffers allow the transfer to lag further behind the rendering before the
+     * render thread has to wait for it.
+     */
+    void setNumberOfCaptureBuffers(int count);
+
+    /**
+     * Set the maximum number of screenshots that are waiting to be written to disk by the
+     * capture threads. If the queue is full, the CaptureQueuePolicy determines whether
+     * the render thread waits for a free slot or whether the screenshot is dropped.
+     */
+    void setCaptureQueueSize(int size);
+
+    /// Set what happens to screenshots when the capture queue is full
+    void setCaptureQueuePolicy(CaptureQueuePolicy policy);
+
+    /**
+     * Restricts the screen capture to a rectangle of the captured framebuffer. The
+     * rectangle is given as (x, y, width, height) in pixels with the origin in the lower
+     * left corner and is clipped to the framebuffer. If the width or the height is 0, the
+     * entire framebuffer is captured.
+     */
+    void setCaptureRegion(ivec4 region);
+
+    /**
+     * Splits each screen capture into this number of horizontal strips, one of which is
+     * downloaded from the GPU per frame. This spreads the cost of capturing very large
+     * framebuffers over multiple frames, at the expense of the strips showing successive
+     * frames. Screenshots that are requested while a tiled capture is in progress are
+     * skipped.
+     */
+    void setNumberOfCaptureTiles(int count);
+
+    /**
+     * Set the command line of an encoder process. If it is not empty, the screenshots are
+     * streamed into the standard input of the process instead of being written to files,
+     * with one process per window and eye. The placeholders {node}, {window}, and {eye}
+     * in the command are replaced with the node index, the window index, and the eye
+     * (mono, left, or right).
+     */
+    void setCaptureEncoder(std::string command);
+
+    /**
+     * If set to true, the frames are streamed to the encoder unchanged in the format in
+     * which they are downloaded from the GPU. Otherwise, they are converted into a
+     * YUV4MPEG2 stream.
+     */
+    void setCaptureEncoderRawFrames(bool state);
+
+    /// Set the frame rate that is reported to the capture encoder
+    void setCaptureFrameRate(int frameRate);
+
+    /**
+     * Set the number of worker threads of the JobSystem. Has to be called before the job
+     * system is used for the first time.
+     */
+    void setNumberOfJobThreads(int count);
+
+    /**
+     * Set the number of megabytes that the ImageBufferPool keeps for reuse after the
+     * image buffers have been released. Has to be called before the first image is
+     * loaded or created.
+     */
+    void setImageBufferPoolSize(int megabytes);
+
+    /**
+     * Set whether large image buffers should be backed by transparent huge pages. This is
+     * only supported on Linux and has to be called before the first image is loaded or
+     * created.
+     */
+    void setUseHugePages(bool state);
+
+    /**
+     * Set the number of megabytes of texture data that the TextureManager uploads per
+     * frame for textures that are loaded asynchronously.
+     */
+    void setTextureUploadBudget(int megabytes);
+
+    /**
+     * Set the number of megabytes of GPU memory that the textures of the TextureManager
+     * may use. If the budget is exceeded, the least recently used textures that were
+     * loaded from a file are evicted and reloaded when they are used again. A value of 0
+     * disables the budget.
+     */
+    void setTextureMemoryBudget(int megabytes);
+
     /**
      * Set capture/screenshot path used by SGCT.
      *
@@ -97,12 +192,74 @@ public:
     /// Set to true if warping meshes should be exported as OBJ files.
     void setExportWarpingMeshes(bool state);
 
+    /**
+     * Set whether the generated correction meshes are stored in a binary cache so that
+     * the mesh files do not have to be parsed again on the next start.
+     */
+    void setUseCorrectionMeshCache(bool state);
+
+    /**
+     * Set the directory in which the correction meshes are cached. If the path is empty,
+     * a directory in the temporary directory of the system is used.
+     */
+    void setCorrectionMeshCachePath(std::string path);
+
+    /**
+     * Set the largest error in pixels of the texture coordinates that is allowed when
+     * the grids of correction meshes are decimated where the warp is locally linear. The
+     * error is measured in the framebuffer resolution of the window at the time the mesh
+     * is loaded. A value of 0 disables the decimation.
+     */
+    void setCorrectionMeshMaxError(float pixels);
+
+    /**
+     * If set to true, the triangles of correction meshes are joined into triangle strips
+     * that are separated by primitive restarts after their order has been optimized for
+     * the vertex cache. The strips are only used if they need fewer indices.
+     */
+    void setUseCorrectionMeshStrips(bool state);
+
     /// If set to true, the node name is added to screenshots
     void setAddNodeNameToScreenshot(bool state);
 
     /// If set to true, the window name is added to screenshots
     void setAddWindowNameToScreenshot(bool state);
 
+    /**
+     * Enables or disables adaptive frame pacing. If enabled, the render loop predicts the
+     * cost of the upcoming frame from the previous frames and delays the input polling,
+     * the preSync callback, and the encoding of the shared data to as close to the next
+     * vertical sync as possible. This reduces the latency between sampling the tracking
+     * or input state and presenting the result. Only has an effect if vertical sync is
+     * enabled (swap interval > 0).
+     */
+    void setUseFramePacing(bool state);
+
+    /**
+     * Sets the safety margin (in seconds) that is kept in addition to the predicted frame
+     * cost when frame pacing is enabled. Larger values make missed frames less likely at
+     * the expense of latency.
+     */
+    void setFramePacingMargin(double margin);
+
+    /**
+     * Enables or disables the dynamic resolution scaling. If enabled, the resolution of
+     * the offscreen render targets is reduced when the frame cost exceeds the target
+     * frame time and is increased again when there is enough headroom. The resolution
+     * scale is decided by the master based on the slowest node in the cluster and is
+     * distributed to all clients, so that all nodes render at the same scale.
+     */
+    void setUseDynamicResolution(bool state);
+
+    /**
+     * Sets the frame time (in seconds) that the dynamic resolution scaling tries to
+     * achieve. If the value is 0, the target is derived from the monitor refresh rate.
+     */
+    void setDynamicResolutionTarget(double target);
+
+    /// Sets the smallest resolution scale that the dynamic resolution scaling may use
+    void setDynamicResolutionMinScale(float scale);
+
     /// Get the capture/screenshot path.
     const std::string& capturePath() const;
 
@@ -130,6 +287,18 @@ public:
     /// Get if warping meshes should be exported as obj-files.
     bool exportWarpingMeshes() const;
 
+    /// Returns whether the generated correction meshes are cached
+    bool useCorrectionMeshCache() const;
+
+    /// Returns the directory in which the correction meshes are cached
+    std::string correctionMeshCachePath() const;
+
+    /// Returns the largest error in pixels for the correction mesh decimation
+    float correctionMeshMaxError() const;
+
+    /// Returns true if correction meshes are rendered as triangle strips where possible
+    bool useCorrectionMeshStrips() const;
+
     /**
      * Get the capture/screenshot path
      *
@@ -149,6 +318,45 @@ public:
     /// Get the number of capture threads (for screenshot recording)
     int numberCaptureThreads() const;
 
+    /// Get the number of pixel buffers used to download screenshots from the GPU
+    int numberCaptureBuffers() const;
+
+    /// Get the maximum number of screenshots that can wait for the capture threads
+    int captureQueueSize() const;
+
+    /// Get what happens to screenshots when the capture queue is full
+    CaptureQueuePolicy captureQueuePolicy() const;
+
+    /// Get the region of the framebuffer that is captured as (x, y, width, height)
+    ivec4 captureRegion() const;
+
+    /// Get the number of strips that each screen capture is split into
+    int numberCaptureTiles() const;
+
+    /// Get the command line of the capture encoder or an empty string if none is used
+    const std::string& captureEncoder() const;
+
+    /// Returns whether the frames are streamed to the capture encoder unchanged
+    bool captureEncoderRawFrames() const;
+
+    /// Get the frame rate that is reported to the capture encoder
+    int captureFrameRate() const;
+
+    /// Get the number of worker threads used by the JobSystem
+    int numberJobThreads() const;
+
+    /// Get the number of megabytes that the ImageBufferPool keeps for reuse
+    int imageBufferPoolSize() const;
+
+    /// Returns whether large image buffers are backed by huge pages
+    bool useHugePages() const;
+
+    /// Get the number of megabytes of texture data that is uploaded per frame
+    int textureUploadBudget() const;
+
+    /// Get the number of megabytes of GPU memory for textures or 0 if it is unlimited
+    int textureMemoryBudget() const;
+
     /// Returns whether screenshots should contain the node name
     bool addNodeNameToScreenshot() const;
 
@@ -158,6 +366,21 @@ public:
     /// Returns the prefix that is used for all screenshots
     const std::string& prefixScreenshot() const;
 
+    /// Returns whether adaptive frame pacing is enabled
+    bool useFramePacing() const;
+
+    /// Returns the safety margin in seconds that is used by the frame pacing
+    double framePacingMargin() const;
+
+    /// Returns whether the dynamic resolution scaling is enabled
+    bool useDynamicResolution() const;
+
+    /// Returns the target frame time in seconds or 0 if it is derived from the monitor
+    double dynamicResolutionTarget() const;
+
+    /// Returns the smallest resolution scale used by the dynamic resolution scaling
+    float dynamicResolutionMinScale() const;
+
     /// Returns true if the screenshots written out should be limited based on the begin
     /// and end ranges
     bool hasScreenshotLimit() const;
@@ -183,13 +406,36 @@ private:
     int _swapInterval = 1;
     int _refreshRate = 0;
     int _nCaptureThreads = std::max(std::thread::hardware_concurrency() - 1, 0u);
+    int _nCaptureBuffers = 3;
+    int _captureQueueSize = 8;
+    CaptureQueuePolicy _captureQueuePolicy = CaptureQueuePolicy::Block;
+    ivec4 _captureRegion = ivec4{ 0, 0, 0, 0 };
+    int _nCaptureTiles = 1;
+    std::string _captureEncoder;
+    bool _captureEncoderRawFrames = false;
+    int _captureFrameRate = 60;
+    // hardware_concurrency may return 0 if the number of cores is unknown
+    int _nJobThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    int _imageBufferPoolSize = 512;
+    bool _useHugePages = false;
+    int _textureUploadBudget = 16;
+    int _textureMemoryBudget = 0;
 
     bool _useDepthTexture = false;
     bool _useNormalTexture = false;
     bool _usePositionTexture = false;
     bool _captureBackBuffer = false;
     bool _exportWarpingMeshes = false;
-    
+    bool _useCorrectionMeshCache = true;
+    std::string _correctionMeshCachePath;
+    float _correctionMeshMaxError = 0.f;
+    bool _useCorrectionMeshStrips = false;
+    bool _useFramePacing = false;
+    double _framePacingMargin = 0.002;
+    bool _useDynamicResolution = false;
+    double _dynamicResolutionTarget = 0.0;
+    float _dynamicResolutionMinScale = 0.5f;
+
     struct Capture {
         std::string capturePath;
         std::string prefix;
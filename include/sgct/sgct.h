@@ -15,6 +15,7 @@
 #include <sgct/engine.h>
 #include <sgct/fmt.h>
 #include <sgct/image.h>
+#include <sgct/jobsystem.h>
 #include <sgct/keys.h>
 #include <sgct/log.h>
 #include <sgct/math.h>
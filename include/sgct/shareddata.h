@@ -13,6 +13,8 @@
 #include <sgct/network.h>
 #include <array>
 #include <cstddef>
+#include <fstream>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -42,6 +44,31 @@ public:
     int dataSize();
     int bufferSize();
 
+    /**
+     * Starts recording the encoded data of every frame into the file at \p path. Each
+     * record consists of the frame number, the time of the frame, and the data block
+     * that is sent to the clients. An existing file is overwritten.
+     */
+    void startRecording(const std::string& path);
+
+    /**
+     * Opens a file that was written by #startRecording for replay. While replaying, the
+     * recorded frames are passed to the decode function in #replayNextFrame instead of
+     * encoding the data of the current frame.
+     */
+    void startReplay(const std::string& path);
+
+    /// \return true if a recording is currently replayed
+    bool isReplaying() const;
+
+    /**
+     * Decodes the next frame of the replayed recording.
+     *
+     * \return The recorded time of the frame or std::nullopt if the end of the recording
+     *         has been reached
+     */
+    std::optional<double> replayNextFrame();
+
 private:
     SharedData();
 
@@ -52,6 +79,10 @@ private:
     static SharedData* _instance;
     std::vector<std::byte> _dataBlock;
     std::array<std::byte, Network::HeaderSize> _headerSpace;
+
+    std::ofstream _recording;
+    std::ifstream _replay;
+    std::vector<char> _replayBuffer;
 };
 
 template <typename T>
@@ -9,24 +9,57 @@
 #ifndef __SGCT__TEXTUREMANAGER__H__
 #define __SGCT__TEXTUREMANAGER__H__
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 namespace sgct {
 
+struct CompressedTexture;
 class Image;
 
 /**
  * The TextureManager loads and handles textures. It is a singleton and can be accessed
- * anywhere using its static instance. Currently only PNG textures are supported.
+ * anywhere using its static instance. Textures can be loaded from all image formats that
+ * the Image class supports as well as from DDS, KTX, and KTX2 files that contain BC1,
+ * BC3, or BC7 compressed textures.
+ *
+ * The TextureManager keeps track of the estimated GPU memory of every texture. If a
+ * budget is set with Settings::setTextureMemoryBudget, the least recently used textures
+ * that were loaded from a file are evicted when a new texture would exceed it. An evicted
+ * texture keeps its OpenGL name and is reloaded from its file when it is marked as used
+ * again, which requires the application to call the use function for every texture that
+ * it renders.
  */
 class TextureManager {
 public:
+    struct Statistics {
+        /// The number of textures that are handled by the TextureManager
+        int nTextures = 0;
+        /// The number of textures that are currently evicted from GPU memory
+        int nEvicted = 0;
+        /// The estimated number of bytes of GPU memory that the textures use
+        size_t nBytesResident = 0;
+        /// The largest number of bytes that the textures have used at the same time
+        size_t maxBytesResident = 0;
+        /// The number of times that a texture was evicted
+        int nEvictions = 0;
+        /// The number of times that an evicted texture was reloaded
+        int nReloads = 0;
+    };
+
     static TextureManager& instance();
     static void destroy();
 
     /**
-     * Loads a texture to the TextureManager.
+     * Loads a texture to the TextureManager. DDS, KTX, and KTX2 files are uploaded in
+     * their compressed format with the mipmap levels that are stored in the file, in
+     * which case \p mipmapLevels is ignored. Compressed files whose rows are stored from
+     * top to bottom and cannot be flipped (see CompressedTexture) are rejected.
      *
      * \param filename the filename or path to the texture
      * \param interpolate set to true for using interpolation (bi-linear filtering)
@@ -50,9 +83,70 @@ public:
               this value to 1 or less disables mipmaps
      * \return The OpenGL name for the texture that was loaded
      */
-    unsigned int loadTexture(Image img, bool interpolate = true,
+    unsigned int loadTexture(const Image& img, bool interpolate = true,
         float anisotropicFilterSize = 1.f, int mipmapLevels = 8);
 
+    /**
+     * Loads a block compressed texture to the TextureManager together with all of its
+     * mipmap levels. The levels are uploaded in the order in which they are stored, so
+     * a texture that CompressedTexture::isTopDown has to be sampled with a flipped V
+     * coordinate.
+     *
+     * \param texture The compressed texture data
+     * \param interpolate set to true for using interpolation (bi-linear filtering)
+     * \param anisotropicFilterSize The filter size that is used for the anisotropic
+     *        filtering. If this value is 1.f, only bilinear filtering is used
+     * \return The OpenGL name for the texture that was loaded
+     */
+    unsigned int loadTexture(const CompressedTexture& texture, bool interpolate = true,
+        float anisotropicFilterSize = 1.f);
+
+    /**
+     * Loads a texture without blocking the calling thread. The image is decoded on the
+     * JobSystem and its pixel data is uploaded in slices through a staging buffer during
+     * the following frames, no more than Settings::textureUploadBudget megabytes per
+     * frame, so that loading large textures does not stall the rendering. As every node
+     * of a cluster loads at its own pace, the application has to synchronize the frame
+     * in which a new texture is shown if the nodes should switch at the same time.
+     * DDS, KTX, and KTX2 files are read on the JobSystem and uploaded level by level in
+     * rows of blocks within the same budget.
+     *
+     * \param filename the filename or path to the texture
+     * \param interpolate set to true for using interpolation (bi-linear filtering)
+     * \param anisotropicFilterSize The filter size that is used for the anisotropic
+     *        filtering. If this value is 1.f, only bilinear filtering is used
+     * \param mipmapLevels is the number of mipmap levels that will be generated, setting
+              this value to 1 or less disables mipmaps
+     * \return A future that receives the OpenGL name of the texture once it has been
+     *         uploaded completely, or the error if the image could not be loaded. The
+     *         texture must not be used before the future is ready
+     */
+    std::shared_future<unsigned int> loadTextureAsync(const std::string& filename,
+        bool interpolate = true, float anisotropicFilterSize = 1.f,
+        int mipmapLevels = 8);
+
+    /**
+     * Uploads the next slices of the textures that are loaded asynchronously. This
+     * function is called by the Engine once per frame before the PostSyncPreDraw callback
+     * with the shared context being active.
+     */
+    void update();
+
+    /**
+     * Marks the texture as used in the current frame, which makes it the last one to be
+     * evicted if the texture memory budget is exceeded. If the texture was evicted, it is
+     * reloaded from its file in the background into the same OpenGL name and uploaded
+     * within the per-frame budget of loadTextureAsync. Until the upload is complete, the
+     * texture consists of a single transparent texel.
+     *
+     * \param textureId The id of the texture that is used, this has to be an id that was
+     *        returned from a previous call to loadTexture or loadTextureAsync
+     */
+    void use(unsigned int textureId);
+
+    /// Returns the number of textures and the amount of GPU memory that they use
+    Statistics statistics() const;
+
     /**
      * Removes a previously generated OpenGL texture.
      *
@@ -62,9 +156,60 @@ public:
     void removeTexture(unsigned int textureId);
 
 private:
+    struct AsyncLoad;
+    struct StagingBuffer;
+
+    struct TextureInfo {
+        /// The file that the texture is reloaded from, empty if it cannot be evicted
+        std::string filename;
+        bool interpolate = true;
+        float anisotropicFilterSize = 1.f;
+        int mipmapLevels = 8;
+
+        /// The estimated number of bytes of GPU memory and the number of levels
+        size_t size = 0;
+        int nLevels = 1;
+
+        /// The frame in which the texture was used the last time
+        uint64_t lastUsed = 0;
+        bool isResident = true;
+        /// The texture is uploaded asynchronously and must not be evicted
+        bool isLoading = false;
+    };
+
     ~TextureManager();
+
+    void submitAsyncLoad(std::shared_ptr<AsyncLoad> load);
+
+    /// Allocates the texture of \p load, or the storage of the evicted texture it reloads
+    void beginUpload(AsyncLoad& load);
+
+    /// Uploads rows of \p load into the staging buffer and returns the number of bytes
+    size_t uploadRows(AsyncLoad& load, size_t budget);
+
+    /// Uploads rows of blocks of the compressed \p load and returns the number of bytes
+    size_t uploadBlocks(AsyncLoad& load, size_t budget);
+
+    /// Generates the mipmaps of the uploaded texture and makes it available for sampling
+    void finishUpload(AsyncLoad& load);
+
+    /// Registers a texture whose storage was just allocated
+    void addTexture(unsigned int textureId, TextureInfo info);
+
+    /// Evicts the least recently used textures until \p size more bytes fit the budget
+    void makeRoom(size_t size);
+
+    /// Releases the storage of the texture but keeps its name valid
+    void evict(unsigned int textureId, TextureInfo& info);
+
     static TextureManager* _instance;
-    std::vector<unsigned int> _textures;
+    std::unordered_map<unsigned int, TextureInfo> _textures;
+    Statistics _statistics;
+    uint64_t _frame = 0;
+    bool _hasWarnedAboutBudget = false;
+
+    std::deque<std::shared_ptr<AsyncLoad>> _asyncLoads;
+    std::unique_ptr<StagingBuffer> _stagingBuffer;
 };
 
 } // namespace sgct
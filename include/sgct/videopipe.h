@@ -0,0 +1,93 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__VIDEOPIPE__H__
+#define __SGCT__VIDEOPIPE__H__
+
+#include <sgct/math.h>
+#include <sgct/settings.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Streams frames through a pipe into the standard input of an external process, for
+ * example a video encoder. The frames are either converted into a YUV4MPEG2 (Y4M) stream
+ * or passed on unchanged in the format in which they were downloaded from the GPU
+ * (BGR(A), rows stored bottom to top, 16 bit channels little-endian).
+ *
+ * The frames are written by a separate thread. The render thread only copies each frame
+ * into a bounded queue; if the encoder cannot keep up and the queue is full, the
+ * CaptureQueuePolicy determines whether the render thread waits or the frame is dropped.
+ */
+class VideoPipe {
+public:
+    enum class Format { Y4M, Raw };
+
+    /**
+     * Starts the \p command and opens a pipe to its standard input.
+     *
+     * \param command The command line of the process that receives the frames
+     * \param format The format in which the frames are written into the pipe
+     * \param size The size of the frames in pixels
+     * \param channels The number of channels of the frames, 3 or 4
+     * \param bytesPerChannel The number of bytes per channel, 1 or 2. 16 bit channels are
+     *        reduced to 8 bit for the Y4M format
+     * \param frameRate The frame rate that is stored in the Y4M stream header
+     * \param queueSize The number of frames that can be waiting to be written
+     * \param policy Determines what happens to frames when the queue is full
+     */
+    VideoPipe(const std::string& command, Format format, ivec2 size, int channels,
+        int bytesPerChannel, int frameRate, int queueSize,
+        Settings::CaptureQueuePolicy policy);
+
+    /// Writes the remaining frames, closes the pipe, and waits for the process to exit
+    ~VideoPipe();
+
+    /// Copies the frame into the queue. The \p data has to contain a complete frame
+    void push(const unsigned char* data);
+
+private:
+    void writerLoop();
+    bool writeFrame(std::vector<unsigned char>& frame);
+    static void consumeBrokenPipeSignal();
+
+    FILE* _pipe = nullptr;
+    const std::string _command;
+    const Format _format;
+    const ivec2 _size;
+    const int _channels;
+    const int _bytesPerChannel;
+    const Settings::CaptureQueuePolicy _policy;
+
+    std::vector<std::vector<unsigned char>> _frames;
+    std::vector<unsigned char> _yuv;
+    // The Y4M stream header, which is written by the writer thread
+    std::string _header;
+
+    std::mutex _mutex;
+    std::condition_variable _hasFrame;
+    std::condition_variable _hasSpace;
+    size_t _first = 0;
+    size_t _count = 0;
+    bool _isRunning = true;
+    bool _hasFailed = false;
+    uint64_t _nWritten = 0;
+    uint64_t _nDropped = 0;
+
+    std::thread _writer;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__VIDEOPIPE__H__
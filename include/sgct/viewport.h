@@ -43,6 +43,12 @@ public:
     void applyViewport(const sgct::config::Viewport& viewport);
     void applySettings(const sgct::config::MpcdiProjection& mpcdi);
     void setMpcdiWarpMesh(std::vector<char> data);
+
+    /**
+     * Parses the correction mesh of the viewport without uploading it. This function can
+     * be called for several viewports in parallel before calling loadData.
+     */
+    void parseMesh();
     void loadData();
 
     /// Render the viewport mesh which the framebuffer texture is attached to
@@ -163,6 +163,17 @@ public:
      */
     void setFramebufferResolution(ivec2 resolution);
 
+    /**
+     * Sets the scale that is applied to the framebuffer resolution and the cubemap
+     * resolution of non-linear projections. The offscreen render targets are rendered at
+     * the scaled resolution and are stretched to the window when rendering to screen.
+     * Like the framebuffer resolution, the new scale is deferred until the next call to
+     * updateResolutions.
+     *
+     * \param scale The scale of the render targets in the range (0, 1]
+     */
+    void setResolutionScale(float scale);
+
     /**
      * Set this window's position in screen coordinates.
      *
@@ -315,9 +326,12 @@ public:
     /// \return Get the window resolution.
     ivec2 resolution() const;
 
-    /// \return Get the frame buffer resolution.
+    /// \return Get the frame buffer resolution, including the resolution scale.
     ivec2 framebufferResolution() const;
 
+    /// \return the scale that is applied to the offscreen render targets
+    float resolutionScale() const;
+
     /// \return Get the initial window resolution.
     ivec2 initialResolution() const;
 
@@ -398,6 +412,9 @@ private:
     ivec2 _windowInitialRes = ivec2{ 640, 480 };
     std::optional<ivec2> _pendingWindowRes;
     std::optional<ivec2> _pendingFramebufferRes;
+    float _resolutionScale = 1.f;
+    std::optional<float> _pendingResolutionScale;
+    bool _hasNewResolutionScale = false;
     ivec2 _windowRes = ivec2{ 640, 480 };
     ivec2 _windowPos = ivec2{ 0, 0 };
     ivec2 _windowResOld = ivec2{ 640, 480 };
@@ -11,9 +11,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <array>
 #include <filesystem>
 #include <numeric>
-#include <thread>
+#include <string>
+#include <vector>
 
 namespace {
     struct {
@@ -350,100 +352,29 @@ void initializeBox() {
     glBindVertexArray(0);
 
 
-    struct ImageData {
-        std::string filename;
-        Image img;
-        std::atomic_bool imageDone = false;
-        std::atomic_bool uploadDone = false;
-        std::atomic_bool threadDone = false;
-    };
-    auto loadImage = [](ImageData& data) {
-        data.img.load(data.filename);
-        data.imageDone = true;
-        while (!data.uploadDone) {}
-        data.img = Image();
-        data.threadDone = true;
-    };
-
     Log::Info("Loading test pattern images...");
 
-    ImageData front;
-    front.filename = "test-pattern-0.png";
-    if (!std::filesystem::exists(front.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", front.filename));
-        exit(EXIT_FAILURE);
-    }
-    std::thread t1(loadImage, std::ref(front));
-
-    ImageData right;
-    right.filename = "test-pattern-1.png";
-    if (!std::filesystem::exists(right.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", right.filename));
-        exit(EXIT_FAILURE);
-    }
-    std::thread t2(loadImage, std::ref(right));
-
-    ImageData back;
-    back.filename = "test-pattern-2.png";
-    if (!std::filesystem::exists(back.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", back.filename));
-        exit(EXIT_FAILURE);
-    }
-    std::thread t3(loadImage, std::ref(back));
-
-    ImageData left;
-    left.filename = "test-pattern-3.png";
-    if (!std::filesystem::exists(left.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", left.filename));
-        exit(EXIT_FAILURE);
-    }
-    std::thread t4(loadImage, std::ref(left));
-
-    ImageData top;
-    top.filename = "test-pattern-4.png";
-    if (!std::filesystem::exists(top.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", top.filename));
-        exit(EXIT_FAILURE);
+    std::vector<std::string> filenames;
+    for (int i = 0; i < 6; ++i) {
+        std::string filename = fmt::format("test-pattern-{}.png", i);
+        if (!std::filesystem::exists(filename)) {
+            Log::Error(fmt::format("Could not find image '{}'", filename));
+            exit(EXIT_FAILURE);
+        }
+        filenames.push_back(std::move(filename));
     }
-    std::thread t5(loadImage, std::ref(top));
 
-    ImageData bottom;
-    bottom.filename = "test-pattern-5.png";
-    if (!std::filesystem::exists(bottom.filename)) {
-        Log::Error(fmt::format("Could not find image '{}'", bottom.filename));
-        exit(EXIT_FAILURE);
-    }
-    std::thread t6(loadImage, std::ref(bottom));
-
-    while (!front.imageDone || !right.imageDone || !back.imageDone ||
-           !left.imageDone || !top.imageDone || !bottom.imageDone)
-    {}
-
-    box.textureFront = TextureManager::instance().loadTexture(std::move(front.img));
-    front.uploadDone = true;
-    box.textureRight = TextureManager::instance().loadTexture(std::move(right.img));
-    right.uploadDone = true;
-    box.textureBack = TextureManager::instance().loadTexture(std::move(back.img));
-    back.uploadDone = true;
-    box.textureLeft = TextureManager::instance().loadTexture(std::move(left.img));
-    left.uploadDone = true;
-    box.textureTop = TextureManager::instance().loadTexture(std::move(top.img));
-    top.uploadDone = true;
-    box.textureBottom = TextureManager::instance().loadTexture(std::move(bottom.img));
-    bottom.uploadDone = true;
-
-    while (!front.threadDone) {}
-    t1.join();
-    while (!right.threadDone) {}
-    t2.join();
-    while (!back.threadDone) {}
-    t3.join();
-    while (!left.threadDone) {}
-    t4.join();
-    while (!top.threadDone) {}
-    t5.join();
-    while (!bottom.threadDone) {}
-    t6.join();
+    // The images are decoded in parallel and uploaded in order as soon as they are ready
+    const std::array<GLuint*, 6> textures = {
+        &box.textureFront, &box.textureRight, &box.textureBack,
+        &box.textureLeft, &box.textureTop, &box.textureBottom
+    };
+    Image::loadMultiple(
+        filenames,
+        [&textures](size_t index, Image& img) {
+            *textures[index] = TextureManager::instance().loadTexture(img);
+        }
+    );
 
     ShaderManager::instance().addShaderProgram(
         "box",
@@ -0,0 +1,76 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sgct.h>
+#include <sgct/rawcapture.h>
+#include <cstring>
+#include <iostream>
+
+// Converts the frames of a raw capture file that was written with --capture-raw into
+// individual image files.
+// Usage:  rawcaptureconverter <file> [output folder] [png|jpg|tga|qoi]
+
+namespace {
+    std::string eyeName(uint32_t eye) {
+        switch (eye) {
+            case 0: return "mono";
+            case 1: return "left";
+            case 2: return "right";
+            default: return "eye" + std::to_string(eye);
+        }
+    }
+} // namespace
+
+using namespace sgct;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout <<
+            "Usage: rawcaptureconverter <file> [output folder] [png|jpg|tga|qoi]\n";
+        return -1;
+    }
+
+    const std::string path = argv[1];
+    const std::string folder = argc > 2 ? std::string(argv[2]) + '/' : "";
+    const std::string suffix = argc > 3 ? argv[3] : "png";
+    if (suffix != "png" && suffix != "jpg" && suffix != "tga" && suffix != "qoi") {
+        std::cout << fmt::format("Unsupported image format '{}'\n", suffix);
+        return -1;
+    }
+
+    try {
+        RawCaptureReader reader(path);
+        std::vector<unsigned char> data;
+        Image img;
+        int nFrames = 0;
+        while (std::optional<RawFrameHeader> header = reader.nextFrame(data)) {
+            img.setSize(ivec2{ header->width, header->height });
+            img.setChannels(static_cast<int>(header->channels));
+            img.setBytesPerChannel(static_cast<int>(header->bytesPerChannel));
+            img.allocateOrResizeData();
+            std::memcpy(img.data(), data.data(), data.size());
+
+            const std::string file = fmt::format(
+                "{}window{}_{}_{:06}.{}",
+                folder, header->windowId, eyeName(header->eye), header->frameNumber,
+                suffix
+            );
+            img.save(file);
+            nFrames++;
+        }
+        std::cout << fmt::format("Converted {} frames\n", nFrames);
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << e.what() << '\n';
+        JobSystem::destroy();
+        return -1;
+    }
+
+    JobSystem::destroy();
+    return 0;
+}
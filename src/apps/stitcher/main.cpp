@@ -578,6 +578,9 @@ int main(int argc, char** argv) {
                 else if (format == "jpg" || format == "JPG") {
                     return Settings::CaptureFormat::JPG;
                 }
+                else if (format == "qoi" || format == "QOI") {
+                    return Settings::CaptureFormat::QOI;
+                }
                 else {
                     Log::Info("Unknown capturing format. Using PNG");
                     return Settings::CaptureFormat::PNG;
@@ -0,0 +1,170 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/sgct.h>
+#include <sgct/compressedtexture.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// Converts an image into a DDS file with a BC1 or BC3 compressed texture and all of its
+// mipmap levels, which can be loaded by the TextureManager without any decoding.
+// Usage:  textureconverter <image> <output.dds> [bc1|bc3] [--srgb] [--no-mipmaps]
+
+namespace {
+    // Halves the size of the image by averaging blocks of 2x2 pixels. Odd rows and
+    // columns at the border are repeated
+    std::vector<unsigned char> downsample(const std::vector<unsigned char>& pixels,
+                                          sgct::ivec2 size, int channels)
+    {
+        const sgct::ivec2 res = { std::max(size.x / 2, 1), std::max(size.y / 2, 1) };
+        std::vector<unsigned char> data(static_cast<size_t>(res.x) * res.y * channels);
+        for (int y = 0; y < res.y; ++y) {
+            const int y0 = std::min(2 * y, size.y - 1);
+            const int y1 = std::min(2 * y + 1, size.y - 1);
+            for (int x = 0; x < res.x; ++x) {
+                const int x0 = std::min(2 * x, size.x - 1);
+                const int x1 = std::min(2 * x + 1, size.x - 1);
+                for (int c = 0; c < channels; ++c) {
+                    auto p = [&](int px, int py) {
+                        const size_t i = static_cast<size_t>(py) * size.x + px;
+                        return pixels[i * channels + c];
+                    };
+                    const int sum = p(x0, y0) + p(x1, y0) + p(x0, y1) + p(x1, y1);
+                    data[(static_cast<size_t>(y) * res.x + x) * channels + c] =
+                        static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        return data;
+    }
+} // namespace
+
+using namespace sgct;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout <<
+            "Usage: textureconverter <image> <output.dds> [bc1|bc3] [--srgb] "
+            "[--no-mipmaps]\n";
+        return -1;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    std::string formatName;
+    bool isSrgb = false;
+    bool hasMipmaps = true;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "bc1" || arg == "bc3") {
+            formatName = arg;
+        }
+        else if (arg == "--srgb") {
+            isSrgb = true;
+        }
+        else if (arg == "--no-mipmaps") {
+            hasMipmaps = false;
+        }
+        else {
+            std::cout << fmt::format("Unknown argument '{}'\n", arg);
+            return -1;
+        }
+    }
+
+    try {
+        Image img;
+        img.load(input);
+        if (img.bytesPerChannel() != 1) {
+            std::cout << "Only images with 8 bits per channel are supported\n";
+            return -1;
+        }
+
+        // Images with an alpha channel are compressed to BC3 unless BC1 is requested
+        const int channels = img.channels();
+        if (formatName.empty()) {
+            formatName = (channels == 2 || channels == 4) ? "bc3" : "bc1";
+        }
+
+        CompressedTexture texture;
+        texture.format = formatName == "bc3" ?
+            CompressedTexture::Format::BC3 :
+            CompressedTexture::Format::BC1;
+        texture.isSrgb = isSrgb;
+
+        const int nLevels = hasMipmaps ? numberOfMipmapLevels(img.size()) : 1;
+        ivec2 size = img.size();
+        std::vector<unsigned char> pixels(
+            img.data(),
+            img.data() + static_cast<size_t>(size.x) * size.y * channels
+        );
+
+        // DDS files are stored from top to bottom. Compressing the flipped image is exact
+        // for every size, which flipping the compressed blocks is not
+        const size_t rowSize = static_cast<size_t>(size.x) * channels;
+        for (int y = 0; y < size.y / 2; ++y) {
+            std::swap_ranges(
+                pixels.begin() + y * rowSize,
+                pixels.begin() + (y + 1) * rowSize,
+                pixels.begin() + (size.y - 1 - y) * rowSize
+            );
+        }
+        texture.isTopDown = true;
+
+        for (int i = 0; i < nLevels; ++i) {
+            const std::vector<unsigned char> blocks =
+                compressBlocks(pixels.data(), size, channels, texture.format);
+
+            CompressedTexture::Level level;
+            level.size = size;
+            level.offset = texture.data.size();
+            level.dataSize = blocks.size();
+            texture.levels.push_back(level);
+            texture.data.insert(texture.data.end(), blocks.begin(), blocks.end());
+
+            if (i + 1 < nLevels) {
+                pixels = downsample(pixels, size, channels);
+                size = ivec2{ std::max(size.x / 2, 1), std::max(size.y / 2, 1) };
+            }
+        }
+
+        const bool isUpright = std::all_of(
+            texture.levels.begin(),
+            texture.levels.end(),
+            [](const CompressedTexture::Level& level) {
+                return level.size.y <= 4 || level.size.y % 4 == 0;
+            }
+        );
+        if (!isUpright) {
+            std::cout << "The height of a level is not a multiple of 4, so the rows of "
+                "the file cannot be flipped and the TextureManager will reject it\n";
+        }
+
+        const std::vector<unsigned char> contents = writeDDS(texture);
+        std::ofstream file(output, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+        if (!file.good()) {
+            std::cout << fmt::format("Could not write file '{}'\n", output);
+            return -1;
+        }
+
+        const size_t uncompressed =
+            static_cast<size_t>(img.size().x) * img.size().y * channels;
+        std::cout << fmt::format(
+            "Converted {}x{} image to {} with {} levels ({} bytes, {} uncompressed)\n",
+            img.size().x, img.size().y, formatName, nLevels, texture.data.size(),
+            uncompressed
+        );
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
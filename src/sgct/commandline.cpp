@@ -73,14 +73,95 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.captureFormat = Settings::CaptureFormat::JPG;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--capture-qoi") {
+            config.captureFormat = Settings::CaptureFormat::QOI;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--capture-raw") {
+            config.captureFormat = Settings::CaptureFormat::Raw;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "--number-capture-threads" && arg.size() > (i + 1)) {
             config.nCaptureThreads = std::stoi(arg[i + 1]);
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
         }
+        else if (arg[i] == "--number-capture-buffers" && arg.size() > (i + 1)) {
+            config.nCaptureBuffers = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--capture-queue-size" && arg.size() > (i + 1)) {
+            config.captureQueueSize = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--capture-drop-frames") {
+            config.dropCaptureFrames = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--capture-region" && arg.size() > (i + 4)) {
+            config.captureRegion = ivec4{
+                std::stoi(arg[i + 1]),
+                std::stoi(arg[i + 2]),
+                std::stoi(arg[i + 3]),
+                std::stoi(arg[i + 4])
+            };
+            arg.erase(arg.begin() + i, arg.begin() + i + 5);
+        }
+        else if (arg[i] == "--capture-tiles" && arg.size() > (i + 1)) {
+            config.nCaptureTiles = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--capture-encoder" && arg.size() > (i + 1)) {
+            config.captureEncoder = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--capture-encoder-raw") {
+            config.captureEncoderRawFrames = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--capture-frame-rate" && arg.size() > (i + 1)) {
+            config.captureFrameRate = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--number-job-threads" && arg.size() > (i + 1)) {
+            config.nJobThreads = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--image-pool-size" && arg.size() > (i + 1)) {
+            config.imageBufferPoolSize = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--huge-pages") {
+            config.useHugePages = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--texture-upload-budget" && arg.size() > (i + 1)) {
+            config.textureUploadBudget = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--texture-memory-budget" && arg.size() > (i + 1)) {
+            config.textureMemoryBudget = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
         else if (arg[i] == "--export-correction-meshes") {
             config.exportCorrectionMeshes = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--no-correction-mesh-cache") {
+            config.useCorrectionMeshCache = false;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--correction-mesh-cache" && arg.size() > (i + 1)) {
+            config.correctionMeshCachePath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--correction-mesh-max-error" && arg.size() > (i + 1)) {
+            config.correctionMeshMaxError = std::stof(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--correction-mesh-strips") {
+            config.useCorrectionMeshStrips = true;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "--screenshot-path") {
             config.screenshotPath = arg[i + 1];
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
@@ -97,6 +178,37 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.omitWindowNameInScreenshot = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--frame-pacing") {
+            config.useFramePacing = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--frame-pacing-margin" && arg.size() > (i + 1)) {
+            config.useFramePacing = true;
+            config.framePacingMargin = std::stod(arg[i + 1]) / 1000.0;
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--dynamic-resolution") {
+            config.useDynamicResolution = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--dynamic-resolution-target" && arg.size() > (i + 1)) {
+            config.useDynamicResolution = true;
+            config.dynamicResolutionTarget = std::stod(arg[i + 1]) / 1000.0;
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--dynamic-resolution-min-scale" && arg.size() > (i + 1)) {
+            config.useDynamicResolution = true;
+            config.dynamicResolutionMinScale = std::stof(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--record-shared-data" && arg.size() > (i + 1)) {
+            config.recordSharedData = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--replay-shared-data" && arg.size() > (i + 1)) {
+            config.replaySharedData = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
         else if (arg[i] == "-config") {
             // @DEPRECATED
             Log::Warning("Using -config has been deprecated in favor of -c or --config");
@@ -144,8 +256,27 @@ Parameters:
     Use jpg images for screen capture
 --capture-tga
     Use tga images for screen capture
+--capture-qoi
+    Use lossless qoi images for screen capture, which are much faster to write than png
+    images. 16-bit screenshots are still written as png images
+--capture-raw
+    Append unencoded screen captures to a single memory-mapped file per node that can
+    be converted into images with the rawcaptureconverter
 --export-correction-meshes
     Exports the correction warping meshes to OBJ files when loading them
+--correction-mesh-cache <path>
+    Set the directory in which the generated correction meshes are cached so that the
+    mesh files are only parsed again if they change (default is a directory in the
+    temporary directory of the system)
+--no-correction-mesh-cache
+    Always parse the correction mesh files instead of using the cache
+--correction-mesh-max-error <float>
+    Decimate the grids of correction meshes where the warp is locally linear, allowing
+    texture coordinates to deviate by at most this many pixels (default 0, which
+    disables the decimation)
+--correction-mesh-strips
+    Render correction meshes as triangle strips with primitive restarts instead of
+    triangle lists where this needs fewer indices
 --screenshot-path
     Sets the file path for the screenshots location
 --screenshot-prefix
@@ -156,6 +287,65 @@ Parameters:
     If set, screenshots will not contain the name of the window if multiple windows exist
 --number-capture-threads <integer>
     Set the maximum amount of thread that should be used during framecapture
+--number-capture-buffers <integer>
+    Set the number of buffers that are used to download screenshots from the GPU without
+    stalling the rendering (default 3)
+--capture-queue-size <integer>
+    Set the number of screenshots that can wait to be written to disk (default 8)
+--capture-drop-frames
+    If set, screenshots are dropped when the capture queue is full instead of waiting
+    for a capture thread to become available
+--capture-region <x> <y> <width> <height>
+    Only capture this rectangle (in pixels, origin in the lower left corner) of each
+    window instead of the entire window
+--capture-tiles <integer>
+    Split each screen capture into this number of horizontal strips that are downloaded
+    in successive frames to avoid a single large stall (default 1)
+--capture-encoder <command>
+    Stream the screenshots into the standard input of the command instead of writing
+    image files, for example "ffmpeg -i - -c:v libx264 window{window}_{eye}.mp4". The
+    placeholders {node}, {window}, and {eye} are replaced for each window and eye
+--capture-encoder-raw
+    Stream the frames to the encoder unchanged (BGR(A), bottom-up) instead of as a
+    YUV4MPEG2 stream
+--capture-frame-rate <integer>
+    Set the frame rate that is reported to the capture encoder (default 60)
+--number-job-threads <integer>
+    Set the number of worker threads of the job system that is shared between SGCT and
+    the application
+--image-pool-size <integer>
+    Set the number of megabytes of image memory that is kept for reuse after images
+    have been freed (default 512)
+--huge-pages
+    Back large image buffers with transparent huge pages (Linux only)
+--texture-upload-budget <integer>
+    Set the number of megabytes of texture data that is uploaded per frame for textures
+    that are loaded asynchronously (default 16)
+--texture-memory-budget <integer>
+    Set the number of megabytes of GPU memory that textures may use. The least recently
+    used textures are evicted when the budget is exceeded and are reloaded from their
+    files on their next use (default 0, which is unlimited)
+--frame-pacing
+    Delay input polling and synchronization as close to the next vertical sync as the
+    predicted frame cost allows in order to reduce latency
+--frame-pacing-margin <milliseconds>
+    Enables frame pacing and sets the safety margin that is added to the predicted frame
+    cost (default 2 ms)
+--dynamic-resolution
+    Scale the resolution of the offscreen render targets of the whole cluster to keep
+    the frame time of the slowest node below the target frame time
+--dynamic-resolution-target <milliseconds>
+    Enables the dynamic resolution and sets the target frame time. By default the target
+    is derived from the refresh rate of the monitor
+--dynamic-resolution-min-scale <float>
+    Enables the dynamic resolution and sets the smallest resolution scale (default 0.5)
+--record-shared-data <filename>
+    Records the shared data and the time of every frame on the master node into the
+    provided file
+--replay-shared-data <filename>
+    Replays a recording created with --record-shared-data instead of calling the preSync
+    and encode functions. Frames are rendered as fast as possible using the recorded
+    time, which makes it possible to render the recording offline
 )";
 }
 
@@ -0,0 +1,811 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/compressedtexture.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#define Err(code, msg) Error(Error::Component::Image, code, msg)
+
+namespace {
+    using Format = sgct::CompressedTexture::Format;
+
+    constexpr const std::array<unsigned char, 12> KTX1Id = {
+        0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+    constexpr const std::array<unsigned char, 12> KTX2Id = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+
+    constexpr uint32_t fourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+            (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    constexpr const uint32_t DDSMagic = fourCC('D', 'D', 'S', ' ');
+    constexpr const size_t DDSHeaderSize = 4 + 124;
+    constexpr const size_t DDSDX10HeaderSize = 20;
+    constexpr const size_t KTX1HeaderSize = 64;
+    constexpr const size_t KTX2HeaderSize = 80;
+    constexpr const size_t KTX2LevelIndexSize = 24;
+
+    // DDS flags
+    constexpr const uint32_t DDSDCaps = 0x1;
+    constexpr const uint32_t DDSDHeight = 0x2;
+    constexpr const uint32_t DDSDWidth = 0x4;
+    constexpr const uint32_t DDSDPixelFormat = 0x1000;
+    constexpr const uint32_t DDSDMipMapCount = 0x20000;
+    constexpr const uint32_t DDSDLinearSize = 0x80000;
+    constexpr const uint32_t DDPFAlphaPixels = 0x1;
+    constexpr const uint32_t DDPFFourCC = 0x4;
+    constexpr const uint32_t DDSCapsComplex = 0x8;
+    constexpr const uint32_t DDSCapsTexture = 0x1000;
+    constexpr const uint32_t DDSCapsMipMap = 0x400000;
+    constexpr const uint32_t DDSCaps2CubeMap = 0x200;
+    constexpr const uint32_t DDSCaps2Volume = 0x200000;
+    constexpr const uint32_t D3D10ResourceDimensionTexture2D = 3;
+    constexpr const uint32_t D3D10ResourceMiscTextureCube = 0x4;
+
+    [[noreturn]] void fail(const std::string& name, const std::string& reason) {
+        throw sgct::Error(
+            sgct::Error::Component::Image,
+            9023,
+            fmt::format("Could not load compressed texture '{}': {}", name, reason)
+        );
+    }
+
+    uint32_t read32(const unsigned char* data) {
+        uint32_t v;
+        std::memcpy(&v, data, sizeof(uint32_t));
+        return v;
+    }
+
+    uint64_t read64(const unsigned char* data) {
+        uint64_t v;
+        std::memcpy(&v, data, sizeof(uint64_t));
+        return v;
+    }
+
+    void write32(std::vector<unsigned char>& res, uint32_t value) {
+        const size_t pos = res.size();
+        res.resize(pos + sizeof(uint32_t));
+        std::memcpy(res.data() + pos, &value, sizeof(uint32_t));
+    }
+
+    // Creates the levels of the texture and allocates the memory for them. The memory is
+    // only allocated if the levels fit into the \p available bytes of the file, so that
+    // a corrupt header cannot cause a huge allocation
+    void createLevels(sgct::CompressedTexture& texture, sgct::ivec2 size, int nLevels,
+                      size_t available, const std::string& name)
+    {
+        // Larger than any texture that OpenGL implementations support
+        constexpr const int MaxSize = 1 << 16;
+        if (size.x <= 0 || size.y <= 0 || size.x > MaxSize || size.y > MaxSize) {
+            fail(name, fmt::format("invalid size {}x{}", size.x, size.y));
+        }
+        if (nLevels > sgct::numberOfMipmapLevels(size)) {
+            fail(name, fmt::format("too many mipmap levels ({})", nLevels));
+        }
+
+        size_t offset = 0;
+        for (int i = 0; i < nLevels; ++i) {
+            sgct::CompressedTexture::Level level;
+            level.size = sgct::ivec2{
+                std::max(size.x >> i, 1),
+                std::max(size.y >> i, 1)
+            };
+            level.offset = offset;
+            level.dataSize = sgct::levelSize(texture.format, level.size);
+            offset += level.dataSize;
+            texture.levels.push_back(level);
+        }
+        if (offset > available) {
+            fail(name, "the file is truncated");
+        }
+        texture.data.resize(offset);
+    }
+
+    // Reverses the first nRows rows of 2 bit color indices of a BC1 block
+    void flipColorBlock(unsigned char* block, int nRows) {
+        std::reverse(block + 4, block + 4 + nRows);
+    }
+
+    // Reverses the first nRows rows of 3 bit alpha indices of a BC3 block
+    void flipAlphaBlock(unsigned char* block, int nRows) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, block + 2, 6);
+        std::array<uint64_t, 4> rows;
+        for (int i = 0; i < 4; ++i) {
+            rows[i] = (bits >> (12 * i)) & 0xFFF;
+        }
+        std::reverse(rows.begin(), rows.begin() + nRows);
+        bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= rows[i] << (12 * i);
+        }
+        std::memcpy(block + 2, &bits, 6);
+    }
+
+    // Reverses the order of the pixel rows of a level by reversing the order of the rows
+    // of blocks and the rows inside of every block. This is only exact if the height is
+    // a multiple of 4 or smaller than 4, otherwise the padding rows would move into the
+    // image
+    void flipLevel(Format format, unsigned char* data, sgct::ivec2 size) {
+        const size_t nBlocksX = static_cast<size_t>((size.x + 3) / 4);
+        const size_t nBlocksY = static_cast<size_t>((size.y + 3) / 4);
+        const size_t blockBytes = sgct::blockSize(format);
+        const size_t rowBytes = nBlocksX * blockBytes;
+
+        for (size_t y = 0; y < nBlocksY / 2; ++y) {
+            std::swap_ranges(
+                data + y * rowBytes,
+                data + (y + 1) * rowBytes,
+                data + (nBlocksY - 1 - y) * rowBytes
+            );
+        }
+
+        const int nRows = std::min(size.y, 4);
+        for (size_t i = 0; i < nBlocksX * nBlocksY; ++i) {
+            unsigned char* block = data + i * blockBytes;
+            if (format == Format::BC3) {
+                flipAlphaBlock(block, nRows);
+                flipColorBlock(block + 8, nRows);
+            }
+            else {
+                flipColorBlock(block, nRows);
+            }
+        }
+    }
+
+    // Converts a texture whose rows are stored from top to bottom into the bottom to top
+    // order or vice versa. If that is not possible without recompressing the blocks, the
+    // data is left unchanged and false is returned
+    bool flipTexture(Format format,
+                     const std::vector<sgct::CompressedTexture::Level>& levels,
+                     unsigned char* data)
+    {
+        // The partitions and the modes of BC7 blocks depend on the pixel positions
+        if (format == Format::BC7) {
+            return false;
+        }
+        const bool hasPadding = std::any_of(
+            levels.begin(),
+            levels.end(),
+            [](const sgct::CompressedTexture::Level& level) {
+                return level.size.y > 4 && level.size.y % 4 != 0;
+            }
+        );
+        if (hasPadding) {
+            return false;
+        }
+
+        for (const sgct::CompressedTexture::Level& level : levels) {
+            flipLevel(format, data + level.offset, level.size);
+        }
+        return true;
+    }
+
+    // Finds the value of the key in the key/value data of a KTX or KTX2 file
+    std::string keyValue(const unsigned char* data, size_t size, const std::string& key) {
+        size_t pos = 0;
+        while (pos + sizeof(uint32_t) <= size) {
+            const size_t length = read32(data + pos);
+            pos += sizeof(uint32_t);
+            if (pos + length > size) {
+                break;
+            }
+
+            const std::string entry(reinterpret_cast<const char*>(data + pos), length);
+            const size_t nul = entry.find('\0');
+            if (nul != std::string::npos && entry.substr(0, nul) == key) {
+                std::string value = entry.substr(nul + 1);
+                value.erase(std::find(value.begin(), value.end(), '\0'), value.end());
+                return value;
+            }
+            pos += (length + 3) & ~size_t(3);
+        }
+        return "";
+    }
+
+    sgct::CompressedTexture readDDS(const unsigned char* data, size_t size,
+                                    const std::string& name)
+    {
+        if (size < DDSHeaderSize) {
+            fail(name, "the file is truncated");
+        }
+
+        const unsigned char* header = data + 4;
+        const uint32_t flags = read32(header + 4);
+        const uint32_t height = read32(header + 8);
+        const uint32_t width = read32(header + 12);
+        const uint32_t mipCount = read32(header + 24);
+        const uint32_t pixelFlags = read32(header + 76);
+        const uint32_t code = read32(header + 80);
+        const uint32_t caps2 = read32(header + 108);
+
+        if (caps2 & (DDSCaps2CubeMap | DDSCaps2Volume)) {
+            fail(name, "only two-dimensional textures are supported");
+        }
+        if (!(pixelFlags & DDPFFourCC)) {
+            fail(name, "only block compressed formats are supported");
+        }
+
+        sgct::CompressedTexture texture;
+        size_t offset = DDSHeaderSize;
+        if (code == fourCC('D', 'X', 'T', '1')) {
+            const bool hasAlpha = pixelFlags & DDPFAlphaPixels;
+            texture.format = hasAlpha ? Format::BC1Alpha : Format::BC1;
+        }
+        else if (code == fourCC('D', 'X', 'T', '5')) {
+            texture.format = Format::BC3;
+        }
+        else if (code == fourCC('D', 'X', '1', '0')) {
+            if (size < DDSHeaderSize + DDSDX10HeaderSize) {
+                fail(name, "the file is truncated");
+            }
+            const unsigned char* dx10 = data + DDSHeaderSize;
+            const uint32_t dxgiFormat = read32(dx10);
+            const uint32_t dimension = read32(dx10 + 4);
+            const uint32_t miscFlag = read32(dx10 + 8);
+            const uint32_t arraySize = read32(dx10 + 12);
+            if (dimension != D3D10ResourceDimensionTexture2D ||
+                (miscFlag & D3D10ResourceMiscTextureCube) || arraySize > 1)
+            {
+                fail(name, "only two-dimensional textures are supported");
+            }
+
+            switch (dxgiFormat) {
+                case 71: texture.format = Format::BC1Alpha; break;
+                case 72: texture.format = Format::BC1Alpha; texture.isSrgb = true; break;
+                case 77: texture.format = Format::BC3; break;
+                case 78: texture.format = Format::BC3; texture.isSrgb = true; break;
+                case 98: texture.format = Format::BC7; break;
+                case 99: texture.format = Format::BC7; texture.isSrgb = true; break;
+                default:
+                    fail(
+                        name,
+                        fmt::format("DXGI format {} is not supported", dxgiFormat)
+                    );
+            }
+            offset += DDSDX10HeaderSize;
+        }
+        else {
+            const std::string c(reinterpret_cast<const char*>(header + 80), 4);
+            fail(name, fmt::format("format '{}' is not supported", c));
+        }
+
+        const int nLevels =
+            (flags & DDSDMipMapCount) ? std::max(static_cast<int>(mipCount), 1) : 1;
+        createLevels(
+            texture,
+            sgct::ivec2{ static_cast<int>(width), static_cast<int>(height) },
+            nLevels,
+            size - offset,
+            name
+        );
+        std::memcpy(texture.data.data(), data + offset, texture.data.size());
+
+        // DDS files are always stored from top to bottom
+        texture.isTopDown =
+            !flipTexture(texture.format, texture.levels, texture.data.data());
+        return texture;
+    }
+
+    sgct::CompressedTexture readKTX1(const unsigned char* data, size_t size,
+                                     const std::string& name)
+    {
+        if (size < KTX1HeaderSize) {
+            fail(name, "the file is truncated");
+        }
+        if (read32(data + 12) != 0x04030201) {
+            fail(name, "files with a different endianness are not supported");
+        }
+
+        const uint32_t glType = read32(data + 16);
+        const uint32_t glInternalFormat = read32(data + 28);
+        const uint32_t width = read32(data + 36);
+        const uint32_t height = read32(data + 40);
+        const uint32_t depth = read32(data + 44);
+        const uint32_t nArrayElements = read32(data + 48);
+        const uint32_t nFaces = read32(data + 52);
+        const uint32_t nMipmapLevels = read32(data + 56);
+        const uint32_t keyValueSize = read32(data + 60);
+
+        if (glType != 0) {
+            fail(name, "only block compressed formats are supported");
+        }
+        if (depth > 1 || nArrayElements > 1 || nFaces > 1) {
+            fail(name, "only two-dimensional textures are supported");
+        }
+
+        sgct::CompressedTexture texture;
+        switch (glInternalFormat) {
+            case 0x83F0: texture.format = Format::BC1; break;
+            case 0x83F1: texture.format = Format::BC1Alpha; break;
+            case 0x83F3: texture.format = Format::BC3; break;
+            case 0x8E8C: texture.format = Format::BC7; break;
+            case 0x8C4C: texture.format = Format::BC1; texture.isSrgb = true; break;
+            case 0x8C4D: texture.format = Format::BC1Alpha; texture.isSrgb = true; break;
+            case 0x8C4F: texture.format = Format::BC3; texture.isSrgb = true; break;
+            case 0x8E8D: texture.format = Format::BC7; texture.isSrgb = true; break;
+            default:
+                fail(
+                    name,
+                    fmt::format("OpenGL format {:#x} is not supported", glInternalFormat)
+                );
+        }
+
+        if (KTX1HeaderSize + keyValueSize > size) {
+            fail(name, "the file is truncated");
+        }
+        const std::string orientation =
+            keyValue(data + KTX1HeaderSize, keyValueSize, "KTXorientation");
+
+        createLevels(
+            texture,
+            sgct::ivec2{ static_cast<int>(width), static_cast<int>(height) },
+            std::max(static_cast<int>(nMipmapLevels), 1),
+            size - (KTX1HeaderSize + keyValueSize),
+            name
+        );
+        size_t offset = KTX1HeaderSize + keyValueSize;
+        for (const sgct::CompressedTexture::Level& level : texture.levels) {
+            if (offset + sizeof(uint32_t) > size) {
+                fail(name, "the file is truncated");
+            }
+            const size_t imageSize = read32(data + offset);
+            offset += sizeof(uint32_t);
+            if (imageSize != level.dataSize) {
+                fail(name, "the size of a mipmap level does not match its format");
+            }
+            if (offset + imageSize > size) {
+                fail(name, "the file is truncated");
+            }
+            std::memcpy(texture.data.data() + level.offset, data + offset, imageSize);
+            offset += (imageSize + 3) & ~size_t(3);
+        }
+
+        // KTX files are stored in the OpenGL order unless the orientation says otherwise
+        if (orientation.find("T=d") != std::string::npos) {
+            texture.isTopDown =
+                !flipTexture(texture.format, texture.levels, texture.data.data());
+        }
+        return texture;
+    }
+
+    sgct::CompressedTexture readKTX2(const unsigned char* data, size_t size,
+                                     const std::string& name)
+    {
+        if (size < KTX2HeaderSize) {
+            fail(name, "the file is truncated");
+        }
+
+        const uint32_t vkFormat = read32(data + 12);
+        const uint32_t width = read32(data + 20);
+        const uint32_t height = read32(data + 24);
+        const uint32_t depth = read32(data + 28);
+        const uint32_t nLayers = read32(data + 32);
+        const uint32_t nFaces = read32(data + 36);
+        const uint32_t nLevels = std::max(read32(data + 40), 1u);
+        const uint32_t supercompression = read32(data + 44);
+        const uint32_t keyValueOffset = read32(data + 56);
+        const uint32_t keyValueSize = read32(data + 60);
+
+        if (supercompression != 0) {
+            fail(name, "supercompressed files are not supported");
+        }
+        if (depth > 1 || nLayers > 1 || nFaces > 1) {
+            fail(name, "only two-dimensional textures are supported");
+        }
+
+        sgct::CompressedTexture texture;
+        switch (vkFormat) {
+            case 131: texture.format = Format::BC1; break;
+            case 132: texture.format = Format::BC1; texture.isSrgb = true; break;
+            case 133: texture.format = Format::BC1Alpha; break;
+            case 134: texture.format = Format::BC1Alpha; texture.isSrgb = true; break;
+            case 137: texture.format = Format::BC3; break;
+            case 138: texture.format = Format::BC3; texture.isSrgb = true; break;
+            case 145: texture.format = Format::BC7; break;
+            case 146: texture.format = Format::BC7; texture.isSrgb = true; break;
+            default:
+                fail(name, fmt::format("Vulkan format {} is not supported", vkFormat));
+        }
+
+        if (static_cast<size_t>(keyValueOffset) + keyValueSize > size ||
+            KTX2HeaderSize + nLevels * KTX2LevelIndexSize > size)
+        {
+            fail(name, "the file is truncated");
+        }
+        const std::string orientation =
+            keyValue(data + keyValueOffset, keyValueSize, "KTXorientation");
+
+        createLevels(
+            texture,
+            sgct::ivec2{ static_cast<int>(width), static_cast<int>(height) },
+            static_cast<int>(nLevels),
+            size - KTX2HeaderSize,
+            name
+        );
+        for (size_t i = 0; i < texture.levels.size(); ++i) {
+            const unsigned char* index = data + KTX2HeaderSize + i * KTX2LevelIndexSize;
+            const uint64_t offset = read64(index);
+            const uint64_t length = read64(index + 8);
+            const sgct::CompressedTexture::Level& level = texture.levels[i];
+            if (length != level.dataSize) {
+                fail(name, "the size of a mipmap level does not match its format");
+            }
+            if (offset > size || length > size - offset) {
+                fail(name, "the file is truncated");
+            }
+            std::memcpy(texture.data.data() + level.offset, data + offset, length);
+        }
+
+        // KTX2 files are stored from top to bottom unless the orientation says otherwise
+        if (orientation.size() < 2 || orientation[1] != 'u') {
+            texture.isTopDown =
+                !flipTexture(texture.format, texture.levels, texture.data.data());
+        }
+        return texture;
+    }
+
+    struct Pixel {
+        int r = 0;
+        int g = 0;
+        int b = 0;
+        int a = 255;
+    };
+
+    uint16_t packColor(float r, float g, float b) {
+        auto quantize = [](float v, int max) {
+            return static_cast<uint16_t>(
+                std::clamp(static_cast<int>(v * max / 255.f + 0.5f), 0, max)
+            );
+        };
+        return static_cast<uint16_t>(
+            (quantize(r, 31) << 11) | (quantize(g, 63) << 5) | quantize(b, 31)
+        );
+    }
+
+    Pixel unpackColor(uint16_t c) {
+        const int r = (c >> 11) & 31;
+        const int g = (c >> 5) & 63;
+        const int b = c & 31;
+        return Pixel{ (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+
+    // Encodes the colors of the block in the 4-color mode. The endpoints are the extremes
+    // along the principal axis of the colors, moved inwards by 1/16 of their distance
+    void encodeColorBlock(const std::array<Pixel, 16>& block, unsigned char* out) {
+        float mean[3] = { 0.f, 0.f, 0.f };
+        for (const Pixel& p : block) {
+            mean[0] += p.r;
+            mean[1] += p.g;
+            mean[2] += p.b;
+        }
+        for (float& m : mean) {
+            m /= 16.f;
+        }
+
+        float cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+        for (const Pixel& p : block) {
+            const float r = p.r - mean[0];
+            const float g = p.g - mean[1];
+            const float b = p.b - mean[2];
+            cov[0] += r * r;
+            cov[1] += r * g;
+            cov[2] += r * b;
+            cov[3] += g * g;
+            cov[4] += g * b;
+            cov[5] += b * b;
+        }
+
+        // A few iterations of the power method are enough to find the principal axis
+        float axis[3] = { 1.f, 1.f, 1.f };
+        for (int i = 0; i < 4; ++i) {
+            const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            const float m = std::max({ std::abs(x), std::abs(y), std::abs(z) });
+            if (m == 0.f) {
+                break;
+            }
+            axis[0] = x / m;
+            axis[1] = y / m;
+            axis[2] = z / m;
+        }
+        const float length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+        float minT = 0.f;
+        float maxT = 0.f;
+        for (const Pixel& p : block) {
+            const float t = ((p.r - mean[0]) * axis[0] + (p.g - mean[1]) * axis[1] +
+                (p.b - mean[2]) * axis[2]) / length2;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        const float inset = (maxT - minT) / 16.f;
+        minT += inset;
+        maxT -= inset;
+
+        uint16_t c0 = packColor(
+            mean[0] + axis[0] * maxT,
+            mean[1] + axis[1] * maxT,
+            mean[2] + axis[2] * maxT
+        );
+        uint16_t c1 = packColor(
+            mean[0] + axis[0] * minT,
+            mean[1] + axis[1] * minT,
+            mean[2] + axis[2] * minT
+        );
+        // The 4-color mode is selected by the first endpoint being the larger one
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        }
+
+        uint32_t indices = 0;
+        if (c0 != c1) {
+            const Pixel p0 = unpackColor(c0);
+            const Pixel p1 = unpackColor(c1);
+            const std::array<Pixel, 4> palette = {
+                p0,
+                p1,
+                Pixel{
+                    (2 * p0.r + p1.r) / 3, (2 * p0.g + p1.g) / 3, (2 * p0.b + p1.b) / 3
+                },
+                Pixel{
+                    (p0.r + 2 * p1.r) / 3, (p0.g + 2 * p1.g) / 3, (p0.b + 2 * p1.b) / 3
+                }
+            };
+
+            for (size_t i = 0; i < block.size(); ++i) {
+                int best = 0;
+                int bestDistance = std::numeric_limits<int>::max();
+                for (int j = 0; j < 4; ++j) {
+                    const int dr = block[i].r - palette[j].r;
+                    const int dg = block[i].g - palette[j].g;
+                    const int db = block[i].b - palette[j].b;
+                    const int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance) {
+                        best = j;
+                        bestDistance = distance;
+                    }
+                }
+                indices |= static_cast<uint32_t>(best) << (2 * i);
+            }
+        }
+
+        std::memcpy(out, &c0, sizeof(uint16_t));
+        std::memcpy(out + 2, &c1, sizeof(uint16_t));
+        std::memcpy(out + 4, &indices, sizeof(uint32_t));
+    }
+
+    // Encodes the alpha values of the block in the 8-value mode between their extremes
+    void encodeAlphaBlock(const std::array<Pixel, 16>& block, unsigned char* out) {
+        int a0 = 0;
+        int a1 = 255;
+        for (const Pixel& p : block) {
+            a0 = std::max(a0, p.a);
+            a1 = std::min(a1, p.a);
+        }
+
+        uint64_t indices = 0;
+        if (a0 != a1) {
+            std::array<int, 8> palette;
+            palette[0] = a0;
+            palette[1] = a1;
+            for (int i = 2; i < 8; ++i) {
+                palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            }
+
+            for (size_t i = 0; i < block.size(); ++i) {
+                int best = 0;
+                for (int j = 1; j < 8; ++j) {
+                    if (std::abs(block[i].a - palette[j]) <
+                        std::abs(block[i].a - palette[best]))
+                    {
+                        best = j;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(a0);
+        out[1] = static_cast<unsigned char>(a1);
+        std::memcpy(out + 2, &indices, 6);
+    }
+} // namespace
+
+namespace sgct {
+
+size_t blockSize(CompressedTexture::Format format) {
+    switch (format) {
+        case CompressedTexture::Format::BC1:
+        case CompressedTexture::Format::BC1Alpha:
+            return 8;
+        case CompressedTexture::Format::BC3:
+        case CompressedTexture::Format::BC7:
+            return 16;
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+size_t levelSize(CompressedTexture::Format format, ivec2 size) {
+    const size_t nBlocksX = static_cast<size_t>((size.x + 3) / 4);
+    const size_t nBlocksY = static_cast<size_t>((size.y + 3) / 4);
+    return nBlocksX * nBlocksY * blockSize(format);
+}
+
+int numberOfMipmapLevels(ivec2 size) {
+    int res = 1;
+    int s = std::max(size.x, size.y);
+    while (s > 1) {
+        s /= 2;
+        res++;
+    }
+    return res;
+}
+
+bool isCompressedTexture(const unsigned char* data, size_t size) {
+    if (size >= sizeof(uint32_t) && read32(data) == DDSMagic) {
+        return true;
+    }
+    return size >= KTX1Id.size() &&
+        (std::equal(KTX1Id.begin(), KTX1Id.end(), data) ||
+         std::equal(KTX2Id.begin(), KTX2Id.end(), data));
+}
+
+CompressedTexture readCompressedTexture(const unsigned char* data, size_t size,
+                                        const std::string& name)
+{
+    if (size >= sizeof(uint32_t) && read32(data) == DDSMagic) {
+        return readDDS(data, size, name);
+    }
+    if (size >= KTX1Id.size() && std::equal(KTX1Id.begin(), KTX1Id.end(), data)) {
+        return readKTX1(data, size, name);
+    }
+    if (size >= KTX2Id.size() && std::equal(KTX2Id.begin(), KTX2Id.end(), data)) {
+        return readKTX2(data, size, name);
+    }
+    fail(name, "the file is not a DDS, KTX, or KTX2 file");
+}
+
+CompressedTexture loadCompressedTexture(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good()) {
+        throw Err(
+            9001, fmt::format("Could not open file '{}' for loading image", filename)
+        );
+    }
+    const std::vector<unsigned char> contents(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>()
+    );
+    return readCompressedTexture(contents.data(), contents.size(), filename);
+}
+
+std::vector<unsigned char> writeDDS(const CompressedTexture& texture) {
+    if (texture.levels.empty()) {
+        return {};
+    }
+
+    const ivec2 size = texture.levels.front().size;
+    const bool hasMipmaps = texture.levels.size() > 1;
+
+    std::vector<unsigned char> res;
+    res.reserve(DDSHeaderSize + DDSDX10HeaderSize + texture.data.size());
+    write32(res, DDSMagic);
+
+    std::array<uint32_t, 31> header = {};
+    header[0] = 124;
+    header[1] = DDSDCaps | DDSDHeight | DDSDWidth | DDSDPixelFormat | DDSDMipMapCount |
+        DDSDLinearSize;
+    header[2] = static_cast<uint32_t>(size.y);
+    header[3] = static_cast<uint32_t>(size.x);
+    header[4] = static_cast<uint32_t>(texture.levels.front().dataSize);
+    header[6] = static_cast<uint32_t>(texture.levels.size());
+    // Pixel format
+    header[18] = 32;
+    header[19] = DDPFFourCC;
+    header[20] = fourCC('D', 'X', '1', '0');
+    // Capabilities
+    header[26] = DDSCapsTexture | (hasMipmaps ? (DDSCapsComplex | DDSCapsMipMap) : 0);
+    for (uint32_t v : header) {
+        write32(res, v);
+    }
+
+    const uint32_t dxgiFormat = [](CompressedTexture::Format format, bool isSrgb) {
+        switch (format) {
+            case CompressedTexture::Format::BC1:
+            case CompressedTexture::Format::BC1Alpha:
+                return isSrgb ? 72u : 71u;
+            case CompressedTexture::Format::BC3: return isSrgb ? 78u : 77u;
+            case CompressedTexture::Format::BC7: return isSrgb ? 99u : 98u;
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }(texture.format, texture.isSrgb);
+    write32(res, dxgiFormat);
+    write32(res, D3D10ResourceDimensionTexture2D);
+    write32(res, 0);
+    write32(res, 1);
+    write32(res, 0);
+
+    // DDS files are stored from top to bottom
+    const size_t offset = res.size();
+    res.insert(res.end(), texture.data.begin(), texture.data.end());
+    if (!texture.isTopDown &&
+        !flipTexture(texture.format, texture.levels, res.data() + offset))
+    {
+        throw Err(
+            9025,
+            "The rows of the compressed texture cannot be stored from top to bottom"
+        );
+    }
+    return res;
+}
+
+std::vector<unsigned char> compressBlocks(const unsigned char* pixels, ivec2 size,
+                                          int channels, CompressedTexture::Format format)
+{
+    if (format != CompressedTexture::Format::BC1 &&
+        format != CompressedTexture::Format::BC3)
+    {
+        throw std::logic_error("Only BC1 and BC3 compression is supported");
+    }
+
+    auto pixel = [&](int x, int y) {
+        // Blocks that extend past the border of the image repeat the last pixel
+        const unsigned char* p = pixels +
+            (static_cast<size_t>(std::min(y, size.y - 1)) * size.x +
+            std::min(x, size.x - 1)) * channels;
+        switch (channels) {
+            case 1: return Pixel{ p[0], p[0], p[0], 255 };
+            case 2: return Pixel{ p[0], p[0], p[0], p[1] };
+            case 3: return Pixel{ p[2], p[1], p[0], 255 };
+            case 4: return Pixel{ p[2], p[1], p[0], p[3] };
+            default: throw std::logic_error("Unhandled case label");
+        }
+    };
+
+    const size_t blockBytes = blockSize(format);
+    std::vector<unsigned char> res(levelSize(format, size));
+    unsigned char* out = res.data();
+    for (int by = 0; by < size.y; by += 4) {
+        for (int bx = 0; bx < size.x; bx += 4) {
+            std::array<Pixel, 16> block;
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    block[y * 4 + x] = pixel(bx + x, by + y);
+                }
+            }
+
+            if (format == CompressedTexture::Format::BC3) {
+                encodeAlphaBlock(block, out);
+                encodeColorBlock(block, out + 8);
+            }
+            else {
+                encodeColorBlock(block, out);
+            }
+            out += blockBytes;
+        }
+    }
+    return res;
+}
+
+} // namespace sgct
@@ -0,0 +1,350 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/decimation.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+    using sgct::correction::CorrectionMeshVertex;
+    using sgct::correction::Grid;
+
+    // Half of an 8-bit step, so that the blending of the projectors does not change
+    constexpr const float ColorTolerance = 0.5f / 255.f;
+
+    constexpr const unsigned int Unused = std::numeric_limits<unsigned int>::max();
+
+    struct Point {
+        int x = 0;
+        int y = 0;
+    };
+
+    int64_t cross(Point a, Point b, Point c) {
+        return static_cast<int64_t>(b.x - a.x) * (c.y - a.y) -
+               static_cast<int64_t>(c.x - a.x) * (b.y - a.y);
+    }
+
+    // A rectangle of grid cells that is given by the coordinates of its corner vertices
+    struct Block {
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = 0;
+        int y1 = 0;
+        // The number of boundary vertices at the time the block was last checked
+        size_t nChecked = 0;
+
+        bool isCell() const {
+            return x1 - x0 == 1 && y1 - y0 == 1;
+        }
+
+        Point center() const {
+            return Point{ x0 + (x1 - x0) / 2, y0 + (y1 - y0) / 2 };
+        }
+    };
+
+    class GridDecimator {
+    public:
+        GridDecimator(const CorrectionMeshVertex* vertices, const Grid& grid,
+                      float maxError, sgct::ivec2 resolution)
+            : _vertices(vertices)
+            , _nCols(static_cast<int>(grid.nCols))
+            , _nRows(static_cast<int>(grid.nRows))
+            , _maxErrorS(maxError / static_cast<float>(resolution.x))
+            , _maxErrorT(maxError / static_cast<float>(resolution.y))
+            , _isActive(static_cast<size_t>(grid.nCols) * grid.nRows, false)
+        {}
+
+        void run() {
+            ZoneScoped
+
+            // Subdivide until every block is close enough to its own corners and center
+            std::vector<Block> stack = { Block{ 0, 0, _nCols - 1, _nRows - 1 } };
+            while (!stack.empty()) {
+                const Block b = stack.back();
+                stack.pop_back();
+                const std::vector<Point> corners = {
+                    { b.x0, b.y0 }, { b.x1, b.y0 }, { b.x1, b.y1 }, { b.x0, b.y1 }
+                };
+                if (b.isCell() || isWithinError(b, corners)) {
+                    _leaves.push_back(b);
+                }
+                else {
+                    split(b, stack);
+                }
+            }
+
+            // The corners of smaller neighbors add vertices to the boundary of a block,
+            // which changes its triangulation. Blocks whose boundary changed are checked
+            // again until every block is within the error
+            bool hasChanged = true;
+            std::vector<Point> boundary;
+            while (hasChanged) {
+                hasChanged = false;
+                for (const Block& b : _leaves) {
+                    markActive(b);
+                }
+
+                std::vector<Block> leaves;
+                leaves.reserve(_leaves.size());
+                for (Block& b : _leaves) {
+                    collectBoundary(b, boundary);
+                    if (boundary.size() == b.nChecked) {
+                        leaves.push_back(b);
+                    }
+                    else if (b.isCell() || isWithinError(b, boundary)) {
+                        b.nChecked = boundary.size();
+                        leaves.push_back(b);
+                    }
+                    else {
+                        split(b, leaves);
+                        hasChanged = true;
+                    }
+                }
+                _leaves = std::move(leaves);
+            }
+        }
+
+        void triangulate(std::vector<CorrectionMeshVertex>& vertices,
+                         std::vector<unsigned int>& indices) const
+        {
+            ZoneScoped
+
+            std::vector<unsigned int> remap(_isActive.size(), Unused);
+            auto index = [&](Point p) {
+                unsigned int& i = remap[static_cast<size_t>(p.y) * _nCols + p.x];
+                if (i == Unused) {
+                    i = static_cast<unsigned int>(vertices.size());
+                    vertices.push_back(vertex(p));
+                }
+                return i;
+            };
+
+            std::vector<Point> boundary;
+            for (const Block& b : _leaves) {
+                collectBoundary(b, boundary);
+                const Point c = b.center();
+                for (size_t i = 0; i < boundary.size(); ++i) {
+                    const Point p = boundary[i];
+                    const Point q = boundary[(i + 1) % boundary.size()];
+                    if (cross(c, p, q) == 0) {
+                        continue;
+                    }
+                    indices.push_back(index(c));
+                    indices.push_back(index(p));
+                    indices.push_back(index(q));
+                }
+            }
+        }
+
+    private:
+        const CorrectionMeshVertex& vertex(Point p) const {
+            return _vertices[static_cast<size_t>(p.y) * _nCols + p.x];
+        }
+
+        void split(const Block& b, std::vector<Block>& res) const {
+            // Blocks that are a single cell wide are only split along the other axis
+            const Point c = b.center();
+            const int xs[] = { b.x0, c.x == b.x0 ? b.x1 : c.x, b.x1 };
+            const int ys[] = { b.y0, c.y == b.y0 ? b.y1 : c.y, b.y1 };
+            for (int j = 0; j < 2; ++j) {
+                for (int i = 0; i < 2; ++i) {
+                    if (xs[i] < xs[i + 1] && ys[j] < ys[j + 1]) {
+                        res.push_back(Block{ xs[i], ys[j], xs[i + 1], ys[j + 1] });
+                    }
+                }
+            }
+        }
+
+        void markActive(const Block& b) {
+            auto mark = [this](int x, int y) {
+                _isActive[static_cast<size_t>(y) * _nCols + x] = true;
+            };
+            mark(b.x0, b.y0);
+            mark(b.x1, b.y0);
+            mark(b.x1, b.y1);
+            mark(b.x0, b.y1);
+            const Point c = b.center();
+            mark(c.x, c.y);
+        }
+
+        // Returns the active vertices on the boundary of the block in counter-clockwise
+        // order, starting with the corner (x0, y0)
+        void collectBoundary(const Block& b, std::vector<Point>& res) const {
+            res.clear();
+            auto add = [&](int x, int y) {
+                if (_isActive[static_cast<size_t>(y) * _nCols + x]) {
+                    res.push_back(Point{ x, y });
+                }
+            };
+            for (int x = b.x0; x < b.x1; ++x) {
+                add(x, b.y0);
+            }
+            for (int y = b.y0; y < b.y1; ++y) {
+                add(b.x1, y);
+            }
+            for (int x = b.x1; x > b.x0; --x) {
+                add(x, b.y1);
+            }
+            for (int y = b.y1; y > b.y0; --y) {
+                add(b.x0, y);
+            }
+        }
+
+        // Checks whether the triangle fan from the center of the block to its boundary
+        // reproduces all original vertices in the block
+        bool isWithinError(const Block& b, const std::vector<Point>& boundary) const {
+            const Point c = b.center();
+            for (size_t i = 0; i < boundary.size(); ++i) {
+                const Point p = boundary[i];
+                const Point q = boundary[(i + 1) % boundary.size()];
+                if (cross(c, p, q) != 0 && !isWithinError(c, p, q)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool isWithinError(Point a, Point b, Point c) const {
+            const int64_t area = cross(a, b, c);
+            const CorrectionMeshVertex& va = vertex(a);
+            const CorrectionMeshVertex& vb = vertex(b);
+            const CorrectionMeshVertex& vc = vertex(c);
+
+            // The error is measured where the original vertex is rendered, so the
+            // barycentric coordinates are computed from the projected positions
+            const double d =
+                (static_cast<double>(vb.x) - va.x) * (static_cast<double>(vc.y) - va.y) -
+                (static_cast<double>(vc.x) - va.x) * (static_cast<double>(vb.y) - va.y);
+            const bool useGrid = std::abs(d) < 1e-18;
+
+            const int minX = std::min({ a.x, b.x, c.x });
+            const int maxX = std::max({ a.x, b.x, c.x });
+            const int minY = std::min({ a.y, b.y, c.y });
+            const int maxY = std::max({ a.y, b.y, c.y });
+            for (int y = minY; y <= maxY; ++y) {
+                for (int x = minX; x <= maxX; ++x) {
+                    const Point p = { x, y };
+                    const int64_t wa = cross(b, c, p);
+                    const int64_t wb = cross(c, a, p);
+                    const int64_t wc = cross(a, b, p);
+                    const bool isInside = area > 0 ?
+                        (wa >= 0 && wb >= 0 && wc >= 0) :
+                        (wa <= 0 && wb <= 0 && wc <= 0);
+                    // The corners of the triangle are reproduced exactly
+                    if (!isInside || wa == area || wb == area || wc == area) {
+                        continue;
+                    }
+
+                    const CorrectionMeshVertex& v = vertex(p);
+                    double lb = 0.0;
+                    double lc = 0.0;
+                    if (useGrid) {
+                        lb = static_cast<double>(wb) / static_cast<double>(area);
+                        lc = static_cast<double>(wc) / static_cast<double>(area);
+                    }
+                    else {
+                        const double px = static_cast<double>(v.x) - va.x;
+                        const double py = static_cast<double>(v.y) - va.y;
+                        lb = (px * (static_cast<double>(vc.y) - va.y) -
+                              (static_cast<double>(vc.x) - va.x) * py) / d;
+                        lc = ((static_cast<double>(vb.x) - va.x) * py -
+                              px * (static_cast<double>(vb.y) - va.y)) / d;
+                    }
+                    const double la = 1.0 - lb - lc;
+                    auto interpolate = [&](float CorrectionMeshVertex::* m) {
+                        return static_cast<float>(la * va.*m + lb * vb.*m + lc * vc.*m);
+                    };
+
+                    const bool isWithin =
+                        std::abs(interpolate(&CorrectionMeshVertex::s) - v.s) <=
+                            _maxErrorS &&
+                        std::abs(interpolate(&CorrectionMeshVertex::t) - v.t) <=
+                            _maxErrorT &&
+                        std::abs(interpolate(&CorrectionMeshVertex::r) - v.r) <=
+                            ColorTolerance &&
+                        std::abs(interpolate(&CorrectionMeshVertex::g) - v.g) <=
+                            ColorTolerance &&
+                        std::abs(interpolate(&CorrectionMeshVertex::b) - v.b) <=
+                            ColorTolerance &&
+                        std::abs(interpolate(&CorrectionMeshVertex::a) - v.a) <=
+                            ColorTolerance;
+                    if (!isWithin) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        const CorrectionMeshVertex* _vertices;
+        const int _nCols;
+        const int _nRows;
+        const float _maxErrorS;
+        const float _maxErrorT;
+        std::vector<bool> _isActive;
+        std::vector<Block> _leaves;
+    };
+} // namespace
+
+namespace sgct::correction {
+
+size_t decimateMesh(Buffer& buffer, float maxError, ivec2 resolution) {
+    ZoneScoped
+
+    if (buffer.grids.empty() || maxError <= 0.f || resolution.x <= 0 ||
+        resolution.y <= 0)
+    {
+        return 0;
+    }
+
+    for (const Grid& grid : buffer.grids) {
+        const size_t n = static_cast<size_t>(grid.nCols) * grid.nRows;
+        if (grid.nCols < 2 || grid.nRows < 2 || grid.first > buffer.vertices.size() ||
+            buffer.vertices.size() - grid.first < n)
+        {
+            return 0;
+        }
+    }
+    for (unsigned int i : buffer.indices) {
+        auto contains = [i](const Grid& grid) {
+            return i >= grid.first &&
+                i - grid.first < static_cast<size_t>(grid.nCols) * grid.nRows;
+        };
+        if (std::none_of(buffer.grids.begin(), buffer.grids.end(), contains)) {
+            return 0;
+        }
+    }
+
+    std::vector<CorrectionMeshVertex> vertices;
+    std::vector<unsigned int> indices;
+    for (const Grid& grid : buffer.grids) {
+        GridDecimator decimator(
+            buffer.vertices.data() + grid.first,
+            grid,
+            maxError,
+            resolution
+        );
+        decimator.run();
+        decimator.triangulate(vertices, indices);
+    }
+
+    const size_t nRemoved = buffer.vertices.size() - vertices.size();
+    buffer.vertices = std::move(vertices);
+    buffer.indices = std::move(indices);
+    buffer.geometryType = GL_TRIANGLES;
+    buffer.grids.clear();
+    return nRemoved;
+}
+
+} // namespace sgct::correction
@@ -8,12 +8,13 @@
 
 #include <sgct/correction/domeprojection.h>
 
+#include <sgct/correction/tokenizer.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
-#include <glm/glm.hpp>
 #include <algorithm>
 
 namespace sgct::correction {
@@ -23,67 +24,69 @@ Buffer generateDomeProjectionMesh(const std::string& path, const vec2& pos,
 {
     ZoneScoped
 
-    Log::Info(fmt::format("Reading DomeProjection mesh data from '{}', path"));
+    Log::Info(fmt::format("Reading DomeProjection mesh data from '{}'", path));
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (!meshFile) {
+    MappedFile file(path);
+    if (!file.data()) {
         throw Error(
             Error::Component::DomeProjection, 2010,
             fmt::format("Failed to open '{}'", path)
         );
     }
+    Tokenizer tokenizer(reinterpret_cast<const char*>(file.data()), file.size());
 
     Buffer buf;
+    // Every line apart from the header contains one vertex
+    buf.vertices.reserve(tokenizer.countLines());
 
     unsigned int nCols = 0;
     unsigned int nRows = 0;
-    while (!feof(meshFile)) {
-        constexpr const int MaxLineLength = 1024;
-        char lineBuf[MaxLineLength];
-        if (fgets(lineBuf, MaxLineLength, meshFile)) {
-            float x;
-            float y;
-            float u;
-            float v;
-            unsigned int col;
-            unsigned int row;
-
-            if (sscanf(lineBuf, "%f;%f;%f;%f;%u;%u", &x, &y, &u, &v, &col, &row) == 6) {
-                // init to max intensity (opaque white)
-                CorrectionMeshVertex vertex;
-                vertex.r = 1.f;
-                vertex.g = 1.f;
-                vertex.b = 1.f;
-                vertex.a = 1.f;
-
-                // find dimensions of meshdata
-                nCols = std::max(nCols, col);
-                nRows = std::max(nRows, row);
-
-                x = std::clamp(x, 0.f, 1.f);
-                y = std::clamp(y, 0.f, 1.f);
-
-                // convert to [-1, 1]
-                vertex.x = 2.f * (pos.x + x * size.x) - 1.f;
-
-                // (abock, 2019-08-30); I'm not sure why the y inversion happens
-                // here. It seems like a mistake, but who knows
-                vertex.y = 2.f * (pos.y + (1.f - y) * size.y) - 1.f;
-
-                // scale to viewport coordinates
-                vertex.s = pos.x + u * size.x;
-                vertex.t = pos.y + (1.f - v) * size.y;
-
-                buf.vertices.push_back(std::move(vertex));
-            }
+    while (tokenizer.nextLine()) {
+        float x;
+        float y;
+        float u;
+        float v;
+        unsigned int col;
+        unsigned int row;
+
+        constexpr std::string_view Sep = ";";
+        if (tokenizer.nextNumber(x, Sep) && tokenizer.nextNumber(y, Sep) &&
+            tokenizer.nextNumber(u, Sep) && tokenizer.nextNumber(v, Sep) &&
+            tokenizer.nextNumber(col, Sep) && tokenizer.nextNumber(row, Sep))
+        {
+            // init to max intensity (opaque white)
+            CorrectionMeshVertex vertex;
+            vertex.r = 1.f;
+            vertex.g = 1.f;
+            vertex.b = 1.f;
+            vertex.a = 1.f;
+
+            // find dimensions of meshdata
+            nCols = std::max(nCols, col);
+            nRows = std::max(nRows, row);
+
+            x = std::clamp(x, 0.f, 1.f);
+            y = std::clamp(y, 0.f, 1.f);
+
+            // convert to [-1, 1]
+            vertex.x = 2.f * (pos.x + x * size.x) - 1.f;
+
+            // (abock, 2019-08-30); I'm not sure why the y inversion happens
+            // here. It seems like a mistake, but who knows
+            vertex.y = 2.f * (pos.y + (1.f - y) * size.y) - 1.f;
+
+            // scale to viewport coordinates
+            vertex.s = pos.x + u * size.x;
+            vertex.t = pos.y + (1.f - v) * size.y;
+
+            buf.vertices.push_back(vertex);
         }
     }
 
-    fclose(meshFile);
-
     nCols++;
     nRows++;
 
+    buf.indices.reserve(static_cast<size_t>(nCols) * nRows * 6);
     for (unsigned int c = 0; c < nCols; ++c) {
         for (unsigned int r = 0; r < nRows; ++r) {
             // 3      2
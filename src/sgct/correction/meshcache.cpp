@@ -0,0 +1,307 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/meshcache.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/mappedfile.h>
+#include <sgct/profiling.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace {
+    constexpr const std::array<char, 8> Magic = {
+        'S', 'G', 'C', 'T', 'M', 'E', 'S', 'H'
+    };
+    // Has to be increased whenever the layout of the file or the generated meshes change
+    constexpr const uint32_t Version = 3;
+
+    constexpr const uint32_t HasUserPosition = 1 << 0;
+    constexpr const uint32_t HasFieldOfView = 1 << 1;
+    constexpr const uint32_t HasProjectionPlaneOffset = 1 << 2;
+
+    // The header is followed by the vertices, the indices, and the path of the mesh
+    struct Header {
+        std::array<char, 8> magic = Magic;
+        uint32_t version = Version;
+        uint32_t geometryType = 0;
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        uint64_t sourceHash = 0;
+        uint64_t nVertices = 0;
+        uint64_t nIndices = 0;
+        uint32_t pathLength = 0;
+        uint32_t viewFlags = 0;
+        // position, size, aspect ratio, decimation error, resolution, and strip usage of
+        // the key
+        std::array<float, 9> parameters = {};
+        uint32_t reserved = 0;
+        // user position, field of view with orientation, and projection plane offset
+        std::array<float, 14> view = {};
+    };
+    static_assert(sizeof(Header) == 160, "Header must not contain padding");
+    static_assert(
+        sizeof(sgct::correction::CorrectionMeshVertex) == 8 * sizeof(float),
+        "Vertices must not contain padding"
+    );
+
+    std::string absolutePath(const std::string& path) {
+        return std::filesystem::absolute(path).lexically_normal().string();
+    }
+
+    std::array<float, 9> parameters(const sgct::correction::MeshCacheKey& key) {
+        return {
+            key.position.x, key.position.y, key.size.x, key.size.y, key.aspectRatio,
+            key.maxError,
+            static_cast<float>(key.resolution.x), static_cast<float>(key.resolution.y),
+            key.useStrips ? 1.f : 0.f
+        };
+    }
+
+    std::filesystem::path cacheFile(const std::string& directory,
+                                    const sgct::correction::MeshCacheKey& key)
+    {
+        std::string id = absolutePath(key.path);
+        const std::array<float, 9> params = parameters(key);
+        id.append(reinterpret_cast<const char*>(params.data()), sizeof(params));
+        const uint64_t hash = sgct::correction::hashMeshData(
+            reinterpret_cast<const unsigned char*>(id.data()),
+            id.size()
+        );
+        return std::filesystem::path(directory) / fmt::format("{:016x}.mesh", hash);
+    }
+
+    // Returns the size and modification time of the file or nothing if it does not exist
+    std::optional<std::pair<uint64_t, int64_t>> fileStatus(const std::string& path) {
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        const std::filesystem::file_time_type time =
+            std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        return std::pair<uint64_t, int64_t>(
+            static_cast<uint64_t>(size),
+            static_cast<int64_t>(time.time_since_epoch().count())
+        );
+    }
+} // namespace
+
+namespace sgct::correction {
+
+uint64_t hashMeshData(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::optional<Buffer> readMeshCache(const std::string& directory,
+                                    const MeshCacheKey& key)
+{
+    ZoneScoped
+
+    const std::optional<std::pair<uint64_t, int64_t>> status = fileStatus(key.path);
+    if (directory.empty() || !status) {
+        return std::nullopt;
+    }
+
+    MappedFile file(cacheFile(directory, key).string());
+    if (!file.data() || file.size() < sizeof(Header)) {
+        return std::nullopt;
+    }
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.magic != Magic || header.version != Version) {
+        return std::nullopt;
+    }
+
+    // Check the counts on their own first so that computing the size cannot overflow
+    constexpr const size_t VertexSize = sizeof(CorrectionMeshVertex);
+    constexpr const size_t IndexSize = sizeof(unsigned int);
+    if (header.nVertices > file.size() / VertexSize ||
+        header.nIndices > file.size() / IndexSize ||
+        header.pathLength > file.size())
+    {
+        return std::nullopt;
+    }
+    const size_t verticesSize = static_cast<size_t>(header.nVertices) * VertexSize;
+    const size_t indicesSize = static_cast<size_t>(header.nIndices) * IndexSize;
+    if (file.size() != sizeof(Header) + verticesSize + indicesSize + header.pathLength) {
+        return std::nullopt;
+    }
+
+    const unsigned char* vertices = file.data() + sizeof(Header);
+    const unsigned char* indices = vertices + verticesSize;
+    const char* path = reinterpret_cast<const char*>(indices + indicesSize);
+
+    // The name of the file is a hash, so the key is compared in full to rule out
+    // collisions
+    if (std::string(path, header.pathLength) != absolutePath(key.path) ||
+        header.parameters != parameters(key))
+    {
+        return std::nullopt;
+    }
+
+    if (header.sourceSize != status->first || header.sourceTime != status->second) {
+        // The file might have been copied or touched without changing its contents
+        MappedFile source(key.path);
+        if (!source.data() ||
+            hashMeshData(source.data(), source.size()) != header.sourceHash)
+        {
+            return std::nullopt;
+        }
+    }
+
+    Buffer buf;
+    buf.geometryType = header.geometryType;
+    buf.vertices.resize(header.nVertices);
+    std::memcpy(buf.vertices.data(), vertices, verticesSize);
+    buf.indices.resize(header.nIndices);
+    std::memcpy(buf.indices.data(), indices, indicesSize);
+
+    if (header.viewFlags != 0) {
+        const std::array<float, 14>& v = header.view;
+        ViewSetup view;
+        if (header.viewFlags & HasUserPosition) {
+            view.userPosition = vec3{ v[0], v[1], v[2] };
+        }
+        if (header.viewFlags & HasFieldOfView) {
+            ViewSetup::FieldOfView fov;
+            fov.up = v[3];
+            fov.down = v[4];
+            fov.left = v[5];
+            fov.right = v[6];
+            fov.orientation = quat{ v[7], v[8], v[9], v[10] };
+            view.fieldOfView = fov;
+        }
+        if (header.viewFlags & HasProjectionPlaneOffset) {
+            view.projectionPlaneOffset = vec3{ v[11], v[12], v[13] };
+        }
+        buf.viewSetup = view;
+    }
+
+    Log::Debug(fmt::format("Correction mesh for '{}' read from cache", key.path));
+    return buf;
+}
+
+void writeMeshCache(const std::string& directory, const MeshCacheKey& key,
+                    const Buffer& buffer)
+{
+    ZoneScoped
+
+    if (directory.empty()) {
+        return;
+    }
+
+    const std::optional<std::pair<uint64_t, int64_t>> status = fileStatus(key.path);
+    MappedFile source(key.path);
+    if (!status || !source.data()) {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        Log::Warning(fmt::format(
+            "Could not create correction mesh cache directory '{}': {}",
+            directory, ec.message()
+        ));
+        return;
+    }
+
+    const std::string path = absolutePath(key.path);
+
+    Header header;
+    header.geometryType = buffer.geometryType;
+    header.sourceSize = status->first;
+    header.sourceTime = status->second;
+    header.sourceHash = hashMeshData(source.data(), source.size());
+    header.nVertices = buffer.vertices.size();
+    header.nIndices = buffer.indices.size();
+    header.pathLength = static_cast<uint32_t>(path.size());
+    header.parameters = parameters(key);
+    if (buffer.viewSetup) {
+        const ViewSetup& view = *buffer.viewSetup;
+        std::array<float, 14>& v = header.view;
+        if (view.userPosition) {
+            header.viewFlags |= HasUserPosition;
+            v[0] = view.userPosition->x;
+            v[1] = view.userPosition->y;
+            v[2] = view.userPosition->z;
+        }
+        if (view.fieldOfView) {
+            header.viewFlags |= HasFieldOfView;
+            v[3] = view.fieldOfView->up;
+            v[4] = view.fieldOfView->down;
+            v[5] = view.fieldOfView->left;
+            v[6] = view.fieldOfView->right;
+            v[7] = view.fieldOfView->orientation.x;
+            v[8] = view.fieldOfView->orientation.y;
+            v[9] = view.fieldOfView->orientation.z;
+            v[10] = view.fieldOfView->orientation.w;
+        }
+        if (view.projectionPlaneOffset) {
+            header.viewFlags |= HasProjectionPlaneOffset;
+            v[11] = view.projectionPlaneOffset->x;
+            v[12] = view.projectionPlaneOffset->y;
+            v[13] = view.projectionPlaneOffset->z;
+        }
+    }
+
+    // The entry is written under a unique name and then renamed so that other nodes that
+    // share the directory never see a partially written file
+    const std::filesystem::path target = cacheFile(directory, key);
+    std::filesystem::path tmp = target;
+    tmp += fmt::format(".{:08x}.tmp", std::random_device()());
+    {
+        std::ofstream file(tmp, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(
+            reinterpret_cast<const char*>(buffer.vertices.data()),
+            buffer.vertices.size() * sizeof(CorrectionMeshVertex)
+        );
+        file.write(
+            reinterpret_cast<const char*>(buffer.indices.data()),
+            buffer.indices.size() * sizeof(unsigned int)
+        );
+        file.write(path.data(), path.size());
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            Log::Warning(fmt::format(
+                "Could not write correction mesh cache file '{}'", tmp.string()
+            ));
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmp, target, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        Log::Warning(fmt::format(
+            "Could not write correction mesh cache file '{}'", target.string()
+        ));
+        return;
+    }
+    Log::Debug(fmt::format(
+        "Correction mesh for '{}' written to cache '{}'", key.path, target.string()
+    ));
+}
+
+} // namespace sgct::correction
@@ -135,6 +135,7 @@ Buffer generateMpcdiMesh(const std::vector<char>& mpcdiMesh) {
     }
 
     buf.geometryType = GL_TRIANGLES;
+    buf.grids = { Grid{ 0, nCols, nRows } };
     return buf;
 }
 
@@ -0,0 +1,397 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/optimization.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace {
+    // The size of the modelled cache, which is larger than the cache of most GPUs so
+    // that the order also works well for them
+    constexpr const int CacheSize = 32;
+
+    constexpr const unsigned int Unused = std::numeric_limits<unsigned int>::max();
+
+    bool isValid(unsigned int a, unsigned int b, unsigned int c, size_t nVertices) {
+        return a != b && b != c && a != c && a < nVertices && b < nVertices &&
+            c < nVertices;
+    }
+
+    // Returns the triangles of the buffer with three indices each, without degenerate
+    // triangles or triangles that reference vertices that do not exist
+    std::vector<unsigned int> triangleList(const sgct::correction::Buffer& buffer) {
+        using sgct::correction::PrimitiveRestartIndex;
+
+        const std::vector<unsigned int>& idx = buffer.indices;
+        const size_t nVertices = buffer.vertices.size();
+        std::vector<unsigned int> res;
+        if (buffer.geometryType == GL_TRIANGLES) {
+            res.reserve(idx.size());
+            for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+                if (isValid(idx[i], idx[i + 1], idx[i + 2], nVertices)) {
+                    res.insert(res.end(), { idx[i], idx[i + 1], idx[i + 2] });
+                }
+            }
+        }
+        else if (buffer.geometryType == GL_TRIANGLE_STRIP) {
+            res.reserve(3 * idx.size());
+            size_t start = 0;
+            for (size_t i = 0; i < idx.size(); ++i) {
+                if (idx[i] == PrimitiveRestartIndex) {
+                    start = i + 1;
+                    continue;
+                }
+                if (i < start + 2) {
+                    continue;
+                }
+                // Every other triangle of a strip has its first two vertices swapped to
+                // keep the winding of all triangles the same
+                const bool isOdd = (i - start) % 2 == 1;
+                const unsigned int a = isOdd ? idx[i - 1] : idx[i - 2];
+                const unsigned int b = isOdd ? idx[i - 2] : idx[i - 1];
+                if (isValid(a, b, idx[i], nVertices)) {
+                    res.insert(res.end(), { a, b, idx[i] });
+                }
+            }
+        }
+        return res;
+    }
+
+    // The triangles that use each vertex, stored consecutively for all vertices
+    struct Adjacency {
+        Adjacency(const std::vector<unsigned int>& indices, size_t nVertices)
+            : offsets(nVertices + 1, 0)
+            , triangles(indices.size())
+        {
+            for (unsigned int v : indices) {
+                offsets[v + 1]++;
+            }
+            for (size_t i = 1; i < offsets.size(); ++i) {
+                offsets[i] += offsets[i - 1];
+            }
+            std::vector<unsigned int> pos(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i) {
+                triangles[pos[indices[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+        }
+
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> triangles;
+    };
+
+    class VertexCacheOptimizer {
+    public:
+        VertexCacheOptimizer(const std::vector<unsigned int>& triangles,
+                             size_t nVertices)
+            : _triangles(triangles)
+            , _adjacency(triangles, nVertices)
+            , _nRemaining(nVertices, 0)
+            , _cachePosition(nVertices, -1)
+            , _vertexScore(nVertices, 0.f)
+            , _triangleScore(triangles.size() / 3, 0.f)
+            , _isEmitted(triangles.size() / 3, false)
+        {
+            // Vertices in the cache score higher, except for the three most recent ones
+            // as the next triangle would otherwise be likely to share an edge with the
+            // previous one and produce thin strips
+            for (int i = 0; i < CacheSize; ++i) {
+                _cacheScore[i] = i < 3 ?
+                    0.75f :
+                    std::pow(1.f - (i - 3) / static_cast<float>(CacheSize - 3), 1.5f);
+            }
+            // Vertices with few remaining triangles score higher so that no isolated
+            // triangles are left behind
+            for (size_t i = 1; i < _valenceScore.size(); ++i) {
+                _valenceScore[i] = 2.f / std::sqrt(static_cast<float>(i));
+            }
+
+            for (size_t v = 0; v < nVertices; ++v) {
+                _nRemaining[v] = _adjacency.offsets[v + 1] - _adjacency.offsets[v];
+                _vertexScore[v] = score(static_cast<unsigned int>(v));
+            }
+            for (size_t t = 0; t < _triangleScore.size(); ++t) {
+                updateTriangleScore(static_cast<unsigned int>(t));
+            }
+        }
+
+        std::vector<unsigned int> run() {
+            ZoneScoped
+
+            const size_t nTriangles = _triangleScore.size();
+            std::vector<unsigned int> res;
+            res.reserve(_triangles.size());
+
+            std::vector<unsigned int> cache;
+            std::vector<unsigned int> newCache;
+            cache.reserve(CacheSize + 3);
+            newCache.reserve(CacheSize + 3);
+
+            unsigned int best = nTriangles > 0 ?
+                static_cast<unsigned int>(std::distance(
+                    _triangleScore.begin(),
+                    std::max_element(_triangleScore.begin(), _triangleScore.end())
+                )) :
+                Unused;
+            size_t cursor = 0;
+            while (best != Unused) {
+                _isEmitted[best] = true;
+                const unsigned int* tri = &_triangles[3 * static_cast<size_t>(best)];
+                res.insert(res.end(), tri, tri + 3);
+
+                // The vertices of the triangle move to the front of the cache
+                newCache.assign(tri, tri + 3);
+                for (unsigned int v : cache) {
+                    if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                        newCache.push_back(v);
+                    }
+                }
+                for (int i = 0; i < 3; ++i) {
+                    removeTriangle(tri[i], best);
+                }
+                for (size_t i = CacheSize; i < newCache.size(); ++i) {
+                    _cachePosition[newCache[i]] = -1;
+                    _vertexScore[newCache[i]] = score(newCache[i]);
+                }
+                newCache.resize(std::min<size_t>(newCache.size(), CacheSize));
+                std::swap(cache, newCache);
+                for (size_t i = 0; i < cache.size(); ++i) {
+                    _cachePosition[cache[i]] = static_cast<int>(i);
+                    _vertexScore[cache[i]] = score(cache[i]);
+                }
+
+                // Only triangles that use a vertex in the cache changed their score
+                best = Unused;
+                float bestScore = -1.f;
+                for (unsigned int v : cache) {
+                    const unsigned int* begin = adjacent(v);
+                    for (const unsigned int* t = begin; t < begin + _nRemaining[v]; ++t) {
+                        const float s = updateTriangleScore(*t);
+                        if (s > bestScore) {
+                            bestScore = s;
+                            best = *t;
+                        }
+                    }
+                }
+
+                if (best == Unused) {
+                    // Continue with the next triangle of the input if the cache does not
+                    // lead to any remaining triangle
+                    while (cursor < nTriangles && _isEmitted[cursor]) {
+                        cursor++;
+                    }
+                    if (cursor < nTriangles) {
+                        best = static_cast<unsigned int>(cursor);
+                    }
+                }
+            }
+            return res;
+        }
+
+    private:
+        unsigned int* adjacent(unsigned int v) {
+            return &_adjacency.triangles[_adjacency.offsets[v]];
+        }
+
+        // Removes the emitted triangle from the triangles remaining for the vertex
+        void removeTriangle(unsigned int v, unsigned int triangle) {
+            unsigned int* begin = adjacent(v);
+            unsigned int* end = begin + _nRemaining[v];
+            std::iter_swap(std::find(begin, end, triangle), end - 1);
+            _nRemaining[v]--;
+        }
+
+        float score(unsigned int v) const {
+            const unsigned int n = _nRemaining[v];
+            if (n == 0) {
+                return -1.f;
+            }
+            const int pos = _cachePosition[v];
+            const float cacheScore = pos >= 0 ? _cacheScore[pos] : 0.f;
+            const float valenceScore = n < _valenceScore.size() ?
+                _valenceScore[n] :
+                2.f / std::sqrt(static_cast<float>(n));
+            return cacheScore + valenceScore;
+        }
+
+        float updateTriangleScore(unsigned int t) {
+            const unsigned int* tri = &_triangles[3 * static_cast<size_t>(t)];
+            _triangleScore[t] =
+                _vertexScore[tri[0]] + _vertexScore[tri[1]] + _vertexScore[tri[2]];
+            return _triangleScore[t];
+        }
+
+        const std::vector<unsigned int>& _triangles;
+        Adjacency _adjacency;
+        std::vector<unsigned int> _nRemaining;
+        std::vector<int> _cachePosition;
+        std::vector<float> _vertexScore;
+        std::vector<float> _triangleScore;
+        std::vector<bool> _isEmitted;
+        std::array<float, CacheSize> _cacheScore = {};
+        std::array<float, 64> _valenceScore = {};
+    };
+
+    // Joins the triangles into strips separated by restart indices. Each strip is started
+    // with the next remaining triangle in the given order and continued with the
+    // neighbor across its last edge for as long as there is one. Only neighbors that are
+    // among the next remaining triangles are used, as following the neighbors across the
+    // whole mesh would undo the vertex cache optimization
+    std::vector<unsigned int> createStrips(const std::vector<unsigned int>& triangles,
+                                           size_t nVertices)
+    {
+        ZoneScoped
+
+        using sgct::correction::PrimitiveRestartIndex;
+
+        constexpr const size_t Window = 16;
+
+        Adjacency adjacency(triangles, nVertices);
+        std::vector<bool> isEmitted(triangles.size() / 3, false);
+        // The first triangle that has not been emitted yet
+        size_t cursor = 0;
+        auto advance = [&]() {
+            while (cursor < isEmitted.size() && isEmitted[cursor]) {
+                cursor++;
+            }
+        };
+
+        // Returns the third vertex of a remaining triangle that contains the edge from a
+        // to b in its winding order, or Unused if there is none
+        auto next = [&](unsigned int a, unsigned int b, bool emit) {
+            const unsigned int* begin = &adjacency.triangles[adjacency.offsets[a]];
+            const unsigned int* end = &adjacency.triangles[0] + adjacency.offsets[a + 1];
+            for (const unsigned int* t = begin; t < end; ++t) {
+                if (isEmitted[*t] || *t >= cursor + Window) {
+                    continue;
+                }
+                const unsigned int* tri = &triangles[3 * static_cast<size_t>(*t)];
+                for (int i = 0; i < 3; ++i) {
+                    if (tri[i] == a && tri[(i + 1) % 3] == b) {
+                        if (emit) {
+                            isEmitted[*t] = true;
+                        }
+                        return tri[(i + 2) % 3];
+                    }
+                }
+            }
+            return Unused;
+        };
+
+        std::vector<unsigned int> res;
+        res.reserve(triangles.size());
+        advance();
+        while (cursor < isEmitted.size()) {
+            const size_t t = cursor;
+            isEmitted[t] = true;
+            advance();
+
+            // Start with a rotation of the triangle that has a neighbor to continue with
+            const unsigned int* tri = &triangles[3 * t];
+            int first = 0;
+            for (int i = 0; i < 3; ++i) {
+                if (next(tri[(i + 2) % 3], tri[(i + 1) % 3], false) != Unused) {
+                    first = i;
+                    break;
+                }
+            }
+            if (!res.empty()) {
+                res.push_back(PrimitiveRestartIndex);
+            }
+            const size_t start = res.size();
+            res.push_back(tri[first]);
+            res.push_back(tri[(first + 1) % 3]);
+            res.push_back(tri[(first + 2) % 3]);
+
+            while (true) {
+                const size_t n = res.size();
+                const bool isOdd = (n - 2 - start) % 2 == 1;
+                const unsigned int a = isOdd ? res[n - 1] : res[n - 2];
+                const unsigned int b = isOdd ? res[n - 2] : res[n - 1];
+                const unsigned int c = next(a, b, true);
+                if (c == Unused) {
+                    break;
+                }
+                res.push_back(c);
+                advance();
+            }
+        }
+        return res;
+    }
+} // namespace
+
+namespace sgct::correction {
+
+void optimizeMesh(Buffer& buffer, bool useStrips) {
+    ZoneScoped
+
+    const unsigned int type = buffer.geometryType;
+    if (type != GL_TRIANGLES && type != GL_TRIANGLE_STRIP) {
+        return;
+    }
+
+    const std::vector<unsigned int> triangles = triangleList(buffer);
+    std::vector<unsigned int> indices =
+        VertexCacheOptimizer(triangles, buffer.vertices.size()).run();
+
+    // Store the vertices in the order in which they are used
+    std::vector<unsigned int> remap(buffer.vertices.size(), Unused);
+    std::vector<CorrectionMeshVertex> vertices;
+    vertices.reserve(buffer.vertices.size());
+    for (unsigned int& i : indices) {
+        if (remap[i] == Unused) {
+            remap[i] = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(buffer.vertices[i]);
+        }
+        i = remap[i];
+    }
+
+    buffer.geometryType = GL_TRIANGLES;
+    if (useStrips) {
+        std::vector<unsigned int> strips = createStrips(indices, vertices.size());
+        if (strips.size() < indices.size()) {
+            indices = std::move(strips);
+            buffer.geometryType = GL_TRIANGLE_STRIP;
+        }
+    }
+
+    buffer.vertices = std::move(vertices);
+    buffer.indices = std::move(indices);
+    // The vertices are no longer stored row by row
+    buffer.grids.clear();
+}
+
+float averageCacheMissRatio(const Buffer& buffer, int cacheSize) {
+    const size_t nTriangles = triangleList(buffer).size() / 3;
+    if (nTriangles == 0 || cacheSize <= 0) {
+        return 0.f;
+    }
+
+    std::vector<unsigned int> cache(cacheSize, Unused);
+    size_t next = 0;
+    size_t nMisses = 0;
+    for (unsigned int i : buffer.indices) {
+        if (i == PrimitiveRestartIndex) {
+            continue;
+        }
+        if (std::find(cache.begin(), cache.end(), i) == cache.end()) {
+            cache[next] = i;
+            next = (next + 1) % cache.size();
+            nMisses++;
+        }
+    }
+    return static_cast<float>(nMisses) / static_cast<float>(nTriangles);
+}
+
+} // namespace sgct::correction
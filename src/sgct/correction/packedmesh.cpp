@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/packedmesh.h>
+
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+    using sgct::correction::CorrectionMeshVertex;
+
+    bool isWithin(float v, float min, float max) {
+        // Also rejects NaN
+        return v >= min && v <= max;
+    }
+
+    int16_t toSnorm16(float v) {
+        return static_cast<int16_t>(std::lround(v * 32767.f));
+    }
+
+    uint16_t toUnorm16(float v) {
+        return static_cast<uint16_t>(std::lround(v * 65535.f));
+    }
+
+    uint8_t toUnorm8(float v) {
+        return static_cast<uint8_t>(std::lround(v * 255.f));
+    }
+
+    template <typename T>
+    unsigned char* append(unsigned char* dst, const T& value) {
+        std::memcpy(dst, &value, sizeof(T));
+        return dst + sizeof(T);
+    }
+} // namespace
+
+namespace sgct::correction {
+
+PackedMesh packMesh(const Buffer& buffer) {
+    ZoneScoped
+
+    using PositionFormat = PackedMesh::PositionFormat;
+    using ColorFormat = PackedMesh::ColorFormat;
+
+    PackedMesh res;
+
+    bool canNormalizePositions = true;
+    bool isColorConstant = true;
+    bool canNormalizeColors = true;
+    for (const CorrectionMeshVertex& v : buffer.vertices) {
+        canNormalizePositions &= isWithin(v.x, -1.f, 1.f) && isWithin(v.y, -1.f, 1.f) &&
+            isWithin(v.s, 0.f, 1.f) && isWithin(v.t, 0.f, 1.f);
+        const CorrectionMeshVertex& first = buffer.vertices.front();
+        isColorConstant &= v.r == first.r && v.g == first.g && v.b == first.b &&
+            v.a == first.a;
+        canNormalizeColors &= isWithin(v.r, 0.f, 1.f) && isWithin(v.g, 0.f, 1.f) &&
+            isWithin(v.b, 0.f, 1.f) && isWithin(v.a, 0.f, 1.f);
+    }
+
+    if (canNormalizePositions) {
+        res.positionFormat = PositionFormat::Normalized16;
+        res.texCoordOffset = 2 * sizeof(int16_t);
+        res.colorOffset = 4 * sizeof(int16_t);
+    }
+    else {
+        res.positionFormat = PositionFormat::Float;
+        res.texCoordOffset = 2 * sizeof(float);
+        res.colorOffset = 4 * sizeof(float);
+    }
+
+    if (isColorConstant) {
+        res.colorFormat = ColorFormat::Constant;
+        if (!buffer.vertices.empty()) {
+            const CorrectionMeshVertex& v = buffer.vertices.front();
+            res.constantColor = vec4{ v.r, v.g, v.b, v.a };
+        }
+        res.vertexSize = res.colorOffset;
+    }
+    else if (canNormalizeColors) {
+        res.colorFormat = ColorFormat::Normalized8;
+        res.vertexSize = res.colorOffset + 4 * sizeof(uint8_t);
+    }
+    else {
+        res.colorFormat = ColorFormat::Float;
+        res.vertexSize = res.colorOffset + 4 * sizeof(float);
+    }
+
+    res.vertices.resize(buffer.vertices.size() * res.vertexSize);
+    unsigned char* dst = res.vertices.data();
+    for (const CorrectionMeshVertex& v : buffer.vertices) {
+        if (res.positionFormat == PositionFormat::Normalized16) {
+            dst = append(dst, toSnorm16(v.x));
+            dst = append(dst, toSnorm16(v.y));
+            dst = append(dst, toUnorm16(v.s));
+            dst = append(dst, toUnorm16(v.t));
+        }
+        else {
+            dst = append(dst, v.x);
+            dst = append(dst, v.y);
+            dst = append(dst, v.s);
+            dst = append(dst, v.t);
+        }
+
+        if (res.colorFormat == ColorFormat::Normalized8) {
+            dst = append(dst, toUnorm8(v.r));
+            dst = append(dst, toUnorm8(v.g));
+            dst = append(dst, toUnorm8(v.b));
+            dst = append(dst, toUnorm8(v.a));
+        }
+        else if (res.colorFormat == ColorFormat::Float) {
+            dst = append(dst, v.r);
+            dst = append(dst, v.g);
+            dst = append(dst, v.b);
+            dst = append(dst, v.a);
+        }
+    }
+
+    constexpr const uint16_t RestartIndex16 = std::numeric_limits<uint16_t>::max();
+    unsigned int maxIndex = 0;
+    for (unsigned int i : buffer.indices) {
+        if (i == PrimitiveRestartIndex) {
+            res.hasPrimitiveRestart = true;
+        }
+        else {
+            maxIndex = std::max(maxIndex, i);
+        }
+    }
+    // The restart index has to remain distinct from all vertex indices
+    res.has16BitIndices = res.hasPrimitiveRestart ?
+        maxIndex < RestartIndex16 :
+        maxIndex <= RestartIndex16;
+    if (res.has16BitIndices) {
+        res.indices.resize(buffer.indices.size() * sizeof(uint16_t));
+        unsigned char* idx = res.indices.data();
+        for (unsigned int i : buffer.indices) {
+            const uint16_t v =
+                i == PrimitiveRestartIndex ? RestartIndex16 : static_cast<uint16_t>(i);
+            idx = append(idx, v);
+        }
+    }
+    else {
+        res.indices.resize(buffer.indices.size() * sizeof(unsigned int));
+        std::memcpy(res.indices.data(), buffer.indices.data(), res.indices.size());
+    }
+
+    return res;
+}
+
+} // namespace sgct::correction
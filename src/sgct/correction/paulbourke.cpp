@@ -8,14 +8,14 @@
 
 #include <sgct/correction/paulbourke.h>
 
-#include <sgct/engine.h>
+#include <sgct/correction/tokenizer.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
-#include <sgct/window.h>
-#include <glm/glm.hpp>
+#include <optional>
 
 namespace sgct::correction {
 
@@ -28,44 +28,37 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
 
     Log::Info(fmt::format("Reading Paul Bourke spherical mirror mesh from '{}'", path));
 
-    FILE* meshFile = fopen(path.c_str(), "r");
-    if (meshFile == nullptr) {
+    MappedFile file(path);
+    if (!file.data()) {
         throw Error(
             Error::Component::PaulBourke, 2040,
             fmt::format("Failed to open '{}'", path)
         );
     }
-
-    constexpr const int MaxLineLength = 1024;
-    char lineBuffer[MaxLineLength];
+    Tokenizer tokenizer(reinterpret_cast<const char*>(file.data()), file.size());
 
     // get the fist line containing the mapping type _id
     int mappingType = -1;
-    if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-        int r = sscanf(lineBuffer, "%d", &mappingType);
-        if (r != 1) {
-            fclose(meshFile);
-            throw Error(
-                Error::Component::PaulBourke, 2041,
-                fmt::format("Error reading mapping type in file '{}'", path)
-            );
-        }
+    if (tokenizer.nextLine() && !tokenizer.nextNumber(mappingType)) {
+        throw Error(
+            Error::Component::PaulBourke, 2041,
+            fmt::format("Error reading mapping type in file '{}'", path)
+        );
     }
 
     // get the mesh dimensions
-    std::optional<glm::ivec2> meshSize;
-    if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-        glm::ivec2 val;
-        if (sscanf(lineBuffer, "%d %d", &val[0], &val[1]) == 2) {
-            const size_t s = static_cast<size_t>(val.x) * static_cast<size_t>(val.y);
-            buf.vertices.reserve(s);
-            meshSize = std::move(val);
+    std::optional<ivec2> meshSize;
+    if (tokenizer.nextLine()) {
+        ivec2 val;
+        if (tokenizer.nextNumber(val.x) && tokenizer.nextNumber(val.y) &&
+            val.x > 0 && val.y > 0)
+        {
+            meshSize = val;
         }
     }
 
     // check if everyting useful is set
     if (mappingType == -1 || !meshSize.has_value()) {
-        fclose(meshFile);
         throw Error(
             Error::Component::PaulBourke, 2042,
             fmt::format("Invalid data in file '{}'", path)
@@ -73,27 +66,24 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
     }
 
     // get all data
-    float x, y, s, t, intensity;
-    while (!feof(meshFile)) {
-        if (fgets(lineBuffer, MaxLineLength, meshFile)) {
-            if (sscanf(lineBuffer, "%f %f %f %f %f", &x, &y, &s, &t, &intensity) == 5) {
-                CorrectionMeshVertex vertex;
-                vertex.x = x;
-                vertex.y = y;
-                vertex.s = s;
-                vertex.t = t;
-
-                vertex.r = intensity;
-                vertex.g = intensity;
-                vertex.b = intensity;
-                vertex.a = 1.f;
-
-                buf.vertices.push_back(vertex);
-            }
+    buf.vertices.reserve(static_cast<size_t>(meshSize->x) * meshSize->y);
+    while (tokenizer.nextLine()) {
+        CorrectionMeshVertex vertex;
+        float intensity = 0.f;
+        if (tokenizer.nextNumber(vertex.x) && tokenizer.nextNumber(vertex.y) &&
+            tokenizer.nextNumber(vertex.s) && tokenizer.nextNumber(vertex.t) &&
+            tokenizer.nextNumber(intensity))
+        {
+            vertex.r = intensity;
+            vertex.g = intensity;
+            vertex.b = intensity;
+            vertex.a = 1.f;
+            buf.vertices.push_back(vertex);
         }
     }
 
     // generate indices
+    buf.indices.reserve(static_cast<size_t>(meshSize->x - 1) * (meshSize->y - 1) * 6);
     for (int c = 0; c < (meshSize->x - 1); c++) {
         for (int r = 0; r < (meshSize->y - 1); r++) {
             const int i0 = r * meshSize->x + c;
@@ -130,6 +120,13 @@ Buffer generatePaulBourkeMesh(const std::string& path, const vec2& pos, const ve
     }
 
     buf.geometryType = GL_TRIANGLES;
+    // Lines that could not be parsed are skipped, so the vertices only form a grid if
+    // all of them were read
+    const unsigned int nCols = static_cast<unsigned int>(meshSize->x);
+    const unsigned int nRows = static_cast<unsigned int>(meshSize->y);
+    if (buf.vertices.size() == static_cast<size_t>(nCols) * nRows) {
+        buf.grids = { Grid{ 0, nCols, nRows } };
+    }
     return buf;
 }
 
@@ -8,12 +8,25 @@
 
 #include <sgct/correction/pfm.h>
 
+#include <sgct/correction/tokenizer.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
+#include <sgct/pixelconversion.h>
 #include <sgct/profiling.h>
-#include <glm/glm.hpp>
+#include <cstring>
+#include <vector>
+
+namespace {
+    bool isLittleEndian() {
+        const uint32_t value = 1;
+        unsigned char first;
+        std::memcpy(&first, &value, 1);
+        return first == 1;
+    }
+} // namespace
 
 namespace sgct::correction {
 
@@ -26,89 +39,79 @@ Buffer generatePerEyeMeshFromPFMImage(const std::string& path, const vec2& pos,
 
     Log::Info(fmt::format("Reading 3D/stereo mesh data (in PFM image) from '{}'", path));
 
-    FILE* meshFile = fopen(path.c_str(), "rb");
-    if (meshFile == nullptr) {
+    MappedFile file(path);
+    if (!file.data()) {
         throw Error(
             Error::Component::Pfm, 2050,
             fmt::format("Failed to open '{}'", path)
         );
     }
 
-    constexpr const int MaxLineLength = 1024;
-    char headerBuffer[MaxLineLength];
-    int index = 0;
-    int nNewlines = 0;
-    constexpr const int read3lines = 3;
-    do {
-        char headerChar;
-        size_t retval = fread(&headerChar, sizeof(char), 1, meshFile);
-        if (retval != 1) {
-            fclose(meshFile);
+    // The header consists of three lines with the type, the dimensions, and the scale,
+    // which is followed by the binary image data
+    const char* data = reinterpret_cast<const char*>(file.data());
+    size_t headerSize = 0;
+    for (int i = 0; i < 3; ++i) {
+        const void* eol = std::memchr(data + headerSize, '\n', file.size() - headerSize);
+        if (!eol) {
             throw Error(
                 Error::Component::Pfm, 2051,
                 fmt::format("Error reading from file '{}'", path)
             );
         }
-        headerBuffer[index++] = headerChar;
-        if (headerChar == '\n') {
-            nNewlines++;
-        }
-    } while (nNewlines < read3lines);
+        headerSize = static_cast<size_t>(reinterpret_cast<const char*>(eol) - data) + 1;
+    }
 
-    char fileFormatHeader[2];
+    Tokenizer header(data, headerSize);
+    header.nextLine();
+    const std::string_view fileFormatHeader = header.nextToken();
     unsigned int nCols = 0;
     unsigned int nRows = 0;
     float endiannessIndicator = 0;
-
-    const int scanRes = sscanf(
-        headerBuffer,
-        "%2c %u %u %f",
-        fileFormatHeader,
-        &nCols,
-        &nRows,
-        &endiannessIndicator
-    );
-    if (scanRes != 4) {
-        fclose(meshFile);
+    header.nextLine();
+    const bool hasSize = header.nextNumber(nCols) && header.nextNumber(nRows);
+    header.nextLine();
+    if (!hasSize || !header.nextNumber(endiannessIndicator) || nCols < 2 || nRows < 2) {
         throw Error(
             Error::Component::Pfm, 2052,
             fmt::format("Invalid header syntax in file '{}'", path)
         );
     }
 
-    if (fileFormatHeader[0] != 'P' || fileFormatHeader[1] != 'F') {
+    if (fileFormatHeader != "PF") {
         throw Error(
             Error::Component::Pfm, 2053,
             fmt::format("Incorrect file type in file '{}'", path)
         );
     }
 
-    const int numCorrectionValues = nCols * nRows;
-    float* xcorrections = new float[numCorrectionValues];
-    float* ycorrections = new float[numCorrectionValues];
-    const int value32bit = 4;
-
-    for (int i = 0; i < numCorrectionValues; ++i) {
-        size_t r0 = fread(xcorrections + i, value32bit, 1, meshFile);
-        size_t r1 = fread(ycorrections + i, value32bit, 1, meshFile);
-        float dumpValue;
-        size_t r2 = fread(&dumpValue, value32bit, 1, meshFile);
-
-        if (r0 != 1 || r1 != 1 || r2 != 1) {
-            throw Error(
-                Error::Component::Pfm, 2054,
-                fmt::format("Error reading correction values in file '{}'")
-            );
-        }
+    // Each pixel contains the x and y corrections and an unused third value. A negative
+    // scale denotes little-endian values, a positive one big-endian values
+    const size_t numCorrectionValues = static_cast<size_t>(nCols) * nRows;
+    if ((file.size() - headerSize) / (3 * sizeof(float)) < numCorrectionValues) {
+        throw Error(
+            Error::Component::Pfm, 2054,
+            fmt::format("Error reading correction values in file '{}'", path)
+        );
     }
-
-    fclose(meshFile);
+    const bool isFileLittleEndian = endiannessIndicator < 0.f;
+    std::vector<float> xcorrections(numCorrectionValues);
+    std::vector<float> ycorrections(numCorrectionValues);
+    deinterleaveRG32F(
+        xcorrections.data(),
+        ycorrections.data(),
+        file.data() + headerSize,
+        numCorrectionValues,
+        isFileLittleEndian != isLittleEndian()
+    );
 
     nCols /= 2;
 
     // Images are stored with X 0-1 (left to right), but Y 1 to 0 (top-bottom)
 
     // We assume we loaded side-by-side images, i.e. different warp per eye
+    buf.vertices.reserve(numCorrectionValues);
+    buf.indices.reserve(2 * (static_cast<size_t>(nRows) - 1) * nCols * 2);
     for (size_t e = 0; e < 2; e++) {
         CorrectionMeshVertex vertex;
         vertex.r = 1.f;
@@ -168,6 +171,9 @@ Buffer generatePerEyeMeshFromPFMImage(const std::string& path, const vec2& pos,
     }
 
     buf.geometryType = GL_TRIANGLE_STRIP;
+    // The indices of both eyes refer to the vertices of the first eye, so the vertices of
+    // the second eye are not part of the mesh
+    buf.grids = { Grid{ 0, nCols, nRows } };
     return buf;
 }
 
@@ -8,16 +8,16 @@
 
 #include <sgct/correction/sciss.h>
 
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #include <sgct/viewport.h>
-#include <sgct/user.h>
 #include <glm/glm.hpp>
 #include <glm/gtx/euler_angles.hpp>
+#include <cstring>
 
 #define Error(code, msg) sgct::Error(sgct::Error::Component::SCISS, code, msg)
 
@@ -52,32 +52,40 @@ namespace {
 
 namespace sgct::correction {
 
-Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
+Buffer generateScissMesh(const std::string& path, const BaseViewport& parent) {
     ZoneScoped
 
     Buffer buf;
 
     Log::Info(fmt::format("Reading SCISS mesh data from '{}'", path));
 
-    FILE* file = fopen(path.c_str(), "rb");
-    if (file == nullptr) {
+    // The whole file is mapped into memory and read with a cursor; the vertices and
+    // indices are copied in bulk from the mapping
+    MappedFile file(path);
+    if (!file.data()) {
         throw Error(2070, fmt::format("Failed to open '{}'", path));
     }
+    size_t offset = 0;
+    auto read = [&file, &offset](void* dst, size_t n) {
+        if (file.size() - offset < n) {
+            return false;
+        }
+        std::memcpy(dst, file.data() + offset, n);
+        offset += n;
+        return true;
+    };
 
     char fileID[3];
-    const size_t retHeader = fread(fileID, sizeof(char), 3, file);
+    const bool retHeader = read(fileID, sizeof(fileID));
 
     // check fileID
-    if (fileID[0] != 'S' || fileID[1] != 'G' || fileID[2] != 'C' || retHeader != 3) {
-        fclose(file);
+    if (!retHeader || fileID[0] != 'S' || fileID[1] != 'G' || fileID[2] != 'C') {
         throw Error(2071, fmt::format("Incorrect file id in file '{}'", path));
     }
 
     // read file version
     uint8_t fileVersion;
-    const size_t retVer = fread(&fileVersion, sizeof(uint8_t), 1, file);
-    if (retVer != 1) {
-        fclose(file);
+    if (!read(&fileVersion, sizeof(uint8_t))) {
         throw Error(2072, fmt::format("Error parsing file version from file '{}'", path));
     }
 
@@ -85,9 +93,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
 
     // read mapping type
     unsigned int type;
-    const size_t retType = fread(&type, sizeof(unsigned int), 1, file);
-    if (retType != 1) {
-        fclose(file);
+    if (!read(&type, sizeof(unsigned int))) {
         throw Error(2073, fmt::format("Error parsing type from file '{}'", path));
     }
 
@@ -97,9 +103,7 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
 
     // read viewdata
     SCISSViewData viewData;
-    const size_t retData = fread(&viewData, sizeof(SCISSViewData), 1, file);
-    if (retData != 1) {
-        fclose(file);
+    if (!read(&viewData, sizeof(SCISSViewData))) {
         throw Error(2074, fmt::format("Error parsing view data from file '{}'", path));
     }
 
@@ -129,86 +133,75 @@ Buffer generateScissMesh(const std::string& path, BaseViewport& parent) {
 
     // read number of vertices
     unsigned int size[2];
-    const size_t retSize = fread(size, sizeof(unsigned int), 2, file);
-    if (retSize != 2) {
-        fclose(file);
+    if (!read(size, sizeof(size))) {
         throw Error(2075, fmt::format("Error parsing file '{}'", path));
     }
 
-    unsigned int nVertices = 0;
+    size_t nVertices = 0;
     if (fileVersion == 2) {
         nVertices = size[1];
         Log::Debug(fmt::format("Number of vertices: {}", nVertices));
     }
     else {
-        nVertices = size[0] * size[1];
+        nVertices = static_cast<size_t>(size[0]) * size[1];
         Log::Debug(fmt::format(
             "Number of vertices: {} ({}x{})", nVertices, size[0], size[1]
         ));
     }
-    // read vertices
-    std::vector<SCISSTexturedVertex> texturedVertexList(nVertices);
-    const size_t retVertices = fread(
-        texturedVertexList.data(),
-        sizeof(SCISSTexturedVertex),
-        nVertices,
-        file
-    );
-    if (retVertices != nVertices) {
-        fclose(file);
+
+    // The vertices are converted straight from the mapping further down
+    constexpr const size_t VertexSize = sizeof(SCISSTexturedVertex);
+    if ((file.size() - offset) / VertexSize < nVertices) {
         throw Error(2076, fmt::format("Error parsing vertices from file '{}'", path));
     }
+    const unsigned char* texturedVertices = file.data() + offset;
+    offset += nVertices * VertexSize;
 
     // read number of indices
     unsigned int nIndices = 0;
-    const size_t retIndices = fread(&nIndices, sizeof(unsigned int), 1, file);
-    if (retIndices != 1) {
-        fclose(file);
+    if (!read(&nIndices, sizeof(unsigned int))) {
         throw Error(2077, fmt::format("Error parsing indices from file '{}'", path));
     }
     Log::Debug(fmt::format("Number of indices: {}", nIndices));
 
     // read faces
     if (nIndices > 0) {
-        buf.indices.resize(nIndices);
-        const size_t r = fread(buf.indices.data(), sizeof(unsigned int), nIndices, file);
-        if (r != nIndices) {
-            fclose(file);
+        if ((file.size() - offset) / sizeof(unsigned int) < nIndices) {
             throw Error(2078, fmt::format("Error parsing faces from file '{}'", path));
         }
+        buf.indices.resize(nIndices);
+        read(buf.indices.data(), nIndices * sizeof(unsigned int));
     }
 
-    fclose(file);
-
-    parent.user().setPos(vec3{ viewData.x, viewData.y, viewData.z });
-    parent.setViewPlaneCoordsUsingFOVs(
-        viewData.fovUp,
-        viewData.fovDown,
-        viewData.fovLeft,
-        viewData.fovRight,
-        quat{ viewData.qx, viewData.qy, viewData.qz, viewData.qw }
-    );
-
-    Engine::instance().updateFrustums();
-
+    ViewSetup view;
+    view.userPosition = vec3{ viewData.x, viewData.y, viewData.z };
+    ViewSetup::FieldOfView fov;
+    fov.up = viewData.fovUp;
+    fov.down = viewData.fovDown;
+    fov.left = viewData.fovLeft;
+    fov.right = viewData.fovRight;
+    fov.orientation = quat{ viewData.qx, viewData.qy, viewData.qz, viewData.qw };
+    view.fieldOfView = fov;
+    buf.viewSetup = view;
+
+    const vec2& s = parent.size();
+    const vec2& p = parent.position();
     buf.vertices.resize(nVertices);
-    for (unsigned int i = 0; i < nVertices; i++) {
-        SCISSTexturedVertex& scissVertex = texturedVertexList[i];
+    for (size_t i = 0; i < nVertices; i++) {
+        SCISSTexturedVertex scissVertex;
+        std::memcpy(&scissVertex, texturedVertices + i * VertexSize, VertexSize);
         scissVertex.x = glm::clamp(scissVertex.x, 0.f, 1.f);
         scissVertex.y = glm::clamp(scissVertex.y, 0.f, 1.f);
         scissVertex.tx = glm::clamp(scissVertex.tx, 0.f, 1.f);
         scissVertex.ty = glm::clamp(scissVertex.ty, 0.f, 1.f);
 
-        const vec2& s = parent.size();
-        const vec2& p = parent.position();
-
         // convert to [-1, 1]
         CorrectionMeshVertex& vertex = buf.vertices[i];
         vertex.x = 2.f * (scissVertex.x * s.x + p.x) - 1.f;
         vertex.y = 2.f * ((1.f - scissVertex.y) * s.y + p.y) - 1.f;
 
-        vertex.s = scissVertex.tx * parent.size().x + parent.position().x;
-        vertex.t = scissVertex.ty * parent.size().y + parent.position().y;
+        vertex.s = scissVertex.tx * s.x + p.x;
+        vertex.t = scissVertex.ty * s.y + p.y;
 
         vertex.r = 1.f;
         vertex.g = 1.f;
@@ -166,6 +166,9 @@ Buffer generateSimCADMesh(const std::string& path, const vec2& pos, const vec2&
     }
 
     buf.geometryType = GL_TRIANGLE_STRIP;
+    buf.grids = {
+        Grid{ 0, static_cast<unsigned int>(nCols), static_cast<unsigned int>(nRows) }
+    };
     return buf;
 }
 
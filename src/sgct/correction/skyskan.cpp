@@ -8,14 +8,12 @@
 
 #include <sgct/correction/skyskan.h>
 
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #include <sgct/viewport.h>
-#include <sgct/user.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -34,7 +32,7 @@ namespace {
 
 namespace sgct::correction {
 
-Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
+Buffer generateSkySkanMesh(const std::string& path, const BaseViewport& parent) {
     ZoneScoped
 
     Buffer buf;
@@ -139,17 +137,18 @@ Buffer generateSkySkanMesh(const std::string& path, BaseViewport& parent) {
     rotQuat = glm::rotate(rotQuat, glm::radians(-*azimuth), glm::vec3(0.f, 1.f, 0.f));
     rotQuat = glm::rotate(rotQuat, glm::radians(*elevation), glm::vec3(1.f, 0.f, 0.f));
 
-    parent.user().setPos(vec3{ 0.f, 0.f, 0.f });
     const float vHalf = *vFov / 2.f;
     const float hHalf = *hFov / 2.f;
-    parent.setViewPlaneCoordsUsingFOVs(
-        vHalf,
-        -vHalf,
-        -hHalf,
-        hHalf,
-        fromGLM<glm::quat, quat>(rotQuat)
-    );
-    Engine::instance().updateFrustums();
+    ViewSetup view;
+    view.userPosition = vec3{ 0.f, 0.f, 0.f };
+    ViewSetup::FieldOfView fov;
+    fov.up = vHalf;
+    fov.down = -vHalf;
+    fov.left = -hHalf;
+    fov.right = hHalf;
+    fov.orientation = fromGLM<glm::quat, quat>(rotQuat);
+    view.fieldOfView = fov;
+    buf.viewSetup = view;
 
     for (unsigned int c = 0; c < (sizeX - 1); c++) {
         for (unsigned int r = 0; r < (sizeY - 1); r++) {
@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/tokenizer.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    // from_chars does not accept a leading plus sign, which some exporters write
+    std::string_view withoutPlus(std::string_view token) {
+        if (token.size() > 1 && token.front() == '+') {
+            token.remove_prefix(1);
+        }
+        return token;
+    }
+
+    template <typename T>
+    bool parseInteger(std::string_view token, T& value) {
+        token = withoutPlus(token);
+        const char* end = token.data() + token.size();
+        const auto [ptr, ec] = std::from_chars(token.data(), end, value);
+        return !token.empty() && ec == std::errc() && ptr == end;
+    }
+} // namespace
+
+namespace sgct::correction {
+
+Tokenizer::Tokenizer(const char* data, size_t size)
+    : _begin(data)
+    , _end(data + size)
+    , _pos(data)
+{}
+
+bool Tokenizer::nextLine() {
+    if (_pos >= _end) {
+        _line = std::string_view();
+        return false;
+    }
+
+    const size_t remaining = static_cast<size_t>(_end - _pos);
+    const char* eol = reinterpret_cast<const char*>(std::memchr(_pos, '\n', remaining));
+    const char* lineEnd = eol ? eol : _end;
+    _line = std::string_view(_pos, static_cast<size_t>(lineEnd - _pos));
+    if (!_line.empty() && _line.back() == '\r') {
+        _line.remove_suffix(1);
+    }
+    _pos = eol ? eol + 1 : _end;
+    _lineNumber++;
+    return true;
+}
+
+std::string_view Tokenizer::nextToken(std::string_view separators) {
+    auto isSeparator = [separators](char c) {
+        return isWhitespace(c) || separators.find(c) != std::string_view::npos;
+    };
+
+    size_t begin = 0;
+    while (begin < _line.size() && isSeparator(_line[begin])) {
+        begin++;
+    }
+    size_t end = begin;
+    while (end < _line.size() && !isSeparator(_line[end])) {
+        end++;
+    }
+
+    const std::string_view token = _line.substr(begin, end - begin);
+    _line.remove_prefix(end);
+    return token;
+}
+
+bool Tokenizer::nextNumber(float& value, std::string_view separators) {
+    return parseNumber(nextToken(separators), value);
+}
+
+bool Tokenizer::nextNumber(int& value, std::string_view separators) {
+    return parseNumber(nextToken(separators), value);
+}
+
+bool Tokenizer::nextNumber(unsigned int& value, std::string_view separators) {
+    return parseNumber(nextToken(separators), value);
+}
+
+std::string_view Tokenizer::rest() const {
+    std::string_view res = _line;
+    while (!res.empty() && isWhitespace(res.front())) {
+        res.remove_prefix(1);
+    }
+    while (!res.empty() && isWhitespace(res.back())) {
+        res.remove_suffix(1);
+    }
+    return res;
+}
+
+int Tokenizer::lineNumber() const {
+    return _lineNumber;
+}
+
+size_t Tokenizer::countLines() const {
+    if (_begin == _end) {
+        return 0;
+    }
+    const size_t nNewlines = static_cast<size_t>(std::count(_begin, _end, '\n'));
+    // The last line does not need to end with a newline
+    return *(_end - 1) == '\n' ? nNewlines : nNewlines + 1;
+}
+
+bool parseNumber(std::string_view token, float& value) {
+    token = withoutPlus(token);
+    if (token.empty()) {
+        return false;
+    }
+
+#ifdef __cpp_lib_to_chars
+    const char* end = token.data() + token.size();
+    const auto [ptr, ec] = std::from_chars(token.data(), end, value);
+    return ec == std::errc() && ptr == end;
+#else // __cpp_lib_to_chars
+    // Standard libraries without floating-point from_chars need a null-terminated copy
+    std::array<char, 64> buffer;
+    if (token.size() >= buffer.size()) {
+        return false;
+    }
+    std::memcpy(buffer.data(), token.data(), token.size());
+    buffer[token.size()] = '\0';
+    char* end = nullptr;
+    value = std::strtof(buffer.data(), &end);
+    return end == buffer.data() + token.size();
+#endif // __cpp_lib_to_chars
+}
+
+bool parseNumber(std::string_view token, int& value) {
+    return parseInteger(token, value);
+}
+
+bool parseNumber(std::string_view token, unsigned int& value) {
+    return parseInteger(token, value);
+}
+
+} // namespace sgct::correction
@@ -8,6 +8,7 @@
 
 #include <sgct/correctionmesh.h>
 
+#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/log.h>
@@ -15,11 +16,16 @@
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #include <sgct/settings.h>
+#include <sgct/user.h>
 #include <sgct/viewport.h>
 #include <sgct/window.h>
+#include <sgct/correction/decimation.h>
 #include <sgct/correction/domeprojection.h>
+#include <sgct/correction/meshcache.h>
 #include <sgct/correction/mpcdimesh.h>
 #include <sgct/correction/obj.h>
+#include <sgct/correction/optimization.h>
+#include <sgct/correction/packedmesh.h>
 #include <sgct/correction/paulbourke.h>
 #include <sgct/correction/pfm.h>
 #include <sgct/correction/scalable.h>
@@ -28,8 +34,11 @@
 #include <sgct/correction/skyskan.h>
 #include <sgct/projection/fisheye.h>
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <optional>
 
 #define Error(c, msg) sgct::Error(sgct::Error::Component::CorrectionMesh, c, msg)
 
@@ -139,16 +148,23 @@ void exportMesh(GLenum type, const std::string& path, const correction::Buffer&
         }
     }
     else {
-        // first base triangle
-        file << fmt::format(
-            "f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n",
-            buf.indices[0] + 1, buf.indices[1] + 1, buf.indices[2] + 1
-        );
-
-        for (size_t i = 2; i < buf.indices.size(); i++) {
+        // Every other triangle of a strip has its first two vertices swapped to keep the
+        // winding of all triangles the same. Restart indices begin a new strip
+        size_t start = 0;
+        for (size_t i = 0; i < buf.indices.size(); i++) {
+            if (buf.indices[i] == correction::PrimitiveRestartIndex) {
+                start = i + 1;
+                continue;
+            }
+            if (i < start + 2) {
+                continue;
+            }
+            const bool isOdd = (i - start) % 2 == 1;
+            const unsigned int a = isOdd ? buf.indices[i - 1] : buf.indices[i - 2];
+            const unsigned int b = isOdd ? buf.indices[i - 2] : buf.indices[i - 1];
             file << fmt::format(
                 "f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n",
-                buf.indices[i], buf.indices[i - 1] + 1, buf.indices[i - 2] + 1
+                a + 1, b + 1, buf.indices[i] + 1
             );
         }
     }
@@ -156,6 +172,117 @@ void exportMesh(GLenum type, const std::string& path, const correction::Buffer&
     Log::Info(fmt::format("Mesh '{}' exported successfully", path));
 }
 
+// Reads the warp mesh from the cache or parses it from the file. This does not require
+// an OpenGL context and does not modify the viewport
+correction::Buffer readMesh(const std::string& path, const BaseViewport& parent) {
+    ZoneScoped
+
+    using namespace correction;
+
+    const std::string ext = path.substr(path.rfind('.') + 1);
+
+    // MPCDI meshes are embedded in the configuration and are not read from the path
+    const bool useCache = Settings::instance().useCorrectionMeshCache() && ext != "mpcdi";
+    const std::string cachePath = Settings::instance().correctionMeshCachePath();
+    MeshCacheKey key;
+    key.path = path;
+    key.position = parent.position();
+    key.size = parent.size();
+    key.aspectRatio = parent.window().aspectRatio();
+    key.useStrips = Settings::instance().useCorrectionMeshStrips();
+    const float maxError = Settings::instance().correctionMeshMaxError();
+    if (maxError > 0.f) {
+        key.maxError = maxError;
+        key.resolution = parent.window().framebufferResolution();
+    }
+    std::optional<Buffer> cached;
+    if (useCache) {
+        cached = readMeshCache(cachePath, key);
+    }
+
+    Buffer buf;
+    if (cached) {
+        buf = std::move(*cached);
+    }
+    // otherwise find a suitable format
+    else if (ext == "sgc") {
+        buf = generateScissMesh(path, parent);
+    }
+    else if (ext == "ol") {
+        buf = generateScalableMesh(path, parent);
+    }
+    else if (ext == "skyskan") {
+        buf = generateSkySkanMesh(path, parent);
+    }
+    else if (ext == "txt") {
+        buf = generateSkySkanMesh(path, parent);
+    }
+    else if (ext == "csv") {
+        buf = generateDomeProjectionMesh(path, parent.position(), parent.size());
+    }
+    else if (ext == "data") {
+        const float aspectRatio = parent.window().aspectRatio();
+        buf = generatePaulBourkeMesh(path, parent.position(), parent.size(), aspectRatio);
+    }
+    else if (ext == "obj") {
+        buf = generateOBJMesh(path);
+    }
+    else if (ext == "pfm") {
+        buf = generatePerEyeMeshFromPFMImage(path, parent.position(), parent.size());
+    }
+    else if (ext == "mpcdi") {
+        const Viewport* vp = dynamic_cast<const Viewport*>(&parent);
+        if (vp == nullptr) {
+            throw Error(2020, "Configuration error. Trying load MPCDI to wrong viewport");
+        }
+        buf = generateMpcdiMesh(vp->mpcdiWarpMesh());
+    }
+    else if (ext == "simcad") {
+        buf = generateSimCADMesh(path, parent.position(), parent.size());
+    }
+    else {
+        throw Error(2002, "Could not determine format for warping mesh");
+    }
+
+    if (!cached && key.maxError > 0.f) {
+        const size_t nVertices = buf.vertices.size();
+        const size_t nRemoved = decimateMesh(buf, key.maxError, key.resolution);
+        Log::Debug(fmt::format(
+            "Decimated correction mesh '{}' from {} to {} vertices",
+            path, nVertices, nVertices - nRemoved
+        ));
+    }
+
+    if (!cached) {
+        optimizeMesh(buf, key.useStrips);
+    }
+
+    if (useCache && !cached) {
+        writeMeshCache(cachePath, key, buf);
+    }
+
+    return buf;
+}
+
+void applyViewSetup(const correction::ViewSetup& view, BaseViewport& parent) {
+    if (view.userPosition) {
+        parent.user().setPos(*view.userPosition);
+    }
+    if (view.fieldOfView) {
+        parent.setViewPlaneCoordsUsingFOVs(
+            view.fieldOfView->up,
+            view.fieldOfView->down,
+            view.fieldOfView->left,
+            view.fieldOfView->right,
+            view.fieldOfView->orientation
+        );
+    }
+    if (view.projectionPlaneOffset) {
+        parent.projectionPlane().offset(*view.projectionPlaneOffset);
+    }
+    Engine::instance().updateFrustums();
+}
+
 } // namespace
 
 CorrectionMesh::CorrectionMeshGeometry::~CorrectionMeshGeometry() {
@@ -173,6 +300,21 @@ CorrectionMesh::CorrectionMeshGeometry::~CorrectionMeshGeometry() {
     }
 }
 
+void CorrectionMesh::parseMesh(const std::string& path, const BaseViewport& parent) {
+    ZoneScoped
+
+    if (path.empty()) {
+        return;
+    }
+
+    try {
+        _parsedMesh = readMesh(path, parent);
+    }
+    catch (...) {
+        _parseError = std::current_exception();
+    }
+}
+
 void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
                               bool needsMaskGeometry)
 {
@@ -206,28 +348,21 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
     }
 
     Buffer buf;
-
-    std::string ext = path.substr(path.rfind('.') + 1);
-    // find a suitable format
-    if (ext == "sgc") {
-        buf = generateScissMesh(path, parent);
-    }
-    else if (ext == "ol") {
-        buf = generateScalableMesh(path, parent);
-    }
-    else if (ext == "skyskan") {
-        buf = generateSkySkanMesh(path, parent);
+    if (_parsedMesh) {
+        buf = std::move(*_parsedMesh);
+        _parsedMesh = std::nullopt;
     }
-    else if (ext == "txt") {
-        buf = generateSkySkanMesh(path, parent);
+    else if (_parseError) {
+        std::exception_ptr error = _parseError;
+        _parseError = nullptr;
+        std::rethrow_exception(error);
     }
-    else if (ext == "csv") {
-        buf = generateDomeProjectionMesh(path, parentPos, parentSize);
+    else {
+        buf = readMesh(path, parent);
     }
-    else if (ext == "data") {
-        const float aspectRatio = parent.window().aspectRatio();
-        buf = generatePaulBourkeMesh(path, parentPos, parentSize, aspectRatio);
 
+    const std::string ext = path.substr(path.rfind('.') + 1);
+    if (ext == "data") {
         // force regeneration of dome render quad
         if (Viewport* vp = dynamic_cast<Viewport*>(&parent); vp) {
             auto fishPrj = dynamic_cast<FisheyeProjection*>(vp->nonLinearProjection());
@@ -237,24 +372,8 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
             }
         }
     }
-    else if (ext == "obj") {
-        buf = generateOBJMesh(path);
-    }
-    else if (ext == "pfm") {
-        buf = generatePerEyeMeshFromPFMImage(path, parentPos, parentSize);
-    }
-    else if (ext == "mpcdi") {
-        const Viewport* vp = dynamic_cast<const Viewport*>(&parent);
-        if (vp == nullptr) {
-            throw Error(2020, "Configuration error. Trying load MPCDI to wrong viewport");
-        }
-        buf = generateMpcdiMesh(vp->mpcdiWarpMesh());
-    }
-    else if (ext == "simcad") {
-        buf = generateSimCADMesh(path, parentPos, parentSize);
-    }
-    else {
-        throw Error(2002, "Could not determine format for warping mesh");
+    if (buf.viewSetup) {
+        applyViewSetup(*buf.viewSetup, parent);
     }
 
     createMesh(_warpGeometry, buf);
@@ -274,24 +393,40 @@ void CorrectionMesh::loadMesh(std::string path, BaseViewport& parent,
 void CorrectionMesh::renderQuadMesh() const {
     TracyGpuZone("Render Quad mesh")
 
-    glBindVertexArray(_quadGeometry.vao);
-    glDrawElements(_quadGeometry.type, _quadGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    render(_quadGeometry);
 }
 
 void CorrectionMesh::renderWarpMesh() const {
     TracyGpuZone("Render Warp mesh")
 
-    glBindVertexArray(_warpGeometry.vao);
-    glDrawElements(_warpGeometry.type, _warpGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    render(_warpGeometry);
 }
 
 void CorrectionMesh::renderMaskMesh() const {
     TracyGpuZone("Render Mask mesh")
 
-    glBindVertexArray(_maskGeometry.vao);
-    glDrawElements(_maskGeometry.type, _maskGeometry.nIndices, GL_UNSIGNED_INT, nullptr);
+    render(_maskGeometry);
+}
+
+void CorrectionMesh::render(const CorrectionMeshGeometry& geom) {
+    glBindVertexArray(geom.vao);
+    if (geom.color) {
+        // The current value of a disabled attribute is not part of the vertex array
+        // object, so it has to be set for every draw call
+        glVertexAttrib4f(2, geom.color->x, geom.color->y, geom.color->z, geom.color->w);
+    }
+    if (geom.hasPrimitiveRestart) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(
+            geom.indexType == GL_UNSIGNED_SHORT ?
+                std::numeric_limits<uint16_t>::max() :
+                std::numeric_limits<uint32_t>::max()
+        );
+    }
+    glDrawElements(geom.type, geom.nIndices, geom.indexType, nullptr);
+    if (geom.hasPrimitiveRestart) {
+        glDisable(GL_PRIMITIVE_RESTART);
+    }
     glBindVertexArray(0);
 }
 
@@ -304,35 +439,72 @@ void CorrectionMesh::createMesh(CorrectionMeshGeometry& geom,
     glGenVertexArrays(1, &geom.vao);
     glBindVertexArray(geom.vao);
 
+    const correction::PackedMesh mesh = correction::packMesh(buffer);
+    using PositionFormat = correction::PackedMesh::PositionFormat;
+    using ColorFormat = correction::PackedMesh::ColorFormat;
+
     glGenBuffers(1, &geom.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, geom.vbo);
-    constexpr const int s = sizeof(correction::CorrectionMeshVertex);
     glBufferData(
         GL_ARRAY_BUFFER,
-        buffer.vertices.size() * s,
-        buffer.vertices.data(),
+        mesh.vertices.size(),
+        mesh.vertices.data(),
         GL_STATIC_DRAW
     );
 
+    const int s = mesh.vertexSize;
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
-
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(8));
+    if (mesh.positionFormat == PositionFormat::Normalized16) {
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, s, nullptr);
+        glVertexAttribPointer(
+            1, 2, GL_UNSIGNED_SHORT, GL_TRUE, s,
+            reinterpret_cast<void*>(static_cast<size_t>(mesh.texCoordOffset))
+        );
+    }
+    else {
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+        glVertexAttribPointer(
+            1, 2, GL_FLOAT, GL_FALSE, s,
+            reinterpret_cast<void*>(static_cast<size_t>(mesh.texCoordOffset))
+        );
+    }
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(16));
+    void* colorOffset = reinterpret_cast<void*>(static_cast<size_t>(mesh.colorOffset));
+    geom.color = std::nullopt;
+    switch (mesh.colorFormat) {
+        case ColorFormat::Constant:
+            glDisableVertexAttribArray(2);
+            geom.color = mesh.constantColor;
+            break;
+        case ColorFormat::Normalized8:
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, s, colorOffset);
+            break;
+        case ColorFormat::Float:
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, s, colorOffset);
+            break;
+    }
 
     glGenBuffers(1, &geom.ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom.ibo);
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        buffer.indices.size() * sizeof(unsigned int),
-        buffer.indices.data(),
+        mesh.indices.size(),
+        mesh.indices.data(),
         GL_STATIC_DRAW
     );
     glBindVertexArray(0);
 
+    geom.indexType = mesh.has16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    geom.hasPrimitiveRestart = mesh.hasPrimitiveRestart;
+    Log::Debug(fmt::format(
+        "Correction mesh uses {} bytes instead of {} bytes",
+        mesh.vertices.size() + mesh.indices.size(),
+        buffer.vertices.size() * sizeof(correction::CorrectionMeshVertex) +
+            buffer.indices.size() * sizeof(unsigned int)
+    ));
     geom.nVertices = static_cast<int>(buffer.vertices.size());
     geom.nIndices = static_cast<int>(buffer.indices.size());
     geom.type = buffer.geometryType;
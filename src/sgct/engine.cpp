@@ -15,6 +15,8 @@
 #include <sgct/fontmanager.h>
 #include <sgct/freetype.h>
 #include <sgct/internalshaders.h>
+#include <sgct/imagebufferpool.h>
+#include <sgct/jobsystem.h>
 #include <sgct/networkmanager.h>
 #include <sgct/node.h>
 #include <sgct/offscreenbuffer.h>
@@ -31,6 +33,7 @@
 #include <sgct/user.h>
 #include <sgct/version.h>
 #include <sgct/projection/nonlinearprojection.h>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <numeric>
@@ -61,6 +64,9 @@ namespace {
     bool sRunUpdateFrameLockLoop = true;
     std::mutex FrameSync;
 
+    // Time of the current frame while replaying a shared data recording
+    std::optional<double> ReplayTime;
+
     // Callback wrappers for GLFW
     std::function<void(Key, Modifier, Action, int)> gKeyboardCallback = nullptr;
     std::function<void(unsigned int, int)> gCharCallback = nullptr;
@@ -83,6 +89,26 @@ namespace {
         }
     }
 
+    // Returns the refresh rate of the monitor that the window is on or the primary
+    // monitor for windowed mode. The refresh rate hint is used if no monitor can be
+    // queried
+    int detectRefreshRate(GLFWwindow* window) {
+        GLFWmonitor* monitor = glfwGetWindowMonitor(window);
+        if (!monitor) {
+            monitor = glfwGetPrimaryMonitor();
+        }
+        const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+        int refreshRate = mode ? mode->refreshRate : 0;
+        if (refreshRate <= 0) {
+            refreshRate = Settings::instance().refreshRateHint();
+        }
+        if (refreshRate <= 0) {
+            Log::Warning("Could not detect refresh rate. Assuming 60 Hz");
+            refreshRate = 60;
+        }
+        return refreshRate;
+    }
+
     void addValue(std::array<double, Engine::Statistics::HistoryLength>& a, double v) {
         std::rotate(std::rbegin(a), std::rbegin(a) + 1, std::rend(a));
         a[0] = v;
@@ -349,12 +375,73 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
     if (config.nCaptureThreads) {
         Settings::instance().setNumberOfCaptureThreads(*config.nCaptureThreads);
     }
+    if (config.nCaptureBuffers) {
+        Settings::instance().setNumberOfCaptureBuffers(*config.nCaptureBuffers);
+    }
+    if (config.captureQueueSize) {
+        Settings::instance().setCaptureQueueSize(*config.captureQueueSize);
+    }
+    if (config.dropCaptureFrames) {
+        Settings::instance().setCaptureQueuePolicy(
+            *config.dropCaptureFrames ?
+                Settings::CaptureQueuePolicy::Drop :
+                Settings::CaptureQueuePolicy::Block
+        );
+    }
+    if (config.captureRegion) {
+        Settings::instance().setCaptureRegion(*config.captureRegion);
+    }
+    if (config.nCaptureTiles) {
+        Settings::instance().setNumberOfCaptureTiles(*config.nCaptureTiles);
+    }
+    if (config.captureEncoder) {
+        Settings::instance().setCaptureEncoder(*config.captureEncoder);
+    }
+    if (config.captureEncoderRawFrames) {
+        Settings::instance().setCaptureEncoderRawFrames(*config.captureEncoderRawFrames);
+    }
+    if (config.captureFrameRate) {
+        Settings::instance().setCaptureFrameRate(*config.captureFrameRate);
+    }
+    if (config.nJobThreads) {
+        Settings::instance().setNumberOfJobThreads(*config.nJobThreads);
+    }
+    if (config.imageBufferPoolSize) {
+        Settings::instance().setImageBufferPoolSize(*config.imageBufferPoolSize);
+    }
+    if (config.useHugePages) {
+        Settings::instance().setUseHugePages(*config.useHugePages);
+    }
+    if (config.textureUploadBudget) {
+        Settings::instance().setTextureUploadBudget(*config.textureUploadBudget);
+    }
+    if (config.textureMemoryBudget) {
+        Settings::instance().setTextureMemoryBudget(*config.textureMemoryBudget);
+    }
     if (config.exportCorrectionMeshes) {
         Settings::instance().setExportWarpingMeshes(*config.exportCorrectionMeshes);
     }
+    if (config.useCorrectionMeshCache) {
+        Settings::instance().setUseCorrectionMeshCache(*config.useCorrectionMeshCache);
+    }
+    if (config.correctionMeshCachePath) {
+        Settings::instance().setCorrectionMeshCachePath(*config.correctionMeshCachePath);
+    }
+    if (config.correctionMeshMaxError) {
+        Settings::instance().setCorrectionMeshMaxError(*config.correctionMeshMaxError);
+    }
+    if (config.useCorrectionMeshStrips) {
+        Settings::instance().setUseCorrectionMeshStrips(*config.useCorrectionMeshStrips);
+    }
     if (config.useOpenGLDebugContext) {
         _createDebugContext = *config.useOpenGLDebugContext;
     }
+    if (config.useFramePacing) {
+        Settings::instance().setUseFramePacing(*config.useFramePacing);
+    }
+    if (config.framePacingMargin) {
+        Settings::instance().setFramePacingMargin(*config.framePacingMargin);
+    }
     if (config.screenshotPath) {
         Settings::instance().setCapturePath(*config.screenshotPath);
     }
@@ -441,6 +528,16 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
 
     ClusterManager::create(cluster, clusterId);
     NetworkManager::instance().initialize();
+
+    if (config.recordSharedData && NetworkManager::instance().isComputerServer()) {
+        SharedData::instance().startRecording(*config.recordSharedData);
+    }
+    if (config.replaySharedData && NetworkManager::instance().isComputerServer()) {
+        SharedData::instance().startReplay(*config.replaySharedData);
+        // The recorded time drives the application, so there is no reason to wait for
+        // the vertical sync when rendering offline
+        Settings::instance().setSwapInterval(0);
+    }
 }
 
 void Engine::initialize() {
@@ -551,6 +648,40 @@ void Engine::initialize() {
     std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
     Log::Info(fmt::format("Renderer: {}", renderer));
 
+    if (Settings::instance().useFramePacing()) {
+        const int swapInterval = Settings::instance().swapInterval();
+        if (swapInterval <= 0) {
+            Log::Warning("Frame pacing requires vertical sync and has been disabled");
+        }
+        else {
+            const int refreshRate = detectRefreshRate(winHandle);
+            _framePacing = FramePacing();
+            _framePacing->refreshPeriod =
+                static_cast<double>(swapInterval) / static_cast<double>(refreshRate);
+            Log::Info(fmt::format(
+                "Frame pacing enabled with {} Hz and a margin of {} ms",
+                refreshRate, Settings::instance().framePacingMargin() * 1000.0
+            ));
+        }
+    }
+
+    if (Settings::instance().useDynamicResolution()) {
+        _dynamicResolution = DynamicResolution();
+        _dynamicResolution->targetFrameTime =
+            Settings::instance().dynamicResolutionTarget();
+        if (_dynamicResolution->targetFrameTime == 0.0) {
+            // Leave some headroom for the synchronization and the buffer swap
+            constexpr const double Headroom = 0.9;
+            const int swapInterval = std::max(Settings::instance().swapInterval(), 1);
+            _dynamicResolution->targetFrameTime =
+                Headroom * swapInterval / detectRefreshRate(winHandle);
+        }
+        Log::Info(fmt::format(
+            "Dynamic resolution enabled with a target frame time of {} ms",
+            _dynamicResolution->targetFrameTime * 1000.0
+        ));
+    }
+
     Window::makeSharedContextCurrent();
 
     //
@@ -639,6 +770,22 @@ void Engine::initialize() {
     Window::setBarrier(true);
     Window::resetSwapGroupFrameNumber();
 
+    {
+        // The correction meshes of all viewports are parsed in parallel as the parsers
+        // don't need an OpenGL context; the windows upload them serially afterwards
+        ZoneScopedN("Parse correction meshes")
+        std::vector<Viewport*> viewports;
+        for (const std::unique_ptr<Window>& win : wins) {
+            for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
+                viewports.push_back(vp.get());
+            }
+        }
+        JobSystem::instance().parallelFor(
+            0,
+            viewports.size(),
+            [&viewports](size_t i) { viewports[i]->parseMesh(); }
+        );
+    }
     std::for_each(wins.begin(), wins.end(), std::mem_fn(&Window::initContextSpecificOGL));
 
 #ifdef SGCT_HAS_VRPN
@@ -672,6 +819,9 @@ Engine::~Engine() {
     gMouseScrollCallback = nullptr;
     gDropCallback = nullptr;
 
+    Log::Debug("Destroying job system");
+    JobSystem::destroy();
+
     // kill thread
     if (_thread) {
         Log::Debug("Waiting for frameLock thread to finish");
@@ -736,6 +886,11 @@ Engine::~Engine() {
     Log::Debug("Destroying settings");
     Settings::destroy();
 
+    // The windows, their screen captures, and the textures all hold images whose
+    // buffers are returned to the pool when they are destroyed
+    Log::Debug("Destroying image buffer pool");
+    ImageBufferPool::destroy();
+
     Log::Debug("Destroying message handler");
     Log::destroy();
 
@@ -895,6 +1050,110 @@ void Engine::frameLockPostStage() {
     addValue(_statistics.syncTimes, glfwGetTime() - t0);
 }
 
+void Engine::waitForFramePacing() {
+    if (!_framePacing) {
+        return;
+    }
+
+    FramePacing& fp = *_framePacing;
+    if (fp.lastSwap > 0.0) {
+        // Predict the cost of the upcoming frame as the worst case of the last few frames
+        // to avoid missing the vertical sync on a single slow frame
+        double predicted = *std::max_element(fp.workTimes.begin(), fp.workTimes.end());
+        if (_statisticsRenderer) {
+            // The GPU might still be busy after the CPU has finished submitting
+            predicted = std::max(predicted, _statistics.drawTimes[0]);
+        }
+        const double margin = Settings::instance().framePacingMargin();
+        const double wakeUp = fp.lastSwap + fp.refreshPeriod - predicted - margin;
+
+        double now = glfwGetTime();
+        if (wakeUp > now) {
+            ZoneScopedN("Frame pacing")
+
+            // Sleeping is only accurate to about a millisecond on most platforms, so we
+            // sleep for the bulk of the time and yield for the remainder
+            constexpr const double SleepGranularity = 0.001;
+            if (wakeUp - now > SleepGranularity) {
+                std::this_thread::sleep_for(
+                    std::chrono::duration<double>(wakeUp - now - SleepGranularity)
+                );
+            }
+            while (glfwGetTime() < wakeUp) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    fp.frameStart = glfwGetTime();
+}
+
+void Engine::updateFramePacing(double beforeSwap, double afterSwap) {
+    if (!_framePacing) {
+        return;
+    }
+
+    FramePacing& fp = *_framePacing;
+    double workTime = beforeSwap - fp.frameStart;
+    if (fp.lastSwap > 0.0 && afterSwap - fp.lastSwap > 1.5 * fp.refreshPeriod) {
+        // We missed the vertical sync, so we back off and start the next frames at the
+        // beginning of the refresh period until the history has been flushed again
+        workTime = fp.refreshPeriod;
+    }
+    std::rotate(fp.workTimes.rbegin(), fp.workTimes.rbegin() + 1, fp.workTimes.rend());
+    fp.workTimes[0] = workTime;
+    fp.lastSwap = afterSwap;
+}
+
+void Engine::updateDynamicResolution(double frameCost) {
+    ZoneScoped
+
+    NetworkManager& nm = NetworkManager::instance();
+    if (!nm.isComputerServer()) {
+        // The clients only report their cost and use the scale decided by the master
+        nm.setFrameCost(static_cast<float>(frameCost));
+        return;
+    }
+
+    DynamicResolution& dr = *_dynamicResolution;
+    const double clientCost = static_cast<double>(nm.maxClientFrameCost());
+    dr.accumulatedCost += std::max(frameCost, clientCost);
+    dr.nFrames++;
+
+    // Only reevaluate the scale every couple of frames to average out single slow frames
+    constexpr const int UpdateInterval = 30;
+    if (dr.nFrames < UpdateInterval) {
+        return;
+    }
+    const double cost = dr.accumulatedCost / dr.nFrames;
+    dr.accumulatedCost = 0.0;
+    dr.nFrames = 0;
+
+    // Only grow the resolution if there is enough headroom to not oscillate around the
+    // target frame time
+    constexpr const double GrowThreshold = 0.8;
+    if (cost <= dr.targetFrameTime && cost >= GrowThreshold * dr.targetFrameTime) {
+        return;
+    }
+
+    // The cost is roughly proportional to the number of pixels, so the square root of
+    // the ratio is the change of the scale along each axis. The scale is quantized to
+    // avoid reallocating the render targets for small fluctuations
+    constexpr const float ScaleStep = 0.05f;
+    float scale = dr.scale * static_cast<float>(std::sqrt(dr.targetFrameTime / cost));
+    scale = std::round(scale / ScaleStep) * ScaleStep;
+    scale = std::clamp(scale, Settings::instance().dynamicResolutionMinScale(), 1.f);
+    if (scale == dr.scale) {
+        return;
+    }
+
+    Log::Debug(fmt::format(
+        "Changing resolution scale {} -> {} (frame cost {} ms)",
+        dr.scale, scale, cost * 1000.0
+    ));
+    dr.scale = scale;
+    nm.setResolutionScale(scale);
+}
+
 void Engine::render() {
     Window::makeSharedContextCurrent();
 
@@ -908,6 +1167,8 @@ void Engine::render() {
     while (!(_shouldTerminate || thisNode.closeAllWindows() ||
            !NetworkManager::instance().isRunning()))
     {
+        waitForFramePacing();
+
 #ifdef SGCT_HAS_VRPN
         if (isMaster()) {
             TrackingManager::instance().updateTrackingDevices();
@@ -921,37 +1182,84 @@ void Engine::render() {
 
         Window::makeSharedContextCurrent();
 
-        if (_preSyncFn) {
-            ZoneScopedN("[SGCT] PreSync");
-            _preSyncFn();
+        if (SharedData::instance().isReplaying()) {
+            ZoneScopedN("[SGCT] Replay")
+            ReplayTime = SharedData::instance().replayNextFrame();
+            if (!ReplayTime) {
+                Log::Info("Replay finished");
+                break;
+            }
+            // Encoding the replayed state forwards it to the clients of the cluster
+            if (NetworkManager::instance().isComputerServer()) {
+                SharedData::instance().encode();
+            }
         }
+        else {
+            if (_preSyncFn) {
+                ZoneScopedN("[SGCT] PreSync");
+                _preSyncFn();
+            }
 
-        if (NetworkManager::instance().isComputerServer()) {
-            SharedData::instance().encode();
-        }
-        else if (!NetworkManager::instance().isRunning()) {
-            // exit if not running
-            Log::Error("Network disconnected. Exiting");
-            break;
+            if (NetworkManager::instance().isComputerServer()) {
+                SharedData::instance().encode();
+            }
+            else if (!NetworkManager::instance().isRunning()) {
+                // exit if not running
+                Log::Error("Network disconnected. Exiting");
+                break;
+            }
         }
 
         frameLockPreStage();
+        if (_dynamicResolution) {
+            // The master uses the scale that it just sent to the clients, so that all
+            // nodes switch to a new resolution in the same frame
+            const float scale = NetworkManager::instance().isComputerServer() ?
+                _dynamicResolution->scale :
+                NetworkManager::instance().resolutionScale();
+            if (scale > 0.f) {
+                for (const std::unique_ptr<Window>& win : windows) {
+                    win->setResolutionScale(scale);
+                }
+            }
+        }
         std::for_each(windows.cbegin(), windows.cend(), std::mem_fn(&Window::update));
         Window::makeSharedContextCurrent();
 
+        {
+            ZoneScopedN("Texture uploads")
+            TextureManager::instance().update();
+        }
+
         if (_postSyncPreDrawFn) {
             ZoneScopedN("[SGCT] PostSyncPreDraw");
             _postSyncPreDrawFn();
         }
 
+        const double startFrameTime = glfwGetTime();
         {
             ZoneScopedN("Statistics update")
-            const double startFrameTime = glfwGetTime();
             const double ft = static_cast<float>(startFrameTime - _statsPrevTimestamp);
             addValue(_statistics.frametimes, ft);
             _statsPrevTimestamp = startFrameTime;
 
-            if (_statisticsRenderer) {
+            if (!_statisticsRenderer && _dynamicResolution && _frameCounter > 0) {
+                // Without the statistics renderer we don't want to stall the pipeline,
+                // so the previous frame's draw time is only used if it is available
+                GLint done = GL_FALSE;
+                glGetQueryObjectiv(timeQueryEnd, GL_QUERY_RESULT_AVAILABLE, &done);
+                if (done) {
+                    GLuint64 timerStart;
+                    glGetQueryObjectui64v(timeQueryBegin, GL_QUERY_RESULT, &timerStart);
+                    GLuint64 timerEnd;
+                    glGetQueryObjectui64v(timeQueryEnd, GL_QUERY_RESULT, &timerEnd);
+                    const double t =
+                        static_cast<double>(timerEnd - timerStart) / 1000000000.0;
+                    addValue(_statistics.drawTimes, t);
+                }
+            }
+
+            if (_statisticsRenderer || _dynamicResolution) {
                 glQueryCounter(timeQueryBegin, GL_TIMESTAMP);
             }
         }
@@ -1044,7 +1352,7 @@ void Engine::render() {
         }
         Window::makeSharedContextCurrent();
 
-        if (_statisticsRenderer) {
+        if (_statisticsRenderer || _dynamicResolution) {
             ZoneScopedN("glQueryCounter")
             glQueryCounter(timeQueryEnd, GL_TIMESTAMP);
         }
@@ -1074,8 +1382,16 @@ void Engine::render() {
             _statisticsRenderer->update();
         }
 
+        if (_dynamicResolution) {
+            // The GPU works asynchronously, so the frame is as expensive as the slower of
+            // the CPU and the GPU
+            const double cpuTime = glfwGetTime() - startFrameTime;
+            updateDynamicResolution(std::max(cpuTime, _statistics.drawTimes[0]));
+        }
+
         // master will wait for nodes render before swapping
         frameLockPostStage();
+        const double beforeSwap = glfwGetTime();
         // Swap front and back rendering buffers
         for (const std::unique_ptr<Window>& window : windows) {
             bool shouldTakeScreenshot = _takeScreenshot;
@@ -1096,6 +1412,7 @@ void Engine::render() {
             }
             window->swap(shouldTakeScreenshot);
         }
+        updateFramePacing(beforeSwap, glfwGetTime());
 
         TracyGpuCollect;
         FrameMark;
@@ -1130,6 +1447,7 @@ void Engine::drawOverlays(const Window& window, Frustum::Mode frustum) {
         setupViewport(window, *vp, frustum);
 
         glActiveTexture(GL_TEXTURE0);
+        TextureManager::instance().use(vp->overlayTextureIndex());
         glBindTexture(GL_TEXTURE_2D, vp->overlayTextureIndex());
         _overlay.bind();
         window.renderScreenQuad();
@@ -1221,10 +1539,12 @@ void Engine::renderFBOTexture(Window& window) {
             ZoneScopedN("Render Viewport")
 
             if (vp->hasBlendMaskTexture() && vp->isEnabled()) {
+                TextureManager::instance().use(vp->blendMaskTextureIndex());
                 glBindTexture(GL_TEXTURE_2D, vp->blendMaskTextureIndex());
                 vp->renderMaskMesh();
             }
             if (vp->hasBlackLevelMaskTexture() && vp->isEnabled()) {
+                TextureManager::instance().use(vp->blackLevelMaskTextureIndex());
                 glBindTexture(GL_TEXTURE_2D, vp->blackLevelMaskTextureIndex());
 
                 // inverse multiply
@@ -1538,27 +1858,37 @@ void Engine::updateFrustums() {
     ZoneScoped
 
     const Node& thisNode = ClusterManager::instance().thisNode();
+    std::vector<Viewport*> viewports;
     for (const std::unique_ptr<Window>& win : thisNode.windows()) {
         for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
-            if (vp->isTracked()) {
-                // if not tracked update, otherwise this is done on the fly
-                continue;
+            // if not tracked update, otherwise this is done on the fly
+            if (!vp->isTracked()) {
+                viewports.push_back(vp.get());
             }
+        }
+    }
 
+    // The viewports are independent of each other, but the frustums of one viewport
+    // share the projection plane and thus have to be calculated in the same job
+    JobSystem::instance().parallelFor(
+        0,
+        viewports.size(),
+        [this, &viewports](size_t i) {
             using Mode = Frustum::Mode;
-            if (vp->hasSubViewports()) {
-                NonLinearProjection& p = *vp->nonLinearProjection();
+            Viewport& vp = *viewports[i];
+            if (vp.hasSubViewports()) {
+                NonLinearProjection& p = *vp.nonLinearProjection();
                 p.updateFrustums(Mode::MonoEye, _nearClipPlane, _farClipPlane);
                 p.updateFrustums(Mode::StereoLeftEye, _nearClipPlane, _farClipPlane);
                 p.updateFrustums(Mode::StereoRightEye, _nearClipPlane, _farClipPlane);
             }
             else {
-                vp->calculateFrustum(Mode::MonoEye, _nearClipPlane, _farClipPlane);
-                vp->calculateFrustum(Mode::StereoLeftEye, _nearClipPlane, _farClipPlane);
-                vp->calculateFrustum(Mode::StereoRightEye, _nearClipPlane, _farClipPlane);
+                vp.calculateFrustum(Mode::MonoEye, _nearClipPlane, _farClipPlane);
+                vp.calculateFrustum(Mode::StereoLeftEye, _nearClipPlane, _farClipPlane);
+                vp.calculateFrustum(Mode::StereoRightEye, _nearClipPlane, _farClipPlane);
             }
         }
-    }
+    );
 }
 
 void Engine::blitWindowViewport(Window& prevWindow, Window& window,
@@ -1731,7 +2061,7 @@ User& Engine::defaultUser() {
 }
 
 double Engine::getTime() {
-    return glfwGetTime();
+    return ReplayTime ? *ReplayTime : glfwGetTime();
 }
 
 void Engine::setSyncParameters(bool printMessage, float timeout) {
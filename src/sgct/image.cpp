@@ -11,11 +11,23 @@
 #include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/fmt.h>
+#include <sgct/imagebufferpool.h>
+#include <sgct/jobsystem.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
+#include <sgct/pixelconversion.h>
+#include <sgct/profiling.h>
+#include <sgct/qoi.h>
 #include <png.h>
 #include <pngpriv.h>
+#include <zlib.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <vector>
 
 #ifdef WIN32
 #include <CodeAnalysis/warnings.h>
@@ -40,6 +52,30 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
+// The pixel data that stb_image returns is allocated from the image buffer pool, so that
+// it is released the same way as the buffers that we allocate ourselves
+namespace {
+    void* poolMalloc(size_t size) {
+        return sgct::ImageBufferPool::instance().acquire(size);
+    }
+
+    void* poolRealloc(void* ptr, size_t size) {
+        unsigned char* p = reinterpret_cast<unsigned char*>(ptr);
+        return sgct::ImageBufferPool::instance().resize(p, size);
+    }
+
+    void poolFree(void* ptr) {
+        sgct::ImageBufferPool::instance().release(reinterpret_cast<unsigned char*>(ptr));
+    }
+} // namespace
+
+#define STBI_MALLOC(size) poolMalloc(size)
+#define STBI_REALLOC(ptr, size) poolRealloc(ptr, size)
+#define STBI_FREE(ptr) poolFree(ptr)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+// stb_image uses SSE2 on its own but requires an opt-in for the NEON JPEG decoder
+#define STBI_NEON
+#endif // __ARM_NEON
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -78,52 +114,354 @@ namespace {
         if (filename.find(".tga") != std::string::npos) {
             return sgct::Image::FormatType::TGA;
         }
+        if (filename.find(".qoi") != std::string::npos) {
+            return sgct::Image::FormatType::QOI;
+        }
         return sgct::Image::FormatType::Unknown;
     }
+
+    // Images that are smaller than this are written by libPNG on the calling thread as
+    // the overhead of distributing the work would outweigh the gains
+    constexpr const size_t ParallelPNGThreshold = 1024 * 1024;
+    // Approximate number of uncompressed bytes that are deflated in one job
+    constexpr const size_t ParallelPNGStripSize = 512 * 1024;
+
+    struct PNGStrip {
+        std::vector<unsigned char> compressed;
+        uLong adler = 0;
+        size_t length = 0;
+    };
+
+    // Converts one row of the image from the in-memory layout (BGR order, little-endian)
+    // into the layout required by PNG (RGB order, big-endian). Only 8 and 16 bit
+    // channels can be written to PNG files
+    void convertPNGRow(unsigned char* dst, const unsigned char* src, int width,
+                       int channels, int bpc)
+    {
+        const size_t nValues = static_cast<size_t>(width) * channels;
+        std::memcpy(dst, src, nValues * bpc);
+        if (bpc == 1) {
+            sgct::swapRedBlue(dst, static_cast<size_t>(width), channels);
+            return;
+        }
+
+        uint16_t* values = reinterpret_cast<uint16_t*>(dst);
+        if (channels >= 3) {
+            for (size_t i = 0; i < nValues; i += channels) {
+                std::swap(values[i], values[i + 2]);
+            }
+        }
+        sgct::byteSwap16(values, nValues);
+    }
+
+    void writePNGChunk(FILE* fp, const char* type, const unsigned char* data,
+                       uint32_t length)
+    {
+        const std::array<unsigned char, 4> len = {
+            static_cast<unsigned char>(length >> 24),
+            static_cast<unsigned char>(length >> 16),
+            static_cast<unsigned char>(length >> 8),
+            static_cast<unsigned char>(length)
+        };
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+        if (length > 0) {
+            crc = crc32(crc, data, length);
+        }
+        const std::array<unsigned char, 4> crcBytes = {
+            static_cast<unsigned char>(crc >> 24),
+            static_cast<unsigned char>(crc >> 16),
+            static_cast<unsigned char>(crc >> 8),
+            static_cast<unsigned char>(crc)
+        };
+
+        fwrite(len.data(), 1, len.size(), fp);
+        fwrite(type, 1, 4, fp);
+        if (length > 0) {
+            fwrite(data, 1, length, fp);
+        }
+        fwrite(crcBytes.data(), 1, crcBytes.size(), fp);
+    }
+
+    /**
+     * Writes the image as a PNG file by splitting it into horizontal strips that are
+     * filtered and deflated independently on the JobSystem. Every strip but the last ends
+     * with a sync flush, so the raw deflate streams can be concatenated into a single
+     * zlib stream whose checksum is combined from the checksums of the strips. The result
+     * is a standard PNG file that any decoder can read.
+     */
+    void writePNGParallel(const std::string& filename, const unsigned char* data,
+                          sgct::ivec2 size, int channels, int bpc, int compressionLevel)
+    {
+        const size_t rowBytes = static_cast<size_t>(size.x) * channels * bpc;
+        const size_t rowsPerStrip = std::max<size_t>(ParallelPNGStripSize / rowBytes, 1);
+        const size_t nRows = static_cast<size_t>(size.y);
+        const size_t nStrips = (nRows + rowsPerStrip - 1) / rowsPerStrip;
+
+        std::vector<PNGStrip> strips(nStrips);
+        std::atomic<bool> hasError = false;
+        sgct::JobSystem::instance().parallelFor(
+            0,
+            nStrips,
+            [&](size_t s) {
+                const size_t first = s * rowsPerStrip;
+                const size_t last = std::min(first + rowsPerStrip, nRows);
+                // The image is stored bottom-up, but PNG expects the top row first
+                auto sourceRow = [&](size_t row) {
+                    return data + (nRows - 1 - row) * rowBytes;
+                };
+
+                // Every row is prefixed by its filter type. We use the Up filter, which
+                // only needs the previous row and can thus be computed for each strip
+                // independently
+                std::vector<unsigned char> filtered((last - first) * (rowBytes + 1));
+                std::vector<unsigned char> prev(rowBytes);
+                std::vector<unsigned char> curr(rowBytes);
+                if (first > 0) {
+                    const unsigned char* src = sourceRow(first - 1);
+                    convertPNGRow(prev.data(), src, size.x, channels, bpc);
+                }
+                for (size_t row = first; row < last; ++row) {
+                    convertPNGRow(curr.data(), sourceRow(row), size.x, channels, bpc);
+                    unsigned char* out = &filtered[(row - first) * (rowBytes + 1)];
+                    if (row == 0) {
+                        out[0] = PNG_FILTER_VALUE_NONE;
+                        std::copy(curr.begin(), curr.end(), out + 1);
+                    }
+                    else {
+                        out[0] = PNG_FILTER_VALUE_UP;
+                        for (size_t i = 0; i < rowBytes; ++i) {
+                            out[i + 1] = static_cast<unsigned char>(curr[i] - prev[i]);
+                        }
+                    }
+                    std::swap(prev, curr);
+                }
+
+                PNGStrip& strip = strips[s];
+                strip.length = filtered.size();
+                strip.adler = adler32(
+                    adler32(0L, Z_NULL, 0),
+                    filtered.data(),
+                    static_cast<uInt>(filtered.size())
+                );
+
+                z_stream zs = {};
+                int res = deflateInit2(
+                    &zs, compressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY
+                );
+                if (res != Z_OK) {
+                    hasError = true;
+                    return;
+                }
+                // deflateBound does not include the marker of the sync flush
+                strip.compressed.resize(deflateBound(&zs, strip.length) + 16);
+                zs.next_in = filtered.data();
+                zs.avail_in = static_cast<uInt>(filtered.size());
+                zs.next_out = strip.compressed.data();
+                zs.avail_out = static_cast<uInt>(strip.compressed.size());
+                const bool isLast = s == nStrips - 1;
+                res = deflate(&zs, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+                if (res != (isLast ? Z_STREAM_END : Z_OK) || zs.avail_in != 0) {
+                    hasError = true;
+                }
+                strip.compressed.resize(strip.compressed.size() - zs.avail_out);
+                deflateEnd(&zs);
+            }
+        );
+        if (hasError) {
+            throw sgct::Error(
+                sgct::Error::Component::Image, 9013, "Failed to compress PNG data"
+            );
+        }
+
+        FILE* fp = fopen(filename.c_str(), "wb");
+        if (fp == nullptr) {
+            throw sgct::Error(
+                sgct::Error::Component::Image,
+                9008,
+                fmt::format("Can't create PNG file '{}'", filename)
+            );
+        }
+
+        constexpr const std::array<unsigned char, 8> Signature = {
+            137, 80, 78, 71, 13, 10, 26, 10
+        };
+        fwrite(Signature.data(), 1, Signature.size(), fp);
+
+        const uint32_t w = static_cast<uint32_t>(size.x);
+        const uint32_t h = static_cast<uint32_t>(size.y);
+        const unsigned char colorType = [](int c) -> unsigned char {
+            switch (c) {
+                case 1: return PNG_COLOR_TYPE_GRAY;
+                case 2: return PNG_COLOR_TYPE_GRAY_ALPHA;
+                case 3: return PNG_COLOR_TYPE_RGB;
+                case 4: return PNG_COLOR_TYPE_RGB_ALPHA;
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(channels);
+        const std::array<unsigned char, 13> header = {
+            static_cast<unsigned char>(w >> 24), static_cast<unsigned char>(w >> 16),
+            static_cast<unsigned char>(w >> 8), static_cast<unsigned char>(w),
+            static_cast<unsigned char>(h >> 24), static_cast<unsigned char>(h >> 16),
+            static_cast<unsigned char>(h >> 8), static_cast<unsigned char>(h),
+            static_cast<unsigned char>(bpc * 8),
+            colorType,
+            0, // compression method: deflate
+            0, // filter method: adaptive
+            0  // interlace method: none
+        };
+        writePNGChunk(fp, "IHDR", header.data(), static_cast<uint32_t>(header.size()));
+
+        // zlib header with the compression level hint, see RFC 1950
+        const unsigned char levelFlag = [](int level) -> unsigned char {
+            if (level == Z_DEFAULT_COMPRESSION || level == 6) {
+                return 0x9C;
+            }
+            if (level <= 1) {
+                return 0x01;
+            }
+            return level < 6 ? 0x5E : 0xDA;
+        }(compressionLevel);
+        const std::array<unsigned char, 2> zlibHeader = { 0x78, levelFlag };
+        writePNGChunk(fp, "IDAT", zlibHeader.data(), 2);
+
+        uLong adler = strips.front().adler;
+        for (size_t i = 0; i < strips.size(); ++i) {
+            const PNGStrip& strip = strips[i];
+            if (i > 0) {
+                const z_off_t length = static_cast<z_off_t>(strip.length);
+                adler = adler32_combine(adler, strip.adler, length);
+            }
+            writePNGChunk(
+                fp,
+                "IDAT",
+                strip.compressed.data(),
+                static_cast<uint32_t>(strip.compressed.size())
+            );
+        }
+
+        const std::array<unsigned char, 4> adlerBytes = {
+            static_cast<unsigned char>(adler >> 24),
+            static_cast<unsigned char>(adler >> 16),
+            static_cast<unsigned char>(adler >> 8),
+            static_cast<unsigned char>(adler)
+        };
+        writePNGChunk(fp, "IDAT", adlerBytes.data(), 4);
+        writePNGChunk(fp, "IEND", nullptr, 0);
+
+        const bool success = ferror(fp) == 0;
+        fclose(fp);
+        if (!success) {
+            throw sgct::Error(
+                sgct::Error::Component::Image,
+                9014,
+                fmt::format("Failed to write PNG file '{}'", filename)
+            );
+        }
+    }
 } // namespace
 
 namespace sgct {
 
 Image::~Image() {
-    if (_data) {
-        stbi_image_free(_data);
+    ImageBufferPool::instance().release(_data);
+}
+
+Image::Image(Image&& rhs) noexcept
+    : _nChannels(rhs._nChannels)
+    , _size(rhs._size)
+    , _dataSize(rhs._dataSize)
+    , _bytesPerChannel(rhs._bytesPerChannel)
+    , _data(rhs._data)
+{
+    rhs._dataSize = 0;
+    rhs._data = nullptr;
+}
+
+Image& Image::operator=(Image&& rhs) noexcept {
+    if (this != &rhs) {
+        ImageBufferPool::instance().release(_data);
+        _nChannels = rhs._nChannels;
+        _size = rhs._size;
+        _dataSize = rhs._dataSize;
+        _bytesPerChannel = rhs._bytesPerChannel;
+        _data = rhs._data;
+        rhs._dataSize = 0;
+        rhs._data = nullptr;
     }
+    return *this;
 }
 
 void Image::load(const std::string& filename) {
+    ZoneScoped
+
     if (filename.empty()) {
         throw Err(9000, "Cannot load empty filepath");
     }
 
-    stbi_set_flip_vertically_on_load(1);
-    _data = stbi_load(filename.c_str(), &_size.x, &_size.y, &_nChannels, 0);
-    if (_data == nullptr) {
+    // Decoding straight from the page cache avoids copying the file into a buffer first
+    MappedFile file(filename);
+    if (!file.data()) {
         throw Err(
             9001, fmt::format("Could not open file '{}' for loading image", filename)
         );
     }
-    _bytesPerChannel = 1;
-    _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
-
-    // Convert BGR to RGB
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
-    }
+    decode(file.data(), file.size(), filename);
 }
 
 void Image::load(unsigned char* data, int length) {
-    stbi_set_flip_vertically_on_load(1);
-    _data = stbi_load_from_memory(data, length, &_size.x, &_size.y, &_nChannels, 0);
-    _bytesPerChannel = 1;
-    _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
+    ZoneScoped
 
-    // Convert BGR to RGB
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
+    decode(data, static_cast<size_t>(length), "<memory>");
+}
+
+void Image::loadMultiple(const std::vector<std::string>& filenames,
+                         const std::function<void(size_t, Image&)>& callback)
+{
+    ZoneScoped
+
+    struct Result {
+        Image image;
+        std::exception_ptr error;
+        JobSystem::Handle handle;
+    };
+    std::vector<Result> results(filenames.size());
+
+    // Only a limited number of images are decoded ahead of the callback so that large
+    // image sets do not have to fit into memory all at once
+    JobSystem& jobSystem = JobSystem::instance();
+    const size_t nAhead = static_cast<size_t>(jobSystem.numberOfThreads()) * 2 + 1;
+
+    size_t next = 0;
+    try {
+        for (size_t i = 0; i < results.size(); ++i) {
+            for (; next < results.size() && next < i + nAhead; ++next) {
+                results[next].handle = jobSystem.submit(
+                    [&result = results[next], &filename = filenames[next]]() {
+                        try {
+                            result.image.load(filename);
+                        }
+                        catch (...) {
+                            result.error = std::current_exception();
+                        }
+                    }
+                );
+            }
+
+            jobSystem.wait(results[i].handle);
+            if (results[i].error) {
+                std::rethrow_exception(results[i].error);
+            }
+            callback(i, results[i].image);
+            results[i].image = Image();
+        }
+    }
+    catch (...) {
+        // The jobs that are still running write into the results, so they have to be
+        // finished before the results go out of scope
+        for (size_t i = 0; i < next; ++i) {
+            jobSystem.wait(results[i].handle);
         }
+        throw;
     }
 }
 
@@ -142,13 +480,13 @@ void Image::save(const std::string& file) {
         savePNG(file);
         return;
     }
-
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
+    if (type == FormatType::QOI) {
+        saveQOI(file);
+        return;
     }
 
+    swapRedBlue(_data, static_cast<size_t>(_size.x) * _size.y, _nChannels);
+
     stbi_flip_vertically_on_write(1);
     if (type == FormatType::JPEG) {
         int r = stbi_write_jpg(file.c_str(), _size.x, _size.y, _nChannels, _data, 100);
@@ -180,6 +518,19 @@ void Image::savePNG(std::string filename, int compressionLevel) {
 
     double t0 = Engine::getTime();
 
+    const size_t dataSize =
+        static_cast<size_t>(_size.x) * _size.y * _nChannels * _bytesPerChannel;
+    if (dataSize >= ParallelPNGThreshold) {
+        writePNGParallel(
+            filename, _data, _size, _nChannels, _bytesPerChannel, compressionLevel
+        );
+        const double time = (Engine::getTime() - t0) * 1000.0;
+        Log::Debug(fmt::format(
+            "'{}' was saved successfully in parallel ({:.2f} ms)", filename, time
+        ));
+        return;
+    }
+
     FILE* fp = fopen(filename.c_str(), "wb");
     if (fp == nullptr) {
         throw Err(9008, fmt::format("Can't create PNG file '{}'", filename));
@@ -266,6 +617,129 @@ void Image::savePNG(std::string filename, int compressionLevel) {
     Log::Debug(fmt::format("'{}' was saved successfully ({:.2f} ms)", filename, time));
 }
 
+void Image::saveQOI(const std::string& filename) {
+    if (_bytesPerChannel != 1 || (_nChannels != 3 && _nChannels != 4)) {
+        throw Err(
+            9021,
+            fmt::format(
+                "QOI only supports 8 bit images with 3 or 4 channels, not {} bit with {}",
+                _bytesPerChannel * 8, _nChannels
+            )
+        );
+    }
+
+    double t0 = Engine::getTime();
+
+    const std::vector<unsigned char> contents =
+        encodeQOI(_data, _size.x, _size.y, _nChannels);
+    FILE* fp = fopen(filename.c_str(), "wb");
+    if (fp == nullptr) {
+        throw Err(9020, fmt::format("Could not save file '{}' as QOI", filename));
+    }
+    const size_t written = fwrite(contents.data(), 1, contents.size(), fp);
+    fclose(fp);
+    if (written != contents.size()) {
+        throw Err(9020, fmt::format("Could not save file '{}' as QOI", filename));
+    }
+
+    const double time = (Engine::getTime() - t0) * 1000.0;
+    Log::Debug(fmt::format("'{}' was saved successfully ({:.2f} ms)", filename, time));
+}
+
+void Image::decode(const unsigned char* data, size_t size, const std::string& name) {
+    if (readQOIHeader(data, size)) {
+        loadQOI(data, size, name);
+        return;
+    }
+
+    if (size >= 8 && png_sig_cmp(data, 0, 8) == 0 && loadPNG(data, size)) {
+        return;
+    }
+
+    ImageBufferPool::instance().release(_data);
+    _dataSize = 0;
+    stbi_set_flip_vertically_on_load(1);
+    _data = stbi_load_from_memory(
+        data,
+        static_cast<int>(size),
+        &_size.x,
+        &_size.y,
+        &_nChannels,
+        0
+    );
+    if (_data == nullptr) {
+        throw Err(9022, fmt::format("Could not decode image '{}'", name));
+    }
+    _bytesPerChannel = 1;
+    _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
+
+    // Convert BGR to RGB
+    swapRedBlue(_data, static_cast<size_t>(_size.x) * _size.y, _nChannels);
+}
+
+bool Image::loadPNG(const unsigned char* data, size_t size) {
+#ifdef PNG_SIMPLIFIED_READ_SUPPORTED
+    ZoneScoped
+
+    // libPNG decodes faster than stb_image, writes the channels in BGR order directly,
+    // and flips the image through a negative row stride, so no second pass is needed
+    png_image image;
+    std::memset(&image, 0, sizeof(png_image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, data, size)) {
+        return false;
+    }
+
+    // stb_image reduces 16 bit images to 8 bit without applying any gamma correction,
+    // which libPNG would do, so these images are left for stb_image to keep the results
+    // identical
+    if (image.format & PNG_FORMAT_FLAG_LINEAR) {
+        png_image_free(&image);
+        return false;
+    }
+
+    const bool hasColor = image.format & PNG_FORMAT_FLAG_COLOR;
+    const bool hasAlpha = image.format & PNG_FORMAT_FLAG_ALPHA;
+    if (hasColor) {
+        image.format = hasAlpha ? PNG_FORMAT_BGRA : PNG_FORMAT_BGR;
+    }
+    else {
+        image.format = hasAlpha ? PNG_FORMAT_GA : PNG_FORMAT_GRAY;
+    }
+
+    _size = ivec2{ static_cast<int>(image.width), static_cast<int>(image.height) };
+    _nChannels = PNG_IMAGE_SAMPLE_CHANNELS(image.format);
+    _bytesPerChannel = 1;
+    allocateOrResizeData();
+
+    const int stride = -static_cast<int>(PNG_IMAGE_ROW_STRIDE(image));
+    if (!png_image_finish_read(&image, nullptr, _data, stride, nullptr)) {
+        png_image_free(&image);
+        return false;
+    }
+    return true;
+#else // PNG_SIMPLIFIED_READ_SUPPORTED
+    (void)data;
+    (void)size;
+    return false;
+#endif // PNG_SIMPLIFIED_READ_SUPPORTED
+}
+
+void Image::loadQOI(const unsigned char* data, size_t size, const std::string& name) {
+    std::optional<QOIInfo> info = readQOIHeader(data, size);
+    if (!info) {
+        throw Err(9019, fmt::format("Could not decode QOI image '{}'", name));
+    }
+
+    _size = ivec2{ info->width, info->height };
+    _nChannels = info->channels;
+    _bytesPerChannel = 1;
+    allocateOrResizeData();
+    if (!decodeQOI(data, size, _data)) {
+        throw Err(9019, fmt::format("Could not decode QOI image '{}'", name));
+    }
+}
+
 unsigned char* Image::data() {
     return _data;
 }
@@ -311,13 +785,13 @@ void Image::allocateOrResizeData() {
 
     if (_data && _dataSize != dataSize) {
         // re-allocate if needed
-        delete[] _data;
+        ImageBufferPool::instance().release(_data);
         _data = nullptr;
         _dataSize = 0;
     }
 
     if (!_data) {
-        _data = new unsigned char[dataSize];
+        _data = ImageBufferPool::instance().acquire(dataSize);
         _dataSize = dataSize;
 
         Log::Debug(fmt::format(
@@ -0,0 +1,229 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/imagebufferpool.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/settings.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#define NOMINMAX
+#include <Windows.h>
+#else // WIN32
+#include <sys/mman.h>
+#endif // WIN32
+
+namespace {
+    // Every buffer is preceded by a header that stores the size of its bucket. The
+    // header is as large as the alignment so that the buffer itself stays aligned
+    constexpr const size_t HeaderSize = 64;
+
+    // Buffers up to this size are not kept in the pool
+    constexpr const size_t SmallSize = 64 * 1024;
+
+    // Blocks of this size or larger are allocated from the operating system directly
+    constexpr const size_t LargeSize = 2 * 1024 * 1024;
+
+    size_t bucketSize(size_t size) {
+        if (size <= SmallSize) {
+            return size;
+        }
+
+        size_t p = SmallSize;
+        while (p <= size / 2) {
+            p *= 2;
+        }
+        const size_t step = p / 8;
+        return (size + step - 1) / step * step;
+    }
+
+    size_t& header(unsigned char* buffer) {
+        return *reinterpret_cast<size_t*>(buffer - HeaderSize);
+    }
+} // namespace
+
+namespace sgct {
+
+std::atomic<ImageBufferPool*> ImageBufferPool::_instance = nullptr;
+std::mutex ImageBufferPool::_instanceMutex;
+
+ImageBufferPool& ImageBufferPool::instance() {
+    // The first request often comes from an image that is loaded on a worker thread, so
+    // the creation has to be synchronized
+    ImageBufferPool* pool = _instance.load(std::memory_order_acquire);
+    if (!pool) {
+        std::unique_lock lock(_instanceMutex);
+        pool = _instance.load(std::memory_order_relaxed);
+        if (!pool) {
+            const size_t size =
+                static_cast<size_t>(Settings::instance().imageBufferPoolSize()) *
+                1024 * 1024;
+            pool = new ImageBufferPool(size, Settings::instance().useHugePages());
+            _instance.store(pool, std::memory_order_release);
+        }
+    }
+    return *pool;
+}
+
+void ImageBufferPool::destroy() {
+    std::unique_lock lock(_instanceMutex);
+    delete _instance.exchange(nullptr);
+}
+
+ImageBufferPool::ImageBufferPool(size_t maxCachedSize, bool useHugePages)
+    : _maxCachedSize(maxCachedSize)
+    , _useHugePages(useHugePages)
+{}
+
+ImageBufferPool::~ImageBufferPool() {
+    trim();
+
+    Log::Debug(fmt::format(
+        "Image buffer pool: {} requests, {} reused, {:.1f} MiB maximum in use",
+        _stats.nAcquired, _stats.nReused, _stats.maxBytesInUse / (1024.0 * 1024.0)
+    ));
+}
+
+unsigned char* ImageBufferPool::acquire(size_t size) {
+    const size_t bucket = bucketSize(size);
+
+    unsigned char* block = nullptr;
+    {
+        std::unique_lock lock(_mutex);
+        _stats.nAcquired++;
+        _stats.bytesInUse += bucket;
+        _stats.maxBytesInUse = std::max(_stats.maxBytesInUse, _stats.bytesInUse);
+
+        auto it = _buckets.find(bucket);
+        if (it != _buckets.end() && !it->second.empty()) {
+            block = it->second.back();
+            it->second.pop_back();
+            _stats.nReused++;
+            _stats.bytesCached -= bucket;
+        }
+    }
+
+    if (!block) {
+        block = allocate(bucket);
+    }
+    unsigned char* buffer = block + HeaderSize;
+    header(buffer) = bucket;
+    return buffer;
+}
+
+void ImageBufferPool::release(unsigned char* buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    const size_t bucket = header(buffer);
+    unsigned char* block = buffer - HeaderSize;
+    {
+        std::unique_lock lock(_mutex);
+        _stats.bytesInUse -= bucket;
+        if (bucket > SmallSize && _stats.bytesCached + bucket <= _maxCachedSize) {
+            _buckets[bucket].push_back(block);
+            _stats.bytesCached += bucket;
+            return;
+        }
+    }
+    free(block, bucket);
+}
+
+unsigned char* ImageBufferPool::resize(unsigned char* buffer, size_t size) {
+    if (!buffer) {
+        return acquire(size);
+    }
+
+    const size_t bucket = header(buffer);
+    if (size <= bucket) {
+        return buffer;
+    }
+
+    unsigned char* res = acquire(size);
+    std::memcpy(res, buffer, bucket);
+    release(buffer);
+    return res;
+}
+
+void ImageBufferPool::trim() {
+    std::map<size_t, std::vector<unsigned char*>> buckets;
+    {
+        std::unique_lock lock(_mutex);
+        std::swap(buckets, _buckets);
+        _stats.bytesCached = 0;
+    }
+
+    for (const std::pair<const size_t, std::vector<unsigned char*>>& b : buckets) {
+        for (unsigned char* block : b.second) {
+            free(block, b.first);
+        }
+    }
+}
+
+ImageBufferPool::Statistics ImageBufferPool::statistics() const {
+    std::unique_lock lock(_mutex);
+    return _stats;
+}
+
+unsigned char* ImageBufferPool::allocate(size_t bucketSize) {
+    const size_t size = bucketSize + HeaderSize;
+    if (size < LargeSize) {
+        return static_cast<unsigned char*>(
+            ::operator new(size, std::align_val_t(HeaderSize))
+        );
+    }
+
+#ifdef WIN32
+    void* ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+#else // WIN32
+    void* ptr = mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (ptr == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (_useHugePages) {
+        // Transparent huge pages reduce the TLB misses when streaming through the image
+        madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif // MADV_HUGEPAGE
+#endif // WIN32
+    return static_cast<unsigned char*>(ptr);
+}
+
+void ImageBufferPool::free(unsigned char* block, size_t bucketSize) {
+    const size_t size = bucketSize + HeaderSize;
+    if (size < LargeSize) {
+        ::operator delete(block, std::align_val_t(HeaderSize));
+        return;
+    }
+
+#ifdef WIN32
+    VirtualFree(block, 0, MEM_RELEASE);
+#else // WIN32
+    munmap(block, size);
+#endif // WIN32
+}
+
+} // namespace sgct
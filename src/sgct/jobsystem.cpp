@@ -0,0 +1,187 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/jobsystem.h>
+
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <sgct/settings.h>
+#include <algorithm>
+#include <optional>
+
+namespace {
+    // Index of the worker that is running on the current thread or -1 if the current
+    // thread is not one of the workers of the job system
+    thread_local int ThisWorker = -1;
+} // namespace
+
+namespace sgct {
+
+JobSystem* JobSystem::_instance = nullptr;
+
+JobSystem& JobSystem::instance() {
+    if (!_instance) {
+        _instance = new JobSystem(Settings::instance().numberJobThreads());
+    }
+    return *_instance;
+}
+
+void JobSystem::destroy() {
+    delete _instance;
+    _instance = nullptr;
+}
+
+JobSystem::JobSystem(int nThreads) {
+    Log::Debug(fmt::format("Starting job system with {} threads", nThreads));
+
+    _queues.reserve(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+    _threads.reserve(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        _threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::unique_lock lock(_sleepMutex);
+        _isRunning = false;
+    }
+    _wakeUp.notify_all();
+    for (std::thread& t : _threads) {
+        t.join();
+    }
+}
+
+JobSystem::Handle JobSystem::submit(std::function<void()> job) {
+    Handle handle = std::make_shared<std::atomic<int>>(0);
+    submit(std::move(job), handle);
+    return handle;
+}
+
+void JobSystem::submit(std::function<void()> job, const Handle& handle) {
+    handle->fetch_add(1);
+
+    // Workers push to their own queue to keep nested jobs local, all other threads
+    // distribute their jobs over the queues
+    const size_t index = ThisWorker >= 0 ?
+        static_cast<size_t>(ThisWorker) :
+        _nextQueue.fetch_add(1) % _queues.size();
+    {
+        std::unique_lock lock(_queues[index]->mutex);
+        _queues[index]->jobs.push_back({ std::move(job), handle });
+    }
+    {
+        std::unique_lock lock(_sleepMutex);
+        _nPending++;
+    }
+    _wakeUp.notify_one();
+}
+
+void JobSystem::wait(const Handle& handle) {
+    ZoneScoped
+
+    while (handle->load() > 0) {
+        if (!runJob(ThisWorker)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end,
+                            const std::function<void(size_t)>& function,
+                            size_t grainSize)
+{
+    ZoneScoped
+
+    if (begin >= end) {
+        return;
+    }
+
+    // A few more chunks than threads gives the work stealing a chance to balance uneven
+    // workloads without paying the queueing overhead for every index
+    const size_t n = end - begin;
+    const size_t maxChunks = 4 * (_threads.size() + 1);
+    const size_t nChunks = std::min((n + grainSize - 1) / grainSize, maxChunks);
+    const size_t chunkSize = (n + nChunks - 1) / nChunks;
+
+    auto runChunk = [&function, end](size_t first, size_t last) {
+        for (size_t i = first; i < std::min(last, end); ++i) {
+            function(i);
+        }
+    };
+
+    Handle handle = std::make_shared<std::atomic<int>>(0);
+    for (size_t first = begin + chunkSize; first < end; first += chunkSize) {
+        submit(
+            [runChunk, first, chunkSize]() { runChunk(first, first + chunkSize); },
+            handle
+        );
+    }
+    runChunk(begin, begin + chunkSize);
+    wait(handle);
+}
+
+int JobSystem::numberOfThreads() const {
+    return static_cast<int>(_threads.size());
+}
+
+void JobSystem::workerLoop(int index) {
+    ThisWorker = index;
+    while (_isRunning) {
+        if (runJob(index)) {
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        _wakeUp.wait(lock, [this]() { return _nPending > 0 || !_isRunning; });
+    }
+}
+
+bool JobSystem::runJob(int index) {
+    std::optional<Job> job;
+
+    // Take the most recently added job from our own queue first as its data is most
+    // likely still in the cache, then steal the oldest jobs from the other queues
+    if (index >= 0) {
+        Queue& q = *_queues[index];
+        std::unique_lock lock(q.mutex);
+        if (!q.jobs.empty()) {
+            job = std::move(q.jobs.back());
+            q.jobs.pop_back();
+        }
+    }
+    const size_t nQueues = _queues.size();
+    for (size_t i = 1; i <= nQueues && !job; ++i) {
+        Queue& q = *_queues[(static_cast<size_t>(std::max(index, 0)) + i) % nQueues];
+        std::unique_lock lock(q.mutex);
+        if (!q.jobs.empty()) {
+            job = std::move(q.jobs.front());
+            q.jobs.pop_front();
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+    _nPending--;
+
+    try {
+        job->function();
+    }
+    catch (const std::exception& e) {
+        Log::Error(fmt::format("Exception in job: {}", e.what()));
+    }
+    job->handle->fetch_sub(1);
+    return true;
+}
+
+} // namespace sgct
@@ -0,0 +1,100 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/mappedfile.h>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#define NOMINMAX
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace sgct {
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef WIN32
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    _file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        return;
+    }
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) {
+        return;
+    }
+    void* ptr = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr) {
+        _data = reinterpret_cast<const unsigned char*>(ptr);
+        _size = static_cast<size_t>(size.QuadPart);
+    }
+#else // WIN32
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        return;
+    }
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (ptr != MAP_FAILED) {
+            // All users read the file front to back exactly once
+            madvise(ptr, size, MADV_SEQUENTIAL);
+            _data = reinterpret_cast<const unsigned char*>(ptr);
+            _size = size;
+        }
+    }
+    // The mapping stays valid after the file descriptor has been closed
+    close(file);
+#endif // WIN32
+}
+
+MappedFile::~MappedFile() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping) {
+        CloseHandle(_mapping);
+    }
+    if (_file) {
+        CloseHandle(_file);
+    }
+#else // WIN32
+    if (_data) {
+        munmap(const_cast<unsigned char*>(_data), _size);
+    }
+#endif // WIN32
+}
+
+const unsigned char* MappedFile::data() const {
+    return _data;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+} // namespace sgct
@@ -321,7 +321,7 @@ int Network::iterateFrameCounter() {
     return _currentSendFrame;
 }
 
-void Network::pushClientMessage() {
+void Network::pushClientMessage(float frameInfo) {
     // The servers' render function is locked until an ack message is received
     const int currentFrame = iterateFrameCounter();
     uint32_t localSyncHeaderSize = 0;
@@ -330,7 +330,7 @@ void Network::pushClientMessage() {
     data[0] = Network::DataId;
     std::memcpy(data + 1, &currentFrame, sizeof(currentFrame));
     std::memcpy(data + 5, &localSyncHeaderSize, sizeof(localSyncHeaderSize));
-    std::memset(data + 9, DefaultId, 4);
+    std::memcpy(data + 9, &frameInfo, sizeof(frameInfo));
     sendData(data, HeaderSize);
 }
 
@@ -354,6 +354,10 @@ double Network::loopTime() const {
     return _timeStampTotal;
 }
 
+float Network::frameInfo() const {
+    return _frameInfo;
+}
+
 bool Network::isUpdated() const {
     bool state = false;
     if (_isServer) {
@@ -473,9 +477,7 @@ void Network::updateBuffer(std::vector<char>& buf, uint32_t reqSize, uint32_t& c
     curSize = reqSize;
 }
 
-int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize,
-                             uint32_t& uncompressedDataSize)
-{
+int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSize) {
     int iResult = receiveData(_socket, header, static_cast<int>(HeaderSize), 0);
 
     if (iResult == static_cast<int>(HeaderSize)) {
@@ -483,7 +485,12 @@ int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSiz
         if (_headerId == DataId) {
             std::memcpy(&syncFrame, header + 1, sizeof(syncFrame));
             std::memcpy(&dataSize, header + 5, sizeof(dataSize));
-            std::memcpy(&uncompressedDataSize, header + 9, sizeof(uncompressedDataSize));
+
+            // Sync messages are never compressed, so the last four bytes are used to
+            // transmit additional information about the frame instead
+            float frameInfo;
+            std::memcpy(&frameInfo, header + 9, sizeof(frameInfo));
+            _frameInfo = frameInfo;
 
             setRecvFrame(syncFrame);
             if (syncFrame < 0) {
@@ -497,11 +504,6 @@ int Network::readSyncMessage(char* header, int32_t& syncFrame, uint32_t& dataSiz
 
             // resize buffer if needed
             updateBuffer(_recvBuffer, dataSize, _bufferSize);
-            updateBuffer(
-                _uncompressBuffer,
-                uncompressedDataSize,
-                _uncompressedBufferSize
-            );
         }
     }
 
@@ -640,12 +642,7 @@ void Network::communicationHandler() {
 
         if (type() == ConnectionType::SyncConnection) {
             int32_t syncFrameNumber = -1;
-            iResult = readSyncMessage(
-                RecvHeader,
-                syncFrameNumber,
-                dataSize,
-                uncompressedDataSize
-            );
+            iResult = readSyncMessage(RecvHeader, syncFrameNumber, dataSize);
         }
         else if (type() == ConnectionType::DataTransfer) {
             iResult = readDataTransferMessage(
@@ -411,6 +411,7 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
             unsigned char* dataBlock = SharedData::instance().dataBlock();
             std::memcpy(dataBlock + 1, &currentFrame, sizeof(currentFrame));
             std::memcpy(dataBlock + 5, &currentSize, sizeof(currentSize));
+            std::memcpy(dataBlock + 9, &_resolutionScale, sizeof(_resolutionScale));
 
             connection->sendData(
                 SharedData::instance().dataBlock(),
@@ -427,13 +428,40 @@ std::optional<std::pair<double, double>> NetworkManager::sync(SyncMode sm) {
             if (!connection->isServer() && connection->isConnected()) {
                 // The servers's render function is locked until a message starting with
                 // the ack-byte is received.
-                connection->pushClientMessage();
+                connection->pushClientMessage(_frameCost);
             }
         }
     }
     return std::nullopt;
 }
 
+void NetworkManager::setResolutionScale(float scale) {
+    _resolutionScale = scale;
+}
+
+float NetworkManager::resolutionScale() const {
+    for (Network* connection : _syncConnections) {
+        if (!connection->isServer() && connection->isConnected()) {
+            return connection->frameInfo();
+        }
+    }
+    return 0.f;
+}
+
+void NetworkManager::setFrameCost(float cost) {
+    _frameCost = cost;
+}
+
+float NetworkManager::maxClientFrameCost() const {
+    float cost = 0.f;
+    for (Network* connection : _syncConnections) {
+        if (connection->isServer() && connection->isConnected()) {
+            cost = std::max(cost, connection->frameInfo());
+        }
+    }
+    return cost;
+}
+
 bool NetworkManager::isSyncComplete() const {
     const unsigned int counter = static_cast<unsigned int>(std::count_if(
         _syncConnections.cbegin(),
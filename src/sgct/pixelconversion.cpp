@@ -0,0 +1,443 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/pixelconversion.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__F16C__) || defined(__SSSE3__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    float loadFloat(const unsigned char* p, bool swapBytes) {
+        uint32_t bits;
+        std::memcpy(&bits, p, sizeof(uint32_t));
+        if (swapBytes) {
+            bits = (bits >> 24) | ((bits >> 8) & 0xFF00) | ((bits << 8) & 0xFF0000) |
+                   (bits << 24);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128 byteSwap32(__m128 v) {
+        __m128i i = _mm_castps_si128(v);
+        i = _mm_or_si128(_mm_slli_epi16(i, 8), _mm_srli_epi16(i, 8));
+        i = _mm_or_si128(_mm_slli_epi32(i, 16), _mm_srli_epi32(i, 16));
+        return _mm_castsi128_ps(i);
+    }
+#endif
+
+    float halfToFloat(uint16_t h) {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+        uint32_t exponent = (h >> 10) & 0x1F;
+        uint32_t mantissa = h & 0x3FF;
+
+        uint32_t bits = 0;
+        if (exponent == 0) {
+            if (mantissa != 0) {
+                // Denormalized half; normalize it for the single precision float
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400) == 0) {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                mantissa &= 0x3FF;
+                bits = sign | (exponent << 23) | (mantissa << 13);
+            }
+            else {
+                bits = sign;
+            }
+        }
+        else if (exponent == 0x1F) {
+            // Infinity or NaN
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else {
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(float));
+        return f;
+    }
+
+    unsigned char floatToUnorm8(float f) {
+        // Written so that NaN is clamped to 0
+        const float v = f > 0.f ? (f < 1.f ? f : 1.f) : 0.f;
+        return static_cast<unsigned char>(v * 255.f + 0.5f);
+    }
+
+    // BT.601 limited range coefficients in 8-bit fixed point, in B, G, R order
+    constexpr const int WeightsY[] = { 25, 129, 66 };
+    constexpr const int WeightsU[] = { 112, -74, -38 };
+    constexpr const int WeightsV[] = { -18, -94, 112 };
+
+    unsigned char average(unsigned char a, unsigned char b) {
+        // Rounds up the same way as the _mm_avg_epu8 instruction
+        return static_cast<unsigned char>((a + b + 1) >> 1);
+    }
+
+    int weightedSum(const unsigned char* p, const int* weights) {
+        return weights[0] * p[0] + weights[1] * p[1] + weights[2] * p[2];
+    }
+
+    unsigned char lumaValue(const unsigned char* p) {
+        return static_cast<unsigned char>(((weightedSum(p, WeightsY) + 128) >> 8) + 16);
+    }
+
+    unsigned char chromaValue(const unsigned char* p, const int* weights) {
+        return static_cast<unsigned char>(((weightedSum(p, weights) + 128) >> 8) + 128);
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // Loads four pixels and expands them to 32 bits each; the fourth byte of each pixel
+    // is undefined for 3 channel images. For 3 channels, 16 bytes are read
+    __m128i loadPixels(const unsigned char* p, [[maybe_unused]] int channels) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+#if defined(__SSSE3__) || defined(__AVX2__)
+        if (channels == 3) {
+            const __m128i mask = _mm_setr_epi8(
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+            );
+            return _mm_shuffle_epi8(v, mask);
+        }
+#endif
+        return v;
+    }
+
+    // Computes the weighted sum of the first three channels for each of four pixels
+    __m128i weightedSum4(__m128i pixels, __m128i weights) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+        const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+        // Each pixel is spread over two neighboring lanes that have to be added up
+        const __m128i sumLo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+        const __m128i sumHi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+        return _mm_unpacklo_epi64(
+            _mm_shuffle_epi32(sumLo, _MM_SHUFFLE(3, 3, 2, 0)),
+            _mm_shuffle_epi32(sumHi, _MM_SHUFFLE(3, 3, 2, 0))
+        );
+    }
+
+    // Converts two sets of four weighted sums into eight bytes in the lower half
+    __m128i packSums(__m128i a, __m128i b, short offset) {
+        const __m128i round = _mm_set1_epi32(128);
+        a = _mm_srai_epi32(_mm_add_epi32(a, round), 8);
+        b = _mm_srai_epi32(_mm_add_epi32(b, round), 8);
+        const __m128i v = _mm_add_epi16(_mm_packs_epi32(a, b), _mm_set1_epi16(offset));
+        return _mm_packus_epi16(v, v);
+    }
+
+    __m128i weights(const int* w) {
+        return _mm_setr_epi16(
+            static_cast<short>(w[0]), static_cast<short>(w[1]), static_cast<short>(w[2]),
+            0,
+            static_cast<short>(w[0]), static_cast<short>(w[1]), static_cast<short>(w[2]),
+            0
+        );
+    }
+
+    // Averages the pixel pairs (0, 1) and (2, 3) of two sets of four pixels and returns
+    // the four resulting pixels
+    __m128i averagePairs(__m128i a, __m128i b) {
+        const __m128i avgA = _mm_avg_epu8(a, _mm_srli_epi64(a, 32));
+        const __m128i avgB = _mm_avg_epu8(b, _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi64(
+            _mm_shuffle_epi32(avgA, _MM_SHUFFLE(3, 3, 2, 0)),
+            _mm_shuffle_epi32(avgB, _MM_SHUFFLE(3, 3, 2, 0))
+        );
+    }
+#endif
+} // namespace
+
+namespace sgct {
+
+void swapRedBlue(unsigned char* data, size_t nPixels, int channels) {
+    if (channels < 3) {
+        return;
+    }
+
+    size_t i = 0;
+    if (channels == 4) {
+#if defined(__AVX2__)
+        const __m256i mask = _mm256_setr_epi8(
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+        );
+        for (; i + 8 <= nPixels; i += 8) {
+            __m256i* p = reinterpret_cast<__m256i*>(data + i * 4);
+            _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+        }
+#elif defined(__SSSE3__)
+        const __m128i mask = _mm_setr_epi8(
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+        );
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+            _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        // Without a byte shuffle, the channels are moved with shifts on 32-bit pixels
+        const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+        const __m128i low = _mm_set1_epi32(0x000000FF);
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+            const __m128i v = _mm_loadu_si128(p);
+            const __m128i r = _mm_or_si128(
+                _mm_and_si128(v, keep),
+                _mm_or_si128(
+                    _mm_and_si128(_mm_srli_epi32(v, 16), low),
+                    _mm_slli_epi32(_mm_and_si128(v, low), 16)
+                )
+            );
+            _mm_storeu_si128(p, r);
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 16 <= nPixels; i += 16) {
+            uint8x16x4_t v = vld4q_u8(data + i * 4);
+            std::swap(v.val[0], v.val[2]);
+            vst4q_u8(data + i * 4, v);
+        }
+#endif
+    }
+    else if (channels == 3) {
+#if defined(__SSSE3__) || defined(__AVX2__)
+        // Five pixels are swapped per iteration; the 16th byte is loaded and stored
+        // unchanged, so we need to stay one byte away from the end of the buffer
+        const __m128i mask = _mm_setr_epi8(
+            2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15
+        );
+        for (; (i + 5) * 3 + 1 <= nPixels * 3; i += 5) {
+            __m128i* p = reinterpret_cast<__m128i*>(data + i * 3);
+            _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 16 <= nPixels; i += 16) {
+            uint8x16x3_t v = vld3q_u8(data + i * 3);
+            std::swap(v.val[0], v.val[2]);
+            vst3q_u8(data + i * 3, v);
+        }
+#endif
+    }
+
+    for (; i < nPixels; ++i) {
+        unsigned char* p = data + i * channels;
+        std::swap(p[0], p[2]);
+    }
+}
+
+void byteSwap16(uint16_t* data, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= n; i += 16) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        const __m256i v = _mm256_loadu_si256(p);
+        _mm256_storeu_si256(
+            p,
+            _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8))
+        );
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 8 <= n; i += 8) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        const __m128i v = _mm_loadu_si128(p);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint8_t* p = reinterpret_cast<uint8_t*>(data + i);
+        vst1q_u8(p, vrev16q_u8(vld1q_u8(p)));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        data[i] = static_cast<uint16_t>((data[i] << 8) | (data[i] >> 8));
+    }
+}
+
+void deinterleaveRG32F(float* r, float* g, const unsigned char* src, size_t nPixels,
+                       bool swapBytes)
+{
+    constexpr const size_t PixelSize = 3 * sizeof(float);
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= nPixels; i += 4) {
+        // a = [r0 g0 b0 r1], b = [g1 b1 r2 g2], c = [b2 r3 g3 b3]
+        const float* p = reinterpret_cast<const float*>(src + i * PixelSize);
+        const __m128 a = _mm_loadu_ps(p);
+        const __m128 b = _mm_loadu_ps(p + 4);
+        const __m128 c = _mm_loadu_ps(p + 8);
+        // u = [r2 g2 r3 g3], w = [g0 g0 g1 g1]
+        const __m128 u = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+        const __m128 w = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+        __m128 vr = _mm_shuffle_ps(a, u, _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 vg = _mm_shuffle_ps(w, u, _MM_SHUFFLE(3, 1, 2, 0));
+        if (swapBytes) {
+            vr = byteSwap32(vr);
+            vg = byteSwap32(vg);
+        }
+        _mm_storeu_ps(r + i, vr);
+        _mm_storeu_ps(g + i, vg);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= nPixels; i += 4) {
+        const float32x4x3_t v = vld3q_f32(
+            reinterpret_cast<const float*>(src + i * PixelSize)
+        );
+        float32x4_t vr = v.val[0];
+        float32x4_t vg = v.val[1];
+        if (swapBytes) {
+            vr = vreinterpretq_f32_u8(vrev32q_u8(vreinterpretq_u8_f32(vr)));
+            vg = vreinterpretq_f32_u8(vrev32q_u8(vreinterpretq_u8_f32(vg)));
+        }
+        vst1q_f32(r + i, vr);
+        vst1q_f32(g + i, vg);
+    }
+#endif
+
+    for (; i < nPixels; ++i) {
+        r[i] = loadFloat(src + i * PixelSize, swapBytes);
+        g[i] = loadFloat(src + i * PixelSize + sizeof(float), swapBytes);
+    }
+}
+
+void halfToUnorm8(unsigned char* dst, const uint16_t* src, size_t n) {
+    size_t i = 0;
+#if defined(__F16C__) && defined(__AVX2__)
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 scale = _mm256_set1_ps(255.f);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m256 f = _mm256_cvtph_ps(h);
+        // max/min return the second operand for NaN, which clamps NaN to 0
+        f = _mm256_min_ps(_mm256_max_ps(f, zero), one);
+        const __m256i v = _mm256_cvtps_epi32(_mm256_mul_ps(f, scale));
+        const __m128i v16 = _mm_packus_epi32(
+            _mm256_castsi256_si128(v),
+            _mm256_extracti128_si256(v, 1)
+        );
+        const __m128i v8 = _mm_packus_epi16(v16, v16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), v8);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t one = vdupq_n_f32(1.f);
+    const float32x4_t scale = vdupq_n_f32(255.f);
+    for (; i + 8 <= n; i += 8) {
+        const uint16x8_t h = vld1q_u16(src + i);
+        float32x4_t lo = vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(h)));
+        float32x4_t hi = vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(h)));
+        lo = vminq_f32(vmaxq_f32(lo, zero), one);
+        hi = vminq_f32(vmaxq_f32(hi, zero), one);
+        const uint32x4_t l = vcvtnq_u32_f32(vmulq_f32(lo, scale));
+        const uint32x4_t u = vcvtnq_u32_f32(vmulq_f32(hi, scale));
+        const uint16x8_t v16 = vcombine_u16(vmovn_u32(l), vmovn_u32(u));
+        vst1_u8(dst + i, vmovn_u16(v16));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        dst[i] = floatToUnorm8(halfToFloat(src[i]));
+    }
+}
+
+void bgrToYuv420(const unsigned char* src, int width, int height, int channels,
+                 unsigned char* y, unsigned char* u, unsigned char* v)
+{
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    auto row = [src, height, rowSize](int r) { return src + (height - 1 - r) * rowSize; };
+
+    // Eight pixels are processed per iteration. The 3 channel pixels are loaded with two
+    // 16 byte loads that reach 4 bytes beyond the pixels, so we have to stop earlier
+    int vectorPixels = width + 1;
+#if defined(__SSSE3__) || defined(__AVX2__)
+    vectorPixels = channels == 4 ? 8 : 10;
+#elif defined(__SSE2__) || defined(_M_X64)
+    vectorPixels = channels == 4 ? 8 : width + 1;
+#endif
+
+    for (int r = 0; r < height; ++r) {
+        const unsigned char* p = row(r);
+        unsigned char* dst = y + static_cast<size_t>(r) * width;
+        int x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i wY = weights(WeightsY);
+        for (; x + vectorPixels <= width; x += 8) {
+            const __m128i a = weightedSum4(loadPixels(p + x * channels, channels), wY);
+            const __m128i b =
+                weightedSum4(loadPixels(p + (x + 4) * channels, channels), wY);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), packSums(a, b, 16));
+        }
+#endif
+        for (; x < width; ++x) {
+            dst[x] = lumaValue(p + x * channels);
+        }
+    }
+
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    for (int r = 0; r < chromaHeight; ++r) {
+        const unsigned char* p0 = row(2 * r);
+        const unsigned char* p1 = row(std::min(2 * r + 1, height - 1));
+        unsigned char* dstU = u + static_cast<size_t>(r) * chromaWidth;
+        unsigned char* dstV = v + static_cast<size_t>(r) * chromaWidth;
+        int x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i wU = weights(WeightsU);
+        const __m128i wV = weights(WeightsV);
+        for (; 2 * x + vectorPixels <= width; x += 4) {
+            const size_t offset = static_cast<size_t>(2 * x) * channels;
+            const __m128i a = _mm_avg_epu8(
+                loadPixels(p0 + offset, channels),
+                loadPixels(p1 + offset, channels)
+            );
+            const __m128i b = _mm_avg_epu8(
+                loadPixels(p0 + offset + 4 * channels, channels),
+                loadPixels(p1 + offset + 4 * channels, channels)
+            );
+            const __m128i c = averagePairs(a, b);
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i resU = packSums(weightedSum4(c, wU), zero, 128);
+            const __m128i resV = packSums(weightedSum4(c, wV), zero, 128);
+            const int valU = _mm_cvtsi128_si32(resU);
+            const int valV = _mm_cvtsi128_si32(resV);
+            std::memcpy(dstU + x, &valU, sizeof(int));
+            std::memcpy(dstV + x, &valV, sizeof(int));
+        }
+#endif
+        for (; x < chromaWidth; ++x) {
+            const int x0 = 2 * x;
+            const int x1 = std::min(2 * x + 1, width - 1);
+            std::array<unsigned char, 3> c;
+            for (int i = 0; i < 3; ++i) {
+                c[i] = average(
+                    average(p0[x0 * channels + i], p1[x0 * channels + i]),
+                    average(p0[x1 * channels + i], p1[x1 * channels + i])
+                );
+            }
+            dstU[x] = chromaValue(c.data(), WeightsU);
+            dstV[x] = chromaValue(c.data(), WeightsV);
+        }
+    }
+}
+
+} // namespace sgct
@@ -20,6 +20,7 @@
 #pragma warning(pop)
 #endif // WIN32
 
+#include <cmath>
 #include <cstring>
 
 namespace sgct {
@@ -36,51 +37,53 @@ namespace {
 void Projection::calculateProjection(vec3 base, const ProjectionPlane& proj,
                                      float nearClip, float farClip, vec3 offset)
 {
+    auto equal = [](const vec3& a, const vec3& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    };
+
+    // Tracked viewports are updated every frame, but most of the time neither the user
+    // nor the projection plane have moved
+    if (_parameters.has_value() &&
+        equal(_parameters->base, base) && equal(_parameters->offset, offset) &&
+        equal(_parameters->lowerLeft, proj.coordinateLowerLeft()) &&
+        equal(_parameters->upperLeft, proj.coordinateUpperLeft()) &&
+        equal(_parameters->upperRight, proj.coordinateUpperRight()) &&
+        _parameters->nearClip == nearClip && _parameters->farClip == farClip)
+    {
+        return;
+    }
+    _parameters = Parameters{
+        base,
+        offset,
+        proj.coordinateLowerLeft(),
+        proj.coordinateUpperLeft(),
+        proj.coordinateUpperRight(),
+        nearClip,
+        farClip
+    };
+
+    // The rotation into the plane's coordinate system only depends on the plane and is
+    // cached there
+    const ProjectionPlane::Basis& basis = proj.basis();
+    const glm::mat4 worldToPlane = glm::make_mat4(basis.worldToPlane.values);
     const glm::vec3 b = glm::make_vec3(&base.x);
     const glm::vec3 o = glm::make_vec3(&offset.x);
-
-    const glm::vec3 lowerLeft = glm::make_vec3(&proj.coordinateLowerLeft().x);
-    const glm::vec3 upperLeft = glm::make_vec3(&proj.coordinateUpperLeft().x);
-    const glm::vec3 upperRight = glm::make_vec3(&proj.coordinateUpperRight().x);
-
-    // calculate viewplane's internal coordinate system bases
-    const glm::vec3 planeX = glm::normalize(upperRight - upperLeft);
-    const glm::vec3 planeY = glm::normalize(upperLeft - lowerLeft);
-    const glm::vec3 planeZ = glm::normalize(glm::cross(planeX, planeY));
-
-    // calculate plane rotation using Direction Cosine Matrix (DCM)
-    glm::mat3 dcm;
-    dcm[0][0] = glm::dot(planeX, glm::vec3(1.f, 0.f, 0.f));
-    dcm[0][1] = glm::dot(planeX, glm::vec3(0.f, 1.f, 0.f));
-    dcm[0][2] = glm::dot(planeX, glm::vec3(0.f, 0.f, 1.f));
-
-    dcm[1][0] = glm::dot(planeY, glm::vec3(1.f, 0.f, 0.f));
-    dcm[1][1] = glm::dot(planeY, glm::vec3(0.f, 1.f, 0.f));
-    dcm[1][2] = glm::dot(planeY, glm::vec3(0.f, 0.f, 1.f));
-
-    dcm[2][0] = glm::dot(planeZ, glm::vec3(1.f, 0.f, 0.f));
-    dcm[2][1] = glm::dot(planeZ, glm::vec3(0.f, 1.f, 0.f));
-    dcm[2][2] = glm::dot(planeZ, glm::vec3(0.f, 0.f, 1.f));
-
-    // invert & transform
-    const glm::mat3 invDcm = glm::inverse(dcm);
-    const glm::vec3 viewPlaneLowerLeft = invDcm * lowerLeft;
-    const glm::vec3 viewPlaneUpperRight = invDcm * upperRight;
-    const glm::vec3 eyePos = invDcm * b;
+    const glm::vec3 eyePos = glm::vec3(worldToPlane * glm::vec4(b, 1.f));
 
     // nearFactor = near clipping plane / focus plane dist
-    const float nearF = std::fabs(nearClip / (viewPlaneLowerLeft.z - eyePos.z));
+    const float nearF = std::fabs(nearClip / (basis.lowerLeft.z - eyePos.z));
 
-    _frustum.left = (viewPlaneLowerLeft.x - eyePos.x) * nearF;
-    _frustum.right = (viewPlaneUpperRight.x - eyePos.x) * nearF;
-    _frustum.bottom = (viewPlaneLowerLeft.y - eyePos.y) * nearF;
-    _frustum.top = (viewPlaneUpperRight.y - eyePos.y) * nearF;
+    _frustum.left = (basis.lowerLeft.x - eyePos.x) * nearF;
+    _frustum.right = (basis.upperRight.x - eyePos.x) * nearF;
+    _frustum.bottom = (basis.lowerLeft.y - eyePos.y) * nearF;
+    _frustum.top = (basis.upperRight.y - eyePos.y) * nearF;
     _frustum.nearPlane = nearClip;
     _frustum.farPlane = farClip;
 
-    _viewMatrix = fromGLM<glm::mat4, mat4>(
-        glm::mat4(invDcm) * glm::translate(glm::mat4(1.f), -(b + o))
-    );
+    // Equivalent to worldToPlane * translate(-(b + o)) without the matrix product
+    glm::mat4 view = worldToPlane;
+    view[3] = worldToPlane * glm::vec4(-(b + o), 1.f);
+    _viewMatrix = fromGLM<glm::mat4, mat4>(view);
 
     // calc frustum matrix
     _projectionMatrix = fromGLM<glm::mat4, mat4>(
@@ -59,6 +59,8 @@ void NonLinearProjection::initialize(unsigned int internalFormat, unsigned int f
 
     initViewports();
     initTextures();
+    // generating the cubemap might have clamped the resolution to the supported maximum
+    _unscaledCubemapResolution = _cubemapResolution;
     initFBO();
     initVBO();
     initShaders();
@@ -94,6 +96,33 @@ void NonLinearProjection::setCubemapResolution(int resolution) {
     _cubemapResolution.y = resolution;
 }
 
+void NonLinearProjection::setResolutionScale(float scale) {
+    ZoneScoped
+
+    const ivec2 res = ivec2{
+        std::max(static_cast<int>(_unscaledCubemapResolution.x * scale + 0.5f), 1),
+        std::max(static_cast<int>(_unscaledCubemapResolution.y * scale + 0.5f), 1)
+    };
+    if (res.x == _cubemapResolution.x && res.y == _cubemapResolution.y) {
+        return;
+    }
+
+    _cubemapResolution = res;
+    if (!_cubeMapFbo) {
+        // Not initialized yet, so the new resolution will be picked up in initialize
+        return;
+    }
+
+    initTextures();
+    _cubeMapFbo->resizeFBO(_cubemapResolution.x, _cubemapResolution.y, _samples);
+    // The shaders of the cubic interpolation depend on the cubemap resolution
+    initShaders();
+
+    Log::Debug(fmt::format(
+        "Cubemap resolution scaled to {}x{}", _cubemapResolution.x, _cubemapResolution.y
+    ));
+}
+
 void NonLinearProjection::setInterpolationMode(InterpolationMode im) {
     _interpolationMode = im;
 }
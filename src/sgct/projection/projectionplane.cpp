@@ -8,6 +8,9 @@
 
 #include <sgct/projection/projectionplane.h>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 #include <utility>
 
 // @TODO (abock, 2019-10-15) There seems to be an issue with the rendering of the
@@ -15,6 +18,15 @@
 
 namespace sgct {
 
+namespace {
+    template <typename From, typename To>
+    To fromGLM(From v) {
+        To r;
+        std::memcpy(&r, glm::value_ptr(v), sizeof(To));
+        return r;
+    }
+} // namespace
+
 void ProjectionPlane::offset(const vec3& p) {
     _lowerLeft.x += p.x;
     _lowerLeft.y += p.y;
@@ -27,12 +39,16 @@ void ProjectionPlane::offset(const vec3& p) {
     _upperRight.x += p.x;
     _upperRight.y += p.y;
     _upperRight.z += p.z;
+
+    _basis = std::nullopt;
 }
 
 void ProjectionPlane::setCoordinates(vec3 lowerLeft, vec3 upperLeft, vec3 upperRight) {
     _lowerLeft = std::move(lowerLeft);
     _upperLeft = std::move(upperLeft);
     _upperRight = std::move(upperRight);
+
+    _basis = std::nullopt;
 }
 
 const vec3& ProjectionPlane::coordinateLowerLeft() const {
@@ -47,4 +63,34 @@ const vec3& ProjectionPlane::coordinateUpperRight() const {
     return _upperRight;
 }
 
+const ProjectionPlane::Basis& ProjectionPlane::basis() const {
+    if (_basis.has_value()) {
+        return *_basis;
+    }
+
+    const glm::vec3 lowerLeft = glm::make_vec3(&_lowerLeft.x);
+    const glm::vec3 upperLeft = glm::make_vec3(&_upperLeft.x);
+    const glm::vec3 upperRight = glm::make_vec3(&_upperRight.x);
+
+    // calculate viewplane's internal coordinate system bases
+    const glm::vec3 planeX = glm::normalize(upperRight - upperLeft);
+    const glm::vec3 planeY = glm::normalize(upperLeft - lowerLeft);
+    const glm::vec3 planeZ = glm::normalize(glm::cross(planeX, planeY));
+
+    // calculate plane rotation using Direction Cosine Matrix (DCM). The columns of the
+    // DCM are the dot products of the plane axes with the world axes, that is the axes
+    // themselves
+    const glm::mat3 dcm = glm::mat3(planeX, planeY, planeZ);
+
+    // invert & transform
+    const glm::mat3 invDcm = glm::inverse(dcm);
+
+    Basis basis;
+    basis.worldToPlane = fromGLM<glm::mat4, mat4>(glm::mat4(invDcm));
+    basis.lowerLeft = fromGLM<glm::vec3, vec3>(invDcm * lowerLeft);
+    basis.upperRight = fromGLM<glm::vec3, vec3>(invDcm * upperRight);
+    _basis = basis;
+    return *_basis;
+}
+
 } // namespace sgct
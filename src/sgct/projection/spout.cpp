@@ -94,6 +94,8 @@ SpoutOutputProjection::~SpoutOutputProjection() {
     glDeleteFramebuffers(1, &_blitFbo);
 }
 
+void SpoutOutputProjection::setResolutionScale(float) {}
+
 void SpoutOutputProjection::update(vec2) {
     glBindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
@@ -412,6 +412,8 @@ void SpoutFlatProjection::renderCubemap(Window& window, Frustum::Mode frustumMod
 
 void SpoutFlatProjection::update(vec2) {}
 
+void SpoutFlatProjection::setResolutionScale(float) {}
+
 void SpoutFlatProjection::initVBO() {}
 
 void SpoutFlatProjection::initViewports() {
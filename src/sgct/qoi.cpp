@@ -0,0 +1,268 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/qoi.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    constexpr const std::array<unsigned char, 4> Magic = { 'q', 'o', 'i', 'f' };
+    constexpr const size_t HeaderSize = 14;
+    constexpr const std::array<unsigned char, 8> EndMarker = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+    // Upper limit of the image size that protects against corrupt headers
+    constexpr const uint64_t MaxPixels = 400'000'000;
+
+    constexpr const unsigned char OpIndex = 0x00;
+    constexpr const unsigned char OpDiff = 0x40;
+    constexpr const unsigned char OpLuma = 0x80;
+    constexpr const unsigned char OpRun = 0xC0;
+    constexpr const unsigned char OpRGB = 0xFE;
+    constexpr const unsigned char OpRGBA = 0xFF;
+    constexpr const unsigned char OpMask = 0xC0;
+    constexpr const int MaxRun = 62;
+
+    struct Pixel {
+        unsigned char r = 0;
+        unsigned char g = 0;
+        unsigned char b = 0;
+        unsigned char a = 255;
+
+        bool operator==(const Pixel& rhs) const {
+            return r == rhs.r && g == rhs.g && b == rhs.b && a == rhs.a;
+        }
+        bool operator!=(const Pixel& rhs) const { return !(*this == rhs); }
+    };
+
+    int hash(const Pixel& p) {
+        return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+    }
+
+    void write32(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v >> 24);
+        p[1] = static_cast<unsigned char>(v >> 16);
+        p[2] = static_cast<unsigned char>(v >> 8);
+        p[3] = static_cast<unsigned char>(v);
+    }
+
+    uint32_t read32(const unsigned char* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+            (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+} // namespace
+
+namespace sgct {
+
+std::vector<unsigned char> encodeQOI(const unsigned char* pixels, int width, int height,
+                                     int channels)
+{
+    // Every pixel needs at most 5 bytes (OpRGBA)
+    const size_t nPixels = static_cast<size_t>(width) * height;
+    std::vector<unsigned char> res(
+        HeaderSize + nPixels * (channels + 1) + EndMarker.size()
+    );
+    unsigned char* out = res.data();
+
+    std::memcpy(out, Magic.data(), Magic.size());
+    write32(out + 4, static_cast<uint32_t>(width));
+    write32(out + 8, static_cast<uint32_t>(height));
+    out[12] = static_cast<unsigned char>(channels);
+    out[13] = 0; // sRGB with linear alpha
+    out += HeaderSize;
+
+    // The index starts out as transparent black, unlike the previous pixel
+    std::array<Pixel, 64> index;
+    index.fill(Pixel{ 0, 0, 0, 0 });
+    Pixel prev;
+    int run = 0;
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height; ++y) {
+        // The file is stored top to bottom, our pixel data bottom to top
+        const unsigned char* row = pixels + (height - 1 - y) * rowSize;
+        for (int x = 0; x < width; ++x) {
+            const unsigned char* p = row + x * channels;
+            Pixel px;
+            px.r = p[2];
+            px.g = p[1];
+            px.b = p[0];
+            px.a = channels == 4 ? p[3] : prev.a;
+
+            if (px == prev) {
+                run++;
+                if (run == MaxRun) {
+                    *out++ = static_cast<unsigned char>(OpRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                *out++ = static_cast<unsigned char>(OpRun | (run - 1));
+                run = 0;
+            }
+
+            const int h = hash(px);
+            if (index[h] == px) {
+                *out++ = static_cast<unsigned char>(OpIndex | h);
+            }
+            else {
+                index[h] = px;
+
+                if (px.a == prev.a) {
+                    const signed char vr = static_cast<signed char>(px.r - prev.r);
+                    const signed char vg = static_cast<signed char>(px.g - prev.g);
+                    const signed char vb = static_cast<signed char>(px.b - prev.b);
+                    const signed char vgr = static_cast<signed char>(vr - vg);
+                    const signed char vgb = static_cast<signed char>(vb - vg);
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        *out++ = static_cast<unsigned char>(
+                            OpDiff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)
+                        );
+                    }
+                    else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 &&
+                             vgb > -9 && vgb < 8)
+                    {
+                        *out++ = static_cast<unsigned char>(OpLuma | (vg + 32));
+                        *out++ = static_cast<unsigned char>((vgr + 8) << 4 | (vgb + 8));
+                    }
+                    else {
+                        *out++ = OpRGB;
+                        *out++ = px.r;
+                        *out++ = px.g;
+                        *out++ = px.b;
+                    }
+                }
+                else {
+                    *out++ = OpRGBA;
+                    *out++ = px.r;
+                    *out++ = px.g;
+                    *out++ = px.b;
+                    *out++ = px.a;
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0) {
+        *out++ = static_cast<unsigned char>(OpRun | (run - 1));
+    }
+
+    std::memcpy(out, EndMarker.data(), EndMarker.size());
+    out += EndMarker.size();
+    res.resize(out - res.data());
+    return res;
+}
+
+std::optional<QOIInfo> readQOIHeader(const unsigned char* data, size_t size) {
+    if (size < HeaderSize + EndMarker.size() ||
+        std::memcmp(data, Magic.data(), Magic.size()) != 0)
+    {
+        return std::nullopt;
+    }
+
+    const uint32_t width = read32(data + 4);
+    const uint32_t height = read32(data + 8);
+    const int channels = data[12];
+    if (width == 0 || height == 0 || (channels != 3 && channels != 4) ||
+        static_cast<uint64_t>(width) * height > MaxPixels)
+    {
+        return std::nullopt;
+    }
+
+    QOIInfo info;
+    info.width = static_cast<int>(width);
+    info.height = static_cast<int>(height);
+    info.channels = channels;
+    return info;
+}
+
+bool decodeQOI(const unsigned char* data, size_t size, unsigned char* pixels) {
+    const std::optional<QOIInfo> info = readQOIHeader(data, size);
+    if (!info) {
+        return false;
+    }
+
+    const int channels = info->channels;
+    const size_t rowSize = static_cast<size_t>(info->width) * channels;
+    const unsigned char* in = data + HeaderSize;
+    const unsigned char* end = data + size - EndMarker.size();
+
+    // The index starts out as transparent black, unlike the previous pixel
+    std::array<Pixel, 64> index;
+    index.fill(Pixel{ 0, 0, 0, 0 });
+    Pixel px;
+    int run = 0;
+    for (int y = 0; y < info->height; ++y) {
+        unsigned char* row = pixels + (info->height - 1 - y) * rowSize;
+        for (int x = 0; x < info->width; ++x) {
+            if (run > 0) {
+                run--;
+            }
+            else {
+                if (in >= end) {
+                    return false;
+                }
+
+                const unsigned char b1 = *in++;
+                if (b1 == OpRGB) {
+                    if (end - in < 3) {
+                        return false;
+                    }
+                    px.r = *in++;
+                    px.g = *in++;
+                    px.b = *in++;
+                }
+                else if (b1 == OpRGBA) {
+                    if (end - in < 4) {
+                        return false;
+                    }
+                    px.r = *in++;
+                    px.g = *in++;
+                    px.b = *in++;
+                    px.a = *in++;
+                }
+                else if ((b1 & OpMask) == OpIndex) {
+                    px = index[b1];
+                }
+                else if ((b1 & OpMask) == OpDiff) {
+                    px.r = static_cast<unsigned char>(px.r + ((b1 >> 4) & 0x03) - 2);
+                    px.g = static_cast<unsigned char>(px.g + ((b1 >> 2) & 0x03) - 2);
+                    px.b = static_cast<unsigned char>(px.b + (b1 & 0x03) - 2);
+                }
+                else if ((b1 & OpMask) == OpLuma) {
+                    if (in >= end) {
+                        return false;
+                    }
+                    const unsigned char b2 = *in++;
+                    const int vg = (b1 & 0x3F) - 32;
+                    px.r = static_cast<unsigned char>(px.r + vg - 8 + ((b2 >> 4) & 0x0F));
+                    px.g = static_cast<unsigned char>(px.g + vg);
+                    px.b = static_cast<unsigned char>(px.b + vg - 8 + (b2 & 0x0F));
+                }
+                else {
+                    run = b1 & 0x3F;
+                }
+                index[hash(px)] = px;
+            }
+
+            unsigned char* p = row + x * channels;
+            p[0] = px.b;
+            p[1] = px.g;
+            p[2] = px.r;
+            if (channels == 4) {
+                p[3] = px.a;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace sgct
@@ -0,0 +1,254 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/rawcapture.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#define NOMINMAX
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+#define Err(code, msg) Error(Error::Component::Image, code, msg)
+
+namespace {
+    // Every file starts with this identifier followed by the version number and padding
+    constexpr const std::array<char, 8> FileId = { 'S', 'G', 'C', 'T', 'R', 'A', 'W', 0 };
+    constexpr const uint32_t FileVersion = 1;
+    constexpr const uint64_t FileHeaderSize = 16;
+
+    // Frames start on cache line boundaries to keep the copies aligned
+    constexpr const uint64_t FrameAlignment = 64;
+
+    uint64_t frameSize(const sgct::RawFrameHeader& header) {
+        const uint64_t size = sizeof(sgct::RawFrameHeader) + header.dataSize;
+        return (size + FrameAlignment - 1) / FrameAlignment * FrameAlignment;
+    }
+} // namespace
+
+namespace sgct {
+
+RawCaptureWriter::RawCaptureWriter(std::string path, uint64_t growSize)
+    : _path(std::move(path))
+    , _growSize(std::max(growSize, FileHeaderSize))
+{
+#ifdef WIN32
+    _file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        0,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (_file == INVALID_HANDLE_VALUE) {
+        _file = nullptr;
+        throw Err(9015, fmt::format("Could not open raw capture file '{}'", _path));
+    }
+#else // WIN32
+    _file = open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (_file == -1) {
+        throw Err(9015, fmt::format("Could not open raw capture file '{}'", _path));
+    }
+#endif // WIN32
+
+    map(_growSize);
+
+    std::memcpy(_mapping, FileId.data(), FileId.size());
+    std::memcpy(_mapping + FileId.size(), &FileVersion, sizeof(FileVersion));
+    _writeOffset = FileHeaderSize;
+
+    Log::Info(fmt::format("Capturing raw frames to '{}'", _path));
+}
+
+RawCaptureWriter::~RawCaptureWriter() {
+    unmap();
+
+    // Remove the preallocated space that was not used. If the file could not be grown,
+    // the offset points past the end of the file
+    const uint64_t end = std::min(_writeOffset, _fileSize);
+#ifdef WIN32
+    if (_file) {
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(end);
+        SetFilePointerEx(_file, size, nullptr, FILE_BEGIN);
+        SetEndOfFile(_file);
+        CloseHandle(_file);
+    }
+#else // WIN32
+    if (_file != -1) {
+        if (ftruncate(_file, static_cast<off_t>(end)) != 0) {
+            Log::Warning(fmt::format("Could not truncate raw capture file '{}'", _path));
+        }
+        close(_file);
+    }
+#endif // WIN32
+}
+
+void RawCaptureWriter::append(const RawFrameHeader& header, const unsigned char* data) {
+    ZoneScoped
+
+    const uint64_t size = frameSize(header);
+    uint64_t offset = 0;
+    {
+        std::unique_lock lock(_offsetMutex);
+        offset = _writeOffset;
+        _writeOffset += size;
+    }
+
+    std::shared_lock lock(_mappingMutex);
+    if (offset + size > _fileSize) {
+        lock.unlock();
+        {
+            std::unique_lock growLock(_mappingMutex);
+            // Another thread might have grown the file while we were waiting for the lock
+            if (!_hasFailed && offset + size > _fileSize) {
+                try {
+                    map(std::max(offset + size, _fileSize + _growSize));
+                }
+                catch (const Error&) {
+                    // Later frames would be stored after a gap that ends the reading, so
+                    // the file is not grown any further
+                    _hasFailed = true;
+                    throw;
+                }
+            }
+        }
+        lock.lock();
+
+        if (offset + size > _fileSize) {
+            throw Err(
+                9024,
+                fmt::format(
+                    "Dropped frame {} as raw capture file '{}' could not be grown",
+                    header.frameNumber, _path
+                )
+            );
+        }
+    }
+
+    std::memcpy(_mapping + offset, &header, sizeof(RawFrameHeader));
+    std::memcpy(_mapping + offset + sizeof(RawFrameHeader), data, header.dataSize);
+}
+
+void RawCaptureWriter::map(uint64_t size) {
+    ZoneScoped
+
+    // The new mapping is created before the old one is released, so that the writer
+    // keeps a valid mapping if the file cannot be grown
+    unsigned char* mapping = nullptr;
+#ifdef WIN32
+    const DWORD high = static_cast<DWORD>(size >> 32);
+    const DWORD low = static_cast<DWORD>(size & 0xFFFFFFFF);
+    // Creating a mapping that is larger than the file extends the file
+    void* fileMapping =
+        CreateFileMappingA(_file, nullptr, PAGE_READWRITE, high, low, nullptr);
+    if (fileMapping) {
+        mapping = reinterpret_cast<unsigned char*>(
+            MapViewOfFile(fileMapping, FILE_MAP_WRITE, 0, 0, 0)
+        );
+        if (!mapping) {
+            CloseHandle(fileMapping);
+        }
+    }
+#else // WIN32
+#ifdef __linux__
+    // Allocate the blocks up front, ftruncate would only create a sparse file
+    const int res = posix_fallocate(_file, 0, static_cast<off_t>(size));
+#else // __linux__
+    const int res = ftruncate(_file, static_cast<off_t>(size));
+#endif // __linux__
+    if (res == 0) {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+        mapping = ptr == MAP_FAILED ? nullptr : reinterpret_cast<unsigned char*>(ptr);
+    }
+#endif // WIN32
+
+    if (!mapping) {
+        throw Err(
+            9016,
+            fmt::format("Could not map {} bytes of raw capture file '{}'", size, _path)
+        );
+    }
+
+    unmap();
+    _mapping = mapping;
+#ifdef WIN32
+    _fileMapping = fileMapping;
+#endif // WIN32
+    _fileSize = size;
+}
+
+void RawCaptureWriter::unmap() {
+    if (!_mapping) {
+        return;
+    }
+
+#ifdef WIN32
+    UnmapViewOfFile(_mapping);
+    CloseHandle(_fileMapping);
+    _fileMapping = nullptr;
+#else // WIN32
+    munmap(_mapping, _fileSize);
+#endif // WIN32
+    _mapping = nullptr;
+}
+
+RawCaptureReader::RawCaptureReader(const std::string& path)
+    : _file(path, std::ios::binary)
+{
+    if (!_file.good()) {
+        throw Err(9015, fmt::format("Could not open raw capture file '{}'", path));
+    }
+
+    std::array<char, FileId.size()> id;
+    _file.read(id.data(), id.size());
+    uint32_t version = 0;
+    _file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!_file.good() || id != FileId || version != FileVersion) {
+        throw Err(9017, fmt::format("File '{}' is not a raw capture file", path));
+    }
+    _file.seekg(FileHeaderSize);
+}
+
+std::optional<RawFrameHeader> RawCaptureReader::nextFrame(
+                                                         std::vector<unsigned char>& data)
+{
+    RawFrameHeader header;
+    _file.read(reinterpret_cast<char*>(&header), sizeof(RawFrameHeader));
+    // A file that was not closed properly ends in preallocated space filled with zeros
+    if (!_file.good() || header.magic != RawFrameHeader::Magic) {
+        return std::nullopt;
+    }
+
+    const std::streampos start = _file.tellg();
+    data.resize(header.dataSize);
+    _file.read(reinterpret_cast<char*>(data.data()), header.dataSize);
+    if (!_file.good()) {
+        Log::Warning(fmt::format("Frame {} is truncated", header.frameNumber));
+        return std::nullopt;
+    }
+    _file.seekg(start + static_cast<std::streamoff>(frameSize(header) - sizeof(header)));
+    return header;
+}
+
+} // namespace sgct
@@ -125,6 +125,7 @@ namespace {
         if (format == "png" || format == "PNG") { return Capture::Format::PNG; }
         if (format == "tga" || format == "TGA") { return Capture::Format::TGA; }
         if (format == "jpg" || format == "JPG") { return Capture::Format::JPG; }
+        if (format == "qoi" || format == "QOI") { return Capture::Format::QOI; }
         throw Err(6060, "Unknown capturing format");
     }
 
@@ -1373,6 +1374,9 @@ void to_json(nlohmann::json& j, const Capture& c) {
             case Capture::Format::JPG:
                 j["format"] = "jpg";
                 break;
+            case Capture::Format::QOI:
+                j["format"] = "qoi";
+                break;
         }
     }
 
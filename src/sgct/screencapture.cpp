@@ -14,30 +14,23 @@
 #include <sgct/image.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
+#include <sgct/pixelconversion.h>
 #include <sgct/profiling.h>
+#include <sgct/rawcapture.h>
 #include <sgct/settings.h>
+#include <sgct/videopipe.h>
 #include <sgct/window.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <functional>
+#include <mutex>
 #include <string>
-
-// @TODO (abock, 2019-12-01) This class might want a complete overhaul; right now, there
-// is one instance of this class for each window, and it might be better to replace it
-// with a global version that keeps threads usable by all windows of the application
+#include <string_view>
+#include <thread>
 
 namespace {
-    void screenCaptureHandler(void* arg) {
-        using SCTI = sgct::ScreenCapture::ScreenCaptureThreadInfo;
-        SCTI* ptr = reinterpret_cast<SCTI*>(arg);
-
-        try {
-            ptr->frameBufferImage->save(ptr->filename);
-        }
-        catch (const std::runtime_error& e) {
-            sgct::Log::Error(e.what());
-        }
-        ptr->isRunning = false;
-    }
-
     GLenum sourceForCaptureSource(sgct::ScreenCapture::CaptureSource source) {
         using Source = sgct::ScreenCapture::CaptureSource;
         switch (source) {
@@ -61,32 +54,240 @@ namespace {
 
 namespace sgct {
 
+/// Images that have been written to disk and can be reused for the next screenshot
+struct ScreenCapture::ImagePool {
+    std::unique_ptr<Image> acquire(ivec2 size, int channels, int bytesPerChannel);
+    void release(std::unique_ptr<Image> image);
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Image>> images;
+};
+
+std::unique_ptr<Image> ScreenCapture::ImagePool::acquire(ivec2 size, int channels,
+                                                         int bytesPerChannel)
+{
+    std::unique_lock lock(mutex);
+    while (!images.empty()) {
+        std::unique_ptr<Image> image = std::move(images.back());
+        images.pop_back();
+
+        // Images that were created before the capture has been resized are discarded
+        if (image->size().x == size.x && image->size().y == size.y &&
+            image->channels() == channels && image->bytesPerChannel() == bytesPerChannel)
+        {
+            return image;
+        }
+    }
+    lock.unlock();
+
+    std::unique_ptr<Image> image = std::make_unique<Image>();
+    image->setBytesPerChannel(bytesPerChannel);
+    image->setChannels(channels);
+    image->setSize(size);
+    image->allocateOrResizeData();
+    return image;
+}
+
+void ScreenCapture::ImagePool::release(std::unique_ptr<Image> image) {
+    std::unique_lock lock(mutex);
+    images.push_back(std::move(image));
+}
+
+/**
+ * The capture threads that encode the screenshots and write them to disk. The render
+ * thread pushes the screenshots into a bounded queue that the threads are waiting on.
+ */
+struct ScreenCapture::WorkerPool {
+    struct Job {
+        std::unique_ptr<Image> image;
+        std::function<void(Image&)> save;
+        std::shared_ptr<ImagePool> pool;
+    };
+
+    WorkerPool(int nThreads, int queueSize, Settings::CaptureQueuePolicy queuePolicy);
+    ~WorkerPool();
+
+    void push(Job job);
+    void workerLoop();
+
+    std::mutex mutex;
+    std::condition_variable hasJob;
+    std::condition_variable hasSpace;
+    std::vector<Job> queue;
+    size_t first = 0;
+    size_t count = 0;
+    bool isRunning = true;
+    Settings::CaptureQueuePolicy policy;
+
+    Statistics stats;
+    double totalEncodeTime = 0.0;
+
+    std::vector<std::thread> threads;
+};
+
+ScreenCapture::WorkerPool::WorkerPool(int nThreads, int queueSize,
+                                      Settings::CaptureQueuePolicy queuePolicy)
+    : queue(queueSize)
+    , policy(queuePolicy)
+{
+    Log::Debug(fmt::format(
+        "Starting {} screencapture threads with a queue size of {}", nThreads, queueSize
+    ));
+    threads.reserve(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+ScreenCapture::WorkerPool::~WorkerPool() {
+    // The threads finish all queued screenshots before they exit
+    {
+        std::unique_lock lock(mutex);
+        isRunning = false;
+    }
+    hasJob.notify_all();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    Log::Debug(fmt::format(
+        "Screencapture: {} encoded, {} dropped, max queue occupancy {}, average encode "
+        "time {:.2f} ms", stats.nEncoded, stats.nDropped, stats.maxQueueOccupancy,
+        stats.averageEncodeTime * 1000.0
+    ));
+}
+
+void ScreenCapture::WorkerPool::push(Job job) {
+    std::unique_lock lock(mutex);
+    if (count == queue.size()) {
+        if (policy == Settings::CaptureQueuePolicy::Drop) {
+            stats.nDropped++;
+            lock.unlock();
+            Log::Warning("Capture queue full, dropping screenshot");
+            job.pool->release(std::move(job.image));
+            return;
+        }
+
+        ZoneScopedN("Wait for capture queue")
+        hasSpace.wait(lock, [this]() { return count < queue.size(); });
+    }
+
+    queue[(first + count) % queue.size()] = std::move(job);
+    count++;
+    stats.queueOccupancy = static_cast<int>(count);
+    stats.maxQueueOccupancy = std::max(stats.maxQueueOccupancy, stats.queueOccupancy);
+    lock.unlock();
+    hasJob.notify_one();
+}
+
+void ScreenCapture::WorkerPool::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            hasJob.wait(lock, [this]() { return count > 0 || !isRunning; });
+            if (count == 0) {
+                // We are shutting down and there is nothing left to do
+                return;
+            }
+            job = std::move(queue[first]);
+            first = (first + 1) % queue.size();
+            count--;
+            stats.queueOccupancy = static_cast<int>(count);
+        }
+        hasSpace.notify_one();
+
+        const auto t0 = std::chrono::steady_clock::now();
+        try {
+            job.save(*job.image);
+        }
+        catch (const std::runtime_error& e) {
+            Log::Error(e.what());
+        }
+        const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+        job.pool->release(std::move(job.image));
+
+        std::unique_lock lock(mutex);
+        stats.nEncoded++;
+        totalEncodeTime += dt.count();
+        stats.averageEncodeTime = totalEncodeTime / stats.nEncoded;
+        stats.maxEncodeTime = std::max(stats.maxEncodeTime, dt.count());
+    }
+}
+
+std::weak_ptr<ScreenCapture::WorkerPool> ScreenCapture::_sharedWorkers;
+std::weak_ptr<RawCaptureWriter> ScreenCapture::_sharedRawWriter;
+
+ScreenCapture::Statistics ScreenCapture::statistics() {
+    std::shared_ptr<WorkerPool> workers = _sharedWorkers.lock();
+    if (!workers) {
+        return Statistics();
+    }
+    std::unique_lock lock(workers->mutex);
+    return workers->stats;
+}
+
 ScreenCapture::ScreenCapture()
-    : _nThreads(Settings::instance().numberCaptureThreads())
+    : _images(std::make_shared<ImagePool>())
+    , _readbacks(Settings::instance().numberCaptureBuffers())
 {
     ZoneScoped
+
+    _workers = _sharedWorkers.lock();
+    if (!_workers) {
+        const Settings& s = Settings::instance();
+        _workers = std::make_shared<WorkerPool>(
+            std::max(s.numberCaptureThreads(), 1),
+            s.captureQueueSize(),
+            s.captureQueuePolicy()
+        );
+        _sharedWorkers = _workers;
+    }
 }
 
 ScreenCapture::~ScreenCapture() {
-    for (ScreenCaptureThreadInfo& info : _captureInfos) {
-        // kill threads that are still running
-        if (info.captureThread) {
-            info.captureThread->join();
-            info.captureThread = nullptr;
-        }
+    finishAllReadbacks();
 
-        std::unique_lock lock(_mutex);
-        info.frameBufferImage = nullptr;
-        info.isRunning = false;
+    for (Readback& rb : _readbacks) {
+        glDeleteBuffers(1, &rb.pbo);
     }
-
-    glDeleteBuffers(1, &_pbo);
+    glDeleteFramebuffers(1, &_readFramebuffer);
 }
 
 void ScreenCapture::initOrResize(ivec2 resolution, int channels, int bytesPerColor) {
-    glDeleteBuffers(1, &_pbo);
+    // The pending downloads still use the old size, so they have to be finished first
+    finishAllReadbacks();
+    _encoder = nullptr;
+    for (Readback& rb : _readbacks) {
+        glDeleteBuffers(1, &rb.pbo);
+    }
+    if (_tiledCapture) {
+        Log::Warning("Discarding tiled screenshot as the capture was resized");
+        _tiledCapture = std::nullopt;
+    }
 
-    _resolution = std::move(resolution);
+    // Only the part of the capture region that lies within the framebuffer is captured
+    _sourceResolution = resolution;
+    const ivec4 region = Settings::instance().captureRegion();
+    if (region.z > 0 && region.w > 0) {
+        _offset = ivec2{
+            std::min(region.x, resolution.x - 1),
+            std::min(region.y, resolution.y - 1)
+        };
+        _resolution = ivec2{
+            std::min(region.z, resolution.x - _offset.x),
+            std::min(region.w, resolution.y - _offset.y)
+        };
+    }
+    else {
+        _offset = ivec2{ 0, 0 };
+        _resolution = std::move(resolution);
+    }
+    const int nRows = std::max(_resolution.y, 1);
+    const int nTiles = std::min(Settings::instance().numberCaptureTiles(), nRows);
+    _tileHeight = (nRows + nTiles - 1) / nTiles;
+    // Rounding up the height of the strips might leave fewer strips than requested
+    _nTiles = (nRows + _tileHeight - 1) / _tileHeight;
     _bytesPerColor = bytesPerColor;
 
     _nChannels = channels;
@@ -94,27 +295,17 @@ void ScreenCapture::initOrResize(ivec2 resolution, int channels, int bytesPerCol
 
     _downloadFormat = getDownloadFormat(_nChannels);
 
-    std::unique_lock lock(_mutex);
-    for (ScreenCaptureThreadInfo& info : _captureInfos) {
-        if (info.frameBufferImage) {
-            // kill threads that are still running
-            if (info.captureThread) {
-                info.captureThread->join();
-                info.captureThread = nullptr;
-            }
-            info.frameBufferImage = nullptr;
-        }
-        info.isRunning = false;
-    }
-
-    glGenBuffers(1, &_pbo);
     Log::Debug(fmt::format(
-        "Generating {}x{}x{} PBO: {}", _resolution.x, _resolution.y, _nChannels, _pbo
+        "Generating {} {}x{}x{} PBOs",
+        _readbacks.size(), _resolution.x, _resolution.y, _nChannels
     ));
-
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo);
-    glBufferData(GL_PIXEL_PACK_BUFFER, _dataSize, nullptr, GL_STATIC_READ);
+    for (Readback& rb : _readbacks) {
+        glGenBuffers(1, &rb.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, _dataSize, nullptr, GL_STREAM_READ);
+    }
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _nextReadback = 0;
 }
 
 void ScreenCapture::setTextureTransferProperties(GLenum type) {
@@ -143,66 +334,234 @@ void ScreenCapture::saveScreenCapture(unsigned int textureId, CaptureSource capS
         }
     }
 
-    std::string file = createFilename(number);
-    checkImageBuffer(capSrc);
+    if (_tiledCapture) {
+        Log::Debug(fmt::format(
+            "Skipping screenshot {} while a tiled capture is in progress", number
+        ));
+        return;
+    }
 
-    int threadIndex = availableCaptureThread();
-    if (threadIndex == -1) {
-        Log::Error("Error finding available capture thread");
+    const bool needsFilename = _format != CaptureFormat::Raw &&
+        (Settings::instance().captureEncoder().empty() || _hasEncoderFailed);
+    std::string file = needsFilename ? createFilename(number) : "";
+    checkImageBuffer(capSrc);
+    if (_dataSize == 0) {
         return;
     }
 
-    Image* imPtr = prepareImage(threadIndex, std::move(file));
+    // If all buffers are in use, we have to wait for the oldest download to finish
+    Readback& rb = _readbacks[_nextReadback];
+    if (rb.fence) {
+        finishReadback(rb);
+    }
+    rb.filename = std::move(file);
+    rb.frameNumber = number;
+
+    TiledCapture tc;
+    tc.textureId = textureId;
+    tc.source = capSrc;
+    _tiledCapture = tc;
+    readNextTile();
+}
+
+void ScreenCapture::readNextTile() {
+    ZoneScoped
+
+    Readback& rb = _readbacks[_nextReadback];
+    TiledCapture& tc = *_tiledCapture;
+
+    const int firstRow = tc.nextTile * _tileHeight;
+    const int nRows = std::min(_tileHeight, _resolution.y - firstRow);
+    const GLsizei w = static_cast<GLsizei>(_resolution.x);
+    const GLsizei h = static_cast<GLsizei>(nRows);
+    const GLint x = static_cast<GLint>(_offset.x);
+    const GLint y = static_cast<GLint>(_offset.y + firstRow);
+    // The strip is written to its final location in the pixel buffer
+    const size_t rowSize =
+        static_cast<size_t>(_resolution.x) * _nChannels * _bytesPerColor;
+    void* offset = reinterpret_cast<void*>(firstRow * rowSize);
+
+    // The transfer into the PBO is asynchronous; the data is only mapped once the fence
+    // has been signaled in one of the following frames
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
 
-    if (capSrc == CaptureSource::Texture) {
-        glBindTexture(GL_TEXTURE_2D, textureId);
+    const bool isEntireTexture = _nTiles == 1 &&
+        _resolution.x == _sourceResolution.x && _resolution.y == _sourceResolution.y;
+    if (tc.source == CaptureSource::Texture && isEntireTexture) {
+        glBindTexture(GL_TEXTURE_2D, tc.textureId);
         glGetTexImage(GL_TEXTURE_2D, 0, _downloadFormat, _downloadType, nullptr);
     }
+    else if (tc.source == CaptureSource::Texture) {
+        // Parts of a texture can only be read through a framebuffer it is attached to
+        GLint prevFramebuffer = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFramebuffer);
+        if (_readFramebuffer == 0) {
+            glGenFramebuffers(1, &_readFramebuffer);
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _readFramebuffer);
+        glFramebufferTexture2D(
+            GL_READ_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            tc.textureId,
+            0
+        );
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(x, y, w, h, _downloadFormat, _downloadType, offset);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(prevFramebuffer));
+    }
     else {
         // set the target framebuffer to read
-        glReadBuffer(sourceForCaptureSource(capSrc));
-        const ivec2& s = imPtr->size();
-        const GLsizei w = static_cast<GLsizei>(s.x);
-        const GLsizei h = static_cast<GLsizei>(s.y);
-        glReadPixels(0, 0, w, h, _downloadFormat, _downloadType, nullptr);
+        glReadBuffer(sourceForCaptureSource(tc.source));
+        glReadPixels(x, y, w, h, _downloadFormat, _downloadType, offset);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    tc.nextTile++;
+    if (tc.nextTile == _nTiles) {
+        rb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _nextReadback = (_nextReadback + 1) % _readbacks.size();
+        _tiledCapture = std::nullopt;
+    }
+}
+
+void ScreenCapture::processPendingReadbacks() {
+    if (_tiledCapture) {
+        readNextTile();
+    }
+
+    // Process the downloads in the order in which they were issued
+    for (size_t i = 0; i < _readbacks.size(); ++i) {
+        Readback& rb = _readbacks[(_nextReadback + i) % _readbacks.size()];
+        if (!rb.fence) {
+            continue;
+        }
+
+        GLsync fence = reinterpret_cast<GLsync>(rb.fence);
+        const GLenum res = glClientWaitSync(fence, 0, 0);
+        if (res == GL_ALREADY_SIGNALED || res == GL_CONDITION_SATISFIED) {
+            finishReadback(rb);
+        }
+    }
+}
+
+void ScreenCapture::finishReadback(Readback& readback) {
+    ZoneScoped
+
+    GLsync fence = reinterpret_cast<GLsync>(readback.fence);
+    GLenum res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (res == GL_TIMEOUT_EXPIRED) {
+        constexpr const GLuint64 Timeout = 1000000; // 1 ms in nanoseconds
+        res = glClientWaitSync(fence, 0, Timeout);
     }
+    glDeleteSync(fence);
+    readback.fence = nullptr;
+
+    // None of the image formats can store half floats, so they are converted to 8 bit
+    const bool isHalfFloat = _downloadType == GL_HALF_FLOAT;
+    const int bytesPerChannel = isHalfFloat ? 1 : _bytesPerColor;
 
+    const std::string& encoder = Settings::instance().captureEncoder();
+    if (!encoder.empty() && !_encoder && !_hasEncoderFailed) {
+        try {
+            _encoder = std::make_unique<VideoPipe>(
+                createEncoderCommand(),
+                Settings::instance().captureEncoderRawFrames() ?
+                    VideoPipe::Format::Raw :
+                    VideoPipe::Format::Y4M,
+                _resolution,
+                _nChannels,
+                bytesPerChannel,
+                Settings::instance().captureFrameRate(),
+                Settings::instance().captureQueueSize(),
+                Settings::instance().captureQueuePolicy()
+            );
+        }
+        catch (const std::runtime_error& e) {
+            // Fall back to writing image files for this and all following screenshots
+            Log::Error(e.what());
+            _hasEncoderFailed = true;
+            readback.filename = createFilename(readback.frameNumber);
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
     unsigned char* ptr = reinterpret_cast<unsigned char*>(
         glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)
     );
-    if (ptr) {
-        std::memcpy(imPtr->data(), ptr, _dataSize);
+    if (ptr && _encoder && !isHalfFloat) {
+        // The frame is copied straight from the pixel buffer into the encoder queue
+        _encoder->push(ptr);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else if (ptr) {
+        std::unique_ptr<Image> image =
+            _images->acquire(_resolution, _nChannels, bytesPerChannel);
+        if (isHalfFloat) {
+            const size_t nValues =
+                static_cast<size_t>(_resolution.x) * _resolution.y * _nChannels;
+            halfToUnorm8(image->data(), reinterpret_cast<uint16_t*>(ptr), nValues);
+        }
+        else {
+            std::memcpy(image->data(), ptr, _dataSize);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 
         // save the image
-        _captureInfos[threadIndex].isRunning = true;
-        _captureInfos[threadIndex].captureThread = std::make_unique<std::thread>(
-            screenCaptureHandler,
-            &_captureInfos[threadIndex]
-        );
-        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        if (_encoder) {
+            _encoder->push(image->data());
+            _images->release(std::move(image));
+        }
+        else if (_format == CaptureFormat::Raw) {
+            if (!_rawWriter) {
+                _rawWriter = _sharedRawWriter.lock();
+                if (!_rawWriter) {
+                    _rawWriter = std::make_shared<RawCaptureWriter>(createRawFilename());
+                    _sharedRawWriter = _rawWriter;
+                }
+            }
+
+            RawFrameHeader header;
+            header.windowId = static_cast<uint32_t>(_windowIndex);
+            header.frameNumber = readback.frameNumber;
+            header.eye = static_cast<uint32_t>(_eyeIndex);
+            header.width = image->size().x;
+            header.height = image->size().y;
+            header.channels = static_cast<uint32_t>(image->channels());
+            header.bytesPerChannel = static_cast<uint32_t>(image->bytesPerChannel());
+            header.dataSize = static_cast<uint64_t>(header.width) * header.height *
+                header.channels * header.bytesPerChannel;
+            auto save = [writer = _rawWriter, header](Image& img) {
+                writer->append(header, img.data());
+            };
+            _workers->push({ std::move(image), std::move(save), _images });
+        }
+        else {
+            auto save = [file = std::move(readback.filename)](Image& img) {
+                img.save(file);
+            };
+            _workers->push({ std::move(image), std::move(save), _images });
+        }
     }
     else {
         Log::Error("Can't map data (0) from GPU in frame capture");
     }
-
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
+void ScreenCapture::finishAllReadbacks() {
+    for (size_t i = 0; i < _readbacks.size(); ++i) {
+        Readback& rb = _readbacks[(_nextReadback + i) % _readbacks.size()];
+        if (rb.fence) {
+            finishReadback(rb);
+        }
+    }
+}
+
 void ScreenCapture::initialize(int windowIndex, ScreenCapture::EyeIndex ei) {
     _eyeIndex = ei;
-
-    _captureInfos.resize(_nThreads);
-    for (unsigned int i = 0; i < _nThreads; i++) {
-        _captureInfos[i].frameBufferImage = nullptr;
-        _captureInfos[i].captureThread = nullptr;
-        _captureInfos[i].mutex = &_mutex;
-        _captureInfos[i].isRunning = false;
-    }
     _windowIndex = windowIndex;
-
-    Log::Debug(fmt::format("Number of screencapture threads is set to {}", _nThreads));
 }
 
 std::string ScreenCapture::createFilename(uint64_t frameNumber) {
@@ -219,11 +578,15 @@ std::string ScreenCapture::createFilename(uint64_t frameNumber) {
     std::fill(Buffer.begin(), Buffer.end(), '\0');
     fmt::format_to_n(Buffer.data(), Buffer.size(), "{:06}", frameNumber);
 
-    const std::string suffix = [](CaptureFormat format) {
+    // QOI only supports 8 bit, so 16 bit screenshots are written as PNG instead
+    const bool is16Bit = _bytesPerColor == 2 && _downloadType != GL_HALF_FLOAT;
+    const std::string suffix = [is16Bit](CaptureFormat format) {
         switch (format) {
             case CaptureFormat::PNG: return "png";
             case CaptureFormat::TGA: return "tga";
             case CaptureFormat::JPEG: return "jpg";
+            case CaptureFormat::QOI: return is16Bit ? "png" : "qoi";
+            case CaptureFormat::Raw: return "sgctraw";
             default: throw std::logic_error("Unhandled case label");
         }
     }(_format);
@@ -255,32 +618,52 @@ std::string ScreenCapture::createFilename(uint64_t frameNumber) {
     return file + std::string(Buffer.begin(), Buffer.end()) + '.' + suffix;
 }
 
-int ScreenCapture::availableCaptureThread() {
-    while (true) {
-        for (unsigned int i = 0; i < _captureInfos.size(); i++) {
-            // check if thread is dead
-            if (_captureInfos[i].captureThread == nullptr) {
-                return i;
-            }
+std::string ScreenCapture::createRawFilename() {
+    std::string file;
+    if (!Settings::instance().capturePath().empty()) {
+        file = Settings::instance().capturePath() + '/';
+    }
+    if (!Settings::instance().prefixScreenshot().empty()) {
+        file += Settings::instance().prefixScreenshot();
+        file += '_';
+    }
+    if (ClusterManager::instance().numberOfNodes() > 1) {
+        file += "node" + std::to_string(ClusterManager::instance().thisNodeId());
+        file += '_';
+    }
+    return file + "capture.sgctraw";
+}
 
-            if (!_captureInfos[i].isRunning) {
-                _captureInfos[i].captureThread->join();
-                _captureInfos[i].captureThread = nullptr;
+std::string ScreenCapture::createEncoderCommand() {
+    const std::string eye = [](EyeIndex eyeIndex) {
+        switch (eyeIndex) {
+            case EyeIndex::Mono:        return "mono";
+            case EyeIndex::StereoLeft:  return "left";
+            case EyeIndex::StereoRight: return "right";
+            default:                    throw std::logic_error("Unhandled case label");
+        }
+    }(_eyeIndex);
 
-                return i;
-            }
+    auto replace = [](std::string& str, std::string_view key, const std::string& value) {
+        for (size_t p = str.find(key); p != std::string::npos; p = str.find(key, p)) {
+            str.replace(p, key.size(), value);
+            p += value.size();
         }
+    };
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    std::string command = Settings::instance().captureEncoder();
+    replace(command, "{node}", std::to_string(ClusterManager::instance().thisNodeId()));
+    replace(command, "{window}", std::to_string(_windowIndex));
+    replace(command, "{eye}", eye);
+    return command;
 }
 
 void ScreenCapture::checkImageBuffer(CaptureSource captureSource) {
     const Window& win = *Engine::instance().windows()[_windowIndex];
 
     if (captureSource == CaptureSource::Texture) {
-        if (_resolution.x != win.framebufferResolution().x &&
-            _resolution.y != win.framebufferResolution().y)
+        if (_sourceResolution.x != win.framebufferResolution().x &&
+            _sourceResolution.y != win.framebufferResolution().y)
         {
             _downloadType = _downloadTypeSetByUser;
             const int bytesPerColor = win.framebufferBPCC();
@@ -289,30 +672,13 @@ void ScreenCapture::checkImageBuffer(CaptureSource captureSource) {
     }
     else {
         // capture directly from back buffer (no HDR support)
-        if (_resolution.x != win.resolution().x && _resolution.y != win.resolution().y) {
+        if (_sourceResolution.x != win.resolution().x &&
+            _sourceResolution.y != win.resolution().y)
+        {
             _downloadType = GL_UNSIGNED_BYTE;
             initOrResize(win.resolution(), _nChannels, 1);
         }
     }
 }
 
-Image* ScreenCapture::prepareImage(int index, std::string file) {
-    Log::Debug(fmt::format("Starting thread for screenshot/capture [{}]", index));
-
-    if (_captureInfos[index].frameBufferImage == nullptr) {
-        _captureInfos[index].frameBufferImage = std::make_unique<Image>();
-        _captureInfos[index].frameBufferImage->setBytesPerChannel(_bytesPerColor);
-        _captureInfos[index].frameBufferImage->setChannels(_nChannels);
-        _captureInfos[index].frameBufferImage->setSize(_resolution);
-        if (_bytesPerColor * _nChannels * _resolution.x * _resolution.y == 0) {
-            _captureInfos[index].frameBufferImage = nullptr;
-            return nullptr;
-        }
-        _captureInfos[index].frameBufferImage->allocateOrResizeData();
-    }
-    _captureInfos[index].filename = std::move(file);
-
-    return _captureInfos[index].frameBufferImage.get();
-}
-
 } // namespace sgct
@@ -12,6 +12,8 @@
 #include <sgct/engine.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
+#include <algorithm>
+#include <filesystem>
 
 namespace sgct {
 
@@ -72,6 +74,7 @@ void Settings::applyCapture(const config::Capture& capture) {
                 case config::Capture::Format::PNG: return CaptureFormat::PNG;
                 case config::Capture::Format::JPG: return CaptureFormat::JPG;
                 case config::Capture::Format::TGA: return CaptureFormat::TGA;
+                case config::Capture::Format::QOI: return CaptureFormat::QOI;
                 default:      throw std::logic_error("Unhandled case label");
             }
         }(*capture.format);
@@ -126,6 +129,103 @@ void Settings::setNumberOfCaptureThreads(int count) {
     }
 }
 
+void Settings::setNumberOfCaptureBuffers(int count) {
+    if (count <= 0) {
+        Log::Error("Only positive number of capture buffers allowed");
+    }
+    else {
+        _nCaptureBuffers = count;
+    }
+}
+
+void Settings::setCaptureQueueSize(int size) {
+    if (size <= 0) {
+        Log::Error("Only positive capture queue sizes allowed");
+    }
+    else {
+        _captureQueueSize = size;
+    }
+}
+
+void Settings::setCaptureQueuePolicy(CaptureQueuePolicy policy) {
+    _captureQueuePolicy = policy;
+}
+
+void Settings::setCaptureRegion(ivec4 region) {
+    if (region.x < 0 || region.y < 0 || region.z < 0 || region.w < 0) {
+        Log::Error("Only positive capture region coordinates allowed");
+    }
+    else {
+        _captureRegion = region;
+    }
+}
+
+void Settings::setNumberOfCaptureTiles(int count) {
+    if (count <= 0) {
+        Log::Error("Only positive number of capture tiles allowed");
+    }
+    else {
+        _nCaptureTiles = count;
+    }
+}
+
+void Settings::setCaptureEncoder(std::string command) {
+    _captureEncoder = std::move(command);
+}
+
+void Settings::setCaptureEncoderRawFrames(bool state) {
+    _captureEncoderRawFrames = state;
+}
+
+void Settings::setCaptureFrameRate(int frameRate) {
+    if (frameRate <= 0) {
+        Log::Error("Only positive capture frame rates allowed");
+    }
+    else {
+        _captureFrameRate = frameRate;
+    }
+}
+
+void Settings::setNumberOfJobThreads(int count) {
+    if (count <= 0) {
+        Log::Error("Only positive number of job threads allowed");
+    }
+    else {
+        _nJobThreads = count;
+    }
+}
+
+void Settings::setImageBufferPoolSize(int megabytes) {
+    if (megabytes < 0) {
+        Log::Error("Only non-negative image buffer pool sizes allowed");
+    }
+    else {
+        _imageBufferPoolSize = megabytes;
+    }
+}
+
+void Settings::setUseHugePages(bool state) {
+    _useHugePages = state;
+}
+
+void Settings::setTextureUploadBudget(int megabytes) {
+    if (megabytes <= 0) {
+        Log::Error("Only positive texture upload budgets allowed");
+    }
+    else {
+        _textureUploadBudget = megabytes;
+    }
+}
+
+void Settings::setTextureMemoryBudget(int megabytes) {
+    if (megabytes < 0) {
+        Log::Error("Only non-negative texture memory budgets allowed");
+    }
+    else {
+        _textureMemoryBudget = megabytes;
+    }
+}
+
 bool Settings::useDepthTexture() const {
     return _useDepthTexture;
 }
@@ -142,6 +242,58 @@ int Settings::numberCaptureThreads() const {
     return _nCaptureThreads;
 }
 
+int Settings::numberCaptureBuffers() const {
+    return _nCaptureBuffers;
+}
+
+int Settings::captureQueueSize() const {
+    return _captureQueueSize;
+}
+
+Settings::CaptureQueuePolicy Settings::captureQueuePolicy() const {
+    return _captureQueuePolicy;
+}
+
+ivec4 Settings::captureRegion() const {
+    return _captureRegion;
+}
+
+int Settings::numberCaptureTiles() const {
+    return _nCaptureTiles;
+}
+
+const std::string& Settings::captureEncoder() const {
+    return _captureEncoder;
+}
+
+bool Settings::captureEncoderRawFrames() const {
+    return _captureEncoderRawFrames;
+}
+
+int Settings::captureFrameRate() const {
+    return _captureFrameRate;
+}
+
+int Settings::numberJobThreads() const {
+    return _nJobThreads;
+}
+
+int Settings::imageBufferPoolSize() const {
+    return _imageBufferPoolSize;
+}
+
+bool Settings::useHugePages() const {
+    return _useHugePages;
+}
+
+int Settings::textureUploadBudget() const {
+    return _textureUploadBudget;
+}
+
+int Settings::textureMemoryBudget() const {
+    return _textureMemoryBudget;
+}
+
 Settings::DrawBufferType Settings::drawBufferType() const {
     if (_usePositionTexture) {
         if (_useNormalTexture) {
@@ -193,6 +345,22 @@ void Settings::setExportWarpingMeshes(bool state) {
     _exportWarpingMeshes = state;
 }
 
+void Settings::setUseCorrectionMeshCache(bool state) {
+    _useCorrectionMeshCache = state;
+}
+
+void Settings::setCorrectionMeshCachePath(std::string path) {
+    _correctionMeshCachePath = std::move(path);
+}
+
+void Settings::setCorrectionMeshMaxError(float pixels) {
+    _correctionMeshMaxError = std::max(pixels, 0.f);
+}
+
+void Settings::setUseCorrectionMeshStrips(bool state) {
+    _useCorrectionMeshStrips = state;
+}
+
 void Settings::setAddNodeNameToScreenshot(bool state) {
     _screenshot.addNodeName = state;
 }
@@ -201,10 +369,67 @@ void Settings::setAddWindowNameToScreenshot(bool state) {
     _screenshot.addWindowName = state;
 }
 
+void Settings::setUseFramePacing(bool state) {
+    _useFramePacing = state;
+}
+
+void Settings::setFramePacingMargin(double margin) {
+    if (margin < 0.0) {
+        Log::Error("Only non-negative frame pacing margins are allowed");
+    }
+    else {
+        _framePacingMargin = margin;
+    }
+}
+
+void Settings::setUseDynamicResolution(bool state) {
+    _useDynamicResolution = state;
+}
+
+void Settings::setDynamicResolutionTarget(double target) {
+    if (target < 0.0) {
+        Log::Error("Only non-negative dynamic resolution targets are allowed");
+    }
+    else {
+        _dynamicResolutionTarget = target;
+    }
+}
+
+void Settings::setDynamicResolutionMinScale(float scale) {
+    if (scale <= 0.f || scale > 1.f) {
+        Log::Error("The minimum dynamic resolution scale has to be in the range (0, 1]");
+    }
+    else {
+        _dynamicResolutionMinScale = scale;
+    }
+}
+
 bool Settings::exportWarpingMeshes() const {
     return _exportWarpingMeshes;
 }
 
+bool Settings::useCorrectionMeshCache() const {
+    return _useCorrectionMeshCache;
+}
+
+std::string Settings::correctionMeshCachePath() const {
+    if (!_correctionMeshCachePath.empty()) {
+        return _correctionMeshCachePath;
+    }
+
+    std::error_code ec;
+    const std::filesystem::path tmp = std::filesystem::temp_directory_path(ec);
+    return ec ? std::string() : (tmp / "sgct-correction-mesh-cache").string();
+}
+
+float Settings::correctionMeshMaxError() const {
+    return _correctionMeshMaxError;
+}
+
+bool Settings::useCorrectionMeshStrips() const {
+    return _useCorrectionMeshStrips;
+}
+
 bool Settings::captureFromBackBuffer() const {
     return _captureBackBuffer;
 }
@@ -226,6 +451,26 @@ const std::string& Settings::prefixScreenshot() const {
     return _screenshot.prefix;
 }
 
+bool Settings::useFramePacing() const {
+    return _useFramePacing;
+}
+
+double Settings::framePacingMargin() const {
+    return _framePacingMargin;
+}
+
+bool Settings::useDynamicResolution() const {
+    return _useDynamicResolution;
+}
+
+double Settings::dynamicResolutionTarget() const {
+    return _dynamicResolutionTarget;
+}
+
+float Settings::dynamicResolutionMinScale() const {
+    return _dynamicResolutionMinScale;
+}
+
 bool Settings::hasScreenshotLimit() const {
     return _screenshot.limits.has_value();
 }
@@ -8,12 +8,25 @@
 
 #include <sgct/shareddata.h>
 
+#include <sgct/engine.h>
+#include <sgct/error.h>
+#include <sgct/fmt.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
 #include <zlib.h>
 #include <cstring>
 #include <string>
 
+#define Err(code, msg) Error(Error::Component::Network, code, msg)
+
+namespace {
+    // Every recording starts with this identifier followed by the version number
+    constexpr const std::array<char, 8> RecordingId = {
+        'S', 'G', 'C', 'T', 'R', 'E', 'C', '\0'
+    };
+    constexpr const uint32_t RecordingVersion = 1;
+} // namespace
+
 namespace sgct {
 
 SharedData* SharedData::_instance = nullptr;
@@ -97,6 +110,81 @@ void SharedData::encode() {
         std::vector<std::byte> data = _encodeFn();
         _dataBlock.insert(_dataBlock.end(), data.begin(), data.end());
     }
+
+    if (_recording.is_open()) {
+        ZoneScopedN("Record")
+
+        // Only the payload is recorded as the header is created by the network layer
+        const uint32_t frameNumber = Engine::instance().currentFrameNumber();
+        const double time = Engine::getTime();
+        const uint32_t size =
+            static_cast<uint32_t>(_dataBlock.size() - Network::HeaderSize);
+        _recording.write(reinterpret_cast<const char*>(&frameNumber), sizeof(uint32_t));
+        _recording.write(reinterpret_cast<const char*>(&time), sizeof(double));
+        _recording.write(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
+        _recording.write(
+            reinterpret_cast<const char*>(_dataBlock.data() + Network::HeaderSize),
+            size
+        );
+    }
+}
+
+void SharedData::startRecording(const std::string& path) {
+    _recording.open(path, std::ios::binary | std::ios::trunc);
+    if (!_recording.good()) {
+        throw Err(5030, fmt::format("Could not open recording file '{}'", path));
+    }
+    _recording.write(RecordingId.data(), RecordingId.size());
+    _recording.write(
+        reinterpret_cast<const char*>(&RecordingVersion),
+        sizeof(RecordingVersion)
+    );
+    Log::Info(fmt::format("Recording shared data to '{}'", path));
+}
+
+void SharedData::startReplay(const std::string& path) {
+    _replay.open(path, std::ios::binary);
+    if (!_replay.good()) {
+        throw Err(
+            5031,
+            fmt::format("Could not open recording file '{}' for replay", path)
+        );
+    }
+
+    std::array<char, RecordingId.size()> id;
+    _replay.read(id.data(), id.size());
+    uint32_t version = 0;
+    _replay.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!_replay.good() || id != RecordingId || version != RecordingVersion) {
+        throw Err(5032, fmt::format("File '{}' is not a valid recording", path));
+    }
+    Log::Info(fmt::format("Replaying shared data from '{}'", path));
+}
+
+bool SharedData::isReplaying() const {
+    return _replay.is_open();
+}
+
+std::optional<double> SharedData::replayNextFrame() {
+    ZoneScoped
+
+    uint32_t frameNumber = 0;
+    double time = 0.0;
+    uint32_t size = 0;
+    _replay.read(reinterpret_cast<char*>(&frameNumber), sizeof(uint32_t));
+    if (_replay.eof()) {
+        return std::nullopt;
+    }
+    _replay.read(reinterpret_cast<char*>(&time), sizeof(double));
+    _replay.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
+    _replayBuffer.resize(size);
+    _replay.read(_replayBuffer.data(), size);
+    if (!_replay.good()) {
+        throw Err(5033, fmt::format("Recording truncated in frame {}", frameNumber));
+    }
+
+    decode(_replayBuffer.data(), static_cast<int>(size));
+    return time;
 }
 
 unsigned char* SharedData::dataBlock() {
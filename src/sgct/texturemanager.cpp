@@ -8,29 +8,118 @@
 
 #include <sgct/texturemanager.h>
 
+#include <sgct/compressedtexture.h>
+#include <sgct/error.h>
 #include <sgct/fmt.h>
 #include <sgct/image.h>
+#include <sgct/jobsystem.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <sgct/settings.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <optional>
 
 namespace {
-    unsigned int uploadImage(const sgct::Image& img, bool interpolate, int mipmap,
-                             float anisotropicFilterSize)
+    // The S3TC formats are not part of core OpenGL, but every desktop GPU supports them
+    constexpr const GLenum CompressedRGBS3TCDXT1 = 0x83F0;
+    constexpr const GLenum CompressedRGBAS3TCDXT1 = 0x83F1;
+    constexpr const GLenum CompressedRGBAS3TCDXT5 = 0x83F3;
+    constexpr const GLenum CompressedSRGBS3TCDXT1 = 0x8C4C;
+    constexpr const GLenum CompressedSRGBAlphaS3TCDXT1 = 0x8C4D;
+    constexpr const GLenum CompressedSRGBAlphaS3TCDXT5 = 0x8C4F;
+
+    GLenum compressedFormat(sgct::CompressedTexture::Format format, bool isSrgb) {
+        using Format = sgct::CompressedTexture::Format;
+        switch (format) {
+            case Format::BC1:
+                return isSrgb ? CompressedSRGBS3TCDXT1 : CompressedRGBS3TCDXT1;
+            case Format::BC1Alpha:
+                return isSrgb ? CompressedSRGBAlphaS3TCDXT1 : CompressedRGBAS3TCDXT1;
+            case Format::BC3:
+                return isSrgb ? CompressedSRGBAlphaS3TCDXT5 : CompressedRGBAS3TCDXT5;
+            case Format::BC7:
+                return isSrgb ?
+                    GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM :
+                    GL_COMPRESSED_RGBA_BPTC_UNORM;
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
+    // Returns true if the file starts with the identifier of a DDS or KTX file
+    bool isCompressedTextureFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        std::array<char, 12> id = {};
+        file.read(id.data(), id.size());
+        return sgct::isCompressedTexture(
+            reinterpret_cast<const unsigned char*>(id.data()),
+            static_cast<size_t>(file.gcount())
+        );
+    }
+
+    // Loads a DDS or KTX file in the order that OpenGL expects. Files whose rows cannot
+    // be flipped into that order are rejected, as the texture would be upside down
+    sgct::CompressedTexture loadUprightTexture(const std::string& filename) {
+        sgct::CompressedTexture texture = sgct::loadCompressedTexture(filename);
+        if (texture.isTopDown) {
+            throw sgct::Error(
+                sgct::Error::Component::Image,
+                9023,
+                fmt::format(
+                    "Could not load compressed texture '{}': its rows are stored from "
+                    "top to bottom and cannot be flipped", filename
+                )
+            );
+        }
+        return texture;
+    }
+
+    std::pair<GLenum, GLenum> textureFormat(int channels) {
+        switch (channels) {
+            case 1: return { GL_RED, GL_R8 };
+            case 2: return { GL_RG, GL_RG8 };
+            case 3: return { GL_BGR, GL_RGB8 };
+            case 4: return { GL_BGRA, GL_RGBA8 };
+            default: throw std::logic_error("Unhandled case label");
+        }
+    }
+
+    // Returns the number of levels of a texture of the image with mipmaps generated
+    int numberOfLevels(const sgct::Image& img, int mipmapLevels) {
+        return std::clamp(mipmapLevels, 1, sgct::numberOfMipmapLevels(img.size()));
+    }
+
+    // Returns the estimated number of bytes of GPU memory that the texture of the image
+    // uses together with its mipmap levels
+    size_t textureSize(const sgct::Image& img, int mipmapLevels) {
+        // Drivers store textures with three channels with four bytes per pixel
+        const size_t bytesPerPixel = img.channels() == 3 ? 4 : img.channels();
+        sgct::ivec2 size = img.size();
+        size_t res = 0;
+        for (int i = 0; i < numberOfLevels(img, mipmapLevels); ++i) {
+            res += static_cast<size_t>(size.x) * size.y * bytesPerPixel;
+            size = sgct::ivec2{ std::max(size.x / 2, 1), std::max(size.y / 2, 1) };
+        }
+        return res;
+    }
+
+    // Creates the texture object and the storage of the first level. If the data is
+    // nullptr, the content of the texture is left undefined. If a texture is passed, its
+    // storage is replaced instead of creating a new texture object
+    unsigned int createTexture(const sgct::Image& img, const unsigned char* data,
+                               unsigned int tex = 0)
     {
-        unsigned int tex;
-        glGenTextures(1, &tex);
+        if (tex == 0) {
+            glGenTextures(1, &tex);
+        }
         glBindTexture(GL_TEXTURE_2D, tex);
 
-        const auto [type, internalFormat] = [](int c) -> std::pair<GLenum, GLenum> {
-            switch (c) {
-                case 1: return { GL_RED, GL_R8 };
-                case 2: return { GL_RG, GL_RG8 };
-                case 3: return { GL_BGR, GL_RGB8 };
-                case 4: return { GL_BGRA, GL_RGBA8 };
-                default: throw std::logic_error("Unhandled case label");
-            }
-        }(img.channels());
+        const auto [type, internalFormat] = textureFormat(img.channels());
 
         sgct::Log::Debug(fmt::format(
             "Creating texture. Size: {}x{}, {}-channels, Type: {:#04x}, Format: {:#04x}",
@@ -50,14 +139,17 @@ namespace {
             0,
             type,
             format,
-            img.data()
+            data
         );
+        return tex;
+    }
+
+    // Sets the sampling parameters of the bound texture that has mipmap levels
+    void setTextureParameters(bool interpolate, int mipmap, float anisotropicFilterSize) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmap - 1);
 
         if (mipmap > 1) {
-            glGenerateMipmap(GL_TEXTURE_2D);
-
             glTexParameteri(
                 GL_TEXTURE_2D,
                 GL_TEXTURE_MIN_FILTER,
@@ -89,13 +181,209 @@ namespace {
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    // Sets the sampling parameters and generates the mipmaps of the bound texture. The
+    // parameters come first, as the mipmaps are generated from the base level
+    void finalizeTexture(bool interpolate, int mipmap, float anisotropicFilterSize) {
+        setTextureParameters(interpolate, mipmap, anisotropicFilterSize);
+        if (mipmap > 1) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
 
+    // Replaces the level of the bound texture with a single transparent texel and makes
+    // it the only level that is sampled
+    void setPlaceholder(int level) {
+        constexpr const std::array<unsigned char, 4> Texel = { 0, 0, 0, 0 };
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            level,
+            GL_RGBA8,
+            1,
+            1,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            Texel.data()
+        );
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+    }
+
+    unsigned int uploadImage(const sgct::Image& img, bool interpolate, int mipmap,
+                             float anisotropicFilterSize)
+    {
+        unsigned int tex = createTexture(img, img.data());
+        finalizeTexture(interpolate, mipmap, anisotropicFilterSize);
+        return tex;
+    }
+
+    unsigned int uploadCompressedTexture(const sgct::CompressedTexture& texture,
+                                         bool interpolate, float anisotropicFilterSize)
+    {
+        unsigned int tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+
+        const GLenum internalFormat = compressedFormat(texture.format, texture.isSrgb);
+        sgct::Log::Debug(fmt::format(
+            "Creating compressed texture. Size: {}x{}, {} levels, Format: {:#04x}",
+            texture.levels.front().size.x, texture.levels.front().size.y,
+            texture.levels.size(), internalFormat
+        ));
+
+        // The mipmap levels are taken from the file, as generating them at runtime is
+        // not supported for compressed formats
+        for (size_t i = 0; i < texture.levels.size(); ++i) {
+            const sgct::CompressedTexture::Level& level = texture.levels[i];
+            glCompressedTexImage2D(
+                GL_TEXTURE_2D,
+                static_cast<GLint>(i),
+                internalFormat,
+                level.size.x,
+                level.size.y,
+                0,
+                static_cast<GLsizei>(level.dataSize),
+                texture.data.data() + level.offset
+            );
+        }
+        setTextureParameters(
+            interpolate,
+            static_cast<int>(texture.levels.size()),
+            anisotropicFilterSize
+        );
         return tex;
     }
 } // namespace
 
 namespace sgct {
 
+struct TextureManager::AsyncLoad {
+    std::string filename;
+    bool interpolate = true;
+    float anisotropicFilterSize = 1.f;
+    int mipmapLevels = 8;
+    std::promise<unsigned int> promise;
+    // Set if an evicted texture is reloaded into its existing name
+    bool isReload = false;
+
+    // Written by the job that decodes the image, which sets isDecoded last
+    Image image;
+    std::optional<CompressedTexture> compressed;
+    std::exception_ptr error;
+    std::atomic_bool isDecoded = false;
+
+    unsigned int texture = 0;
+    bool isUploading = false;
+    // The level of a compressed texture and the row of pixels that is uploaded next
+    int nextLevel = 0;
+    int nextRow = 0;
+    // The level that holds the placeholder of a texture while it is reloaded
+    int placeholderLevel = 0;
+};
+
+/**
+ * Pixel unpack buffer that is split into segments of the size of the per-frame upload
+ * budget. Every frame writes into the next segment, and a fence marks when the GPU has
+ * finished reading from a segment so that it can be reused. If the OpenGL version
+ * supports it, the buffer is mapped persistently and the pixel data is copied into it
+ * directly; otherwise the driver copies the data through glBufferSubData.
+ */
+struct TextureManager::StagingBuffer {
+    static constexpr const int NSegments = 3;
+
+    explicit StagingBuffer(size_t size);
+    ~StagingBuffer();
+
+    /// Returns false if the GPU is still reading from the next segment
+    bool begin();
+    void end();
+
+    /// Returns the offset in the buffer for \p size bytes or nothing if they do not fit
+    std::optional<size_t> write(const unsigned char* data, size_t size);
+
+    const size_t segmentSize;
+    GLuint buffer = 0;
+    unsigned char* mapping = nullptr;
+    std::array<GLsync, NSegments> fences = {};
+    int segment = 0;
+    size_t offset = 0;
+};
+
+TextureManager::StagingBuffer::StagingBuffer(size_t size)
+    : segmentSize(size)
+{
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    const GLsizeiptr totalSize = static_cast<GLsizeiptr>(segmentSize * NSegments);
+    if (GLAD_GL_VERSION_4_4) {
+        const GLbitfield flags =
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, totalSize, nullptr, flags);
+        mapping = reinterpret_cast<unsigned char*>(
+            glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, totalSize, flags)
+        );
+    }
+    else {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureManager::StagingBuffer::~StagingBuffer() {
+    for (GLsync fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    // Deleting the buffer also removes the persistent mapping
+    glDeleteBuffers(1, &buffer);
+}
+
+bool TextureManager::StagingBuffer::begin() {
+    GLsync& fence = fences[segment];
+    if (fence) {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    offset = 0;
+    return true;
+}
+
+void TextureManager::StagingBuffer::end() {
+    if (offset > 0) {
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment = (segment + 1) % NSegments;
+    }
+}
+
+std::optional<size_t> TextureManager::StagingBuffer::write(const unsigned char* data,
+                                                           size_t size)
+{
+    if (offset + size > segmentSize) {
+        return std::nullopt;
+    }
+
+    const size_t pos = segment * segmentSize + offset;
+    if (mapping) {
+        std::memcpy(mapping + pos, data, size);
+    }
+    else {
+        glBufferSubData(
+            GL_PIXEL_UNPACK_BUFFER,
+            static_cast<GLintptr>(pos),
+            static_cast<GLsizeiptr>(size),
+            data
+        );
+    }
+    offset += size;
+    return pos;
+}
+
 TextureManager* TextureManager::_instance = nullptr;
 
 TextureManager& TextureManager::instance() {
@@ -111,12 +399,32 @@ void TextureManager::destroy() {
 }
 
 TextureManager::~TextureManager() {
-    glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
+    Log::Debug(fmt::format(
+        "Texture memory: {} textures, {} bytes at most, {} evictions, {} reloads",
+        _textures.size(), _statistics.maxBytesResident, _statistics.nEvictions,
+        _statistics.nReloads
+    ));
+
+    // Textures that were not finished are registered once their storage is allocated, so
+    // they are deleted too; their futures receive an error
+    for (const std::pair<const unsigned int, TextureInfo>& p : _textures) {
+        glDeleteTextures(1, &p.first);
+    }
 }
 
 unsigned int TextureManager::loadTexture(const std::string& filename, bool interpolate,
                                          float anisotropicFilterSize, int mipmapLevels)
 {
+    if (isCompressedTextureFile(filename)) {
+        const CompressedTexture texture = loadUprightTexture(filename);
+        unsigned int t = loadTexture(texture, interpolate, anisotropicFilterSize);
+        if (t != 0) {
+            _textures[t].filename = filename;
+        }
+        Log::Debug(fmt::format("Texture created from '{}' [id={}]", filename, t));
+        return t;
+    }
+
     // load image
     Image img;
     img.load(filename);
@@ -126,29 +434,494 @@ unsigned int TextureManager::loadTexture(const std::string& filename, bool inter
         return 0;
     }
 
-    unsigned int t = loadTexture(
-        std::move(img),
-        interpolate,
-        anisotropicFilterSize,
-        mipmapLevels
-    );
+    unsigned int t = loadTexture(img, interpolate, anisotropicFilterSize, mipmapLevels);
+    // Only textures that were loaded from a file can be reloaded after an eviction
+    _textures[t].filename = filename;
     Log::Debug(fmt::format("Texture created from '{}' [id={}]", filename, t));
     return t;
 }
 
-unsigned int TextureManager::loadTexture(Image img, bool interpolate,
+unsigned int TextureManager::loadTexture(const Image& img, bool interpolate,
                                          float anisotropicFilterSize, int mipmapLevels)
 {
+    TextureInfo info;
+    info.interpolate = interpolate;
+    info.anisotropicFilterSize = anisotropicFilterSize;
+    info.mipmapLevels = mipmapLevels;
+    info.size = textureSize(img, mipmapLevels);
+    info.nLevels = numberOfLevels(img, mipmapLevels);
+    makeRoom(info.size);
+
     GLuint t = uploadImage(img, interpolate, mipmapLevels, anisotropicFilterSize);
-    _textures.push_back(t);
+    addTexture(t, std::move(info));
 
     return t;
 }
 
+unsigned int TextureManager::loadTexture(const CompressedTexture& texture,
+                                         bool interpolate, float anisotropicFilterSize)
+{
+    if (texture.levels.empty()) {
+        return 0;
+    }
+
+    TextureInfo info;
+    info.interpolate = interpolate;
+    info.anisotropicFilterSize = anisotropicFilterSize;
+    info.size = texture.data.size();
+    info.nLevels = static_cast<int>(texture.levels.size());
+    makeRoom(info.size);
+
+    GLuint t = uploadCompressedTexture(texture, interpolate, anisotropicFilterSize);
+    addTexture(t, std::move(info));
+
+    return t;
+}
+
+std::shared_future<unsigned int> TextureManager::loadTextureAsync(
+                                            const std::string& filename, bool interpolate,
+                                            float anisotropicFilterSize, int mipmapLevels)
+{
+    std::shared_ptr<AsyncLoad> load = std::make_shared<AsyncLoad>();
+    load->filename = filename;
+    load->interpolate = interpolate;
+    load->anisotropicFilterSize = anisotropicFilterSize;
+    load->mipmapLevels = mipmapLevels;
+    std::shared_future<unsigned int> res = load->promise.get_future().share();
+
+    submitAsyncLoad(std::move(load));
+    return res;
+}
+
+void TextureManager::submitAsyncLoad(std::shared_ptr<AsyncLoad> load) {
+    // The job owns a reference so that the load outlives the TextureManager if needed
+    JobSystem::instance().submit([load]() {
+        ZoneScopedN("Decode texture")
+        try {
+            if (isCompressedTextureFile(load->filename)) {
+                load->compressed = loadUprightTexture(load->filename);
+            }
+            else {
+                load->image.load(load->filename);
+            }
+        }
+        catch (...) {
+            load->error = std::current_exception();
+        }
+        load->isDecoded = true;
+    });
+
+    _asyncLoads.push_back(std::move(load));
+}
+
+void TextureManager::update() {
+    // The frame counter orders the uses of the textures for the eviction
+    _frame++;
+
+    if (_asyncLoads.empty()) {
+        return;
+    }
+
+    ZoneScoped
+
+    const size_t budget =
+        static_cast<size_t>(Settings::instance().textureUploadBudget()) * 1024 * 1024;
+    if (!_stagingBuffer || _stagingBuffer->segmentSize != budget) {
+        _stagingBuffer = std::make_unique<StagingBuffer>(budget);
+    }
+    if (!_stagingBuffer->begin()) {
+        // The GPU has not caught up with the uploads yet, so we rather wait a frame than
+        // stalling this one
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    bool hasFinished = false;
+    size_t nBytes = 0;
+    auto it = _asyncLoads.begin();
+    while (it != _asyncLoads.end() && nBytes < budget) {
+        AsyncLoad& load = **it;
+        if (!load.isDecoded) {
+            // Images that finished decoding earlier can be uploaded in the meantime
+            ++it;
+            continue;
+        }
+        if (load.error) {
+            if (load.isReload) {
+                Log::Error(fmt::format(
+                    "Could not reload texture '{}' [id={}]", load.filename, load.texture
+                ));
+                TextureInfo& info = _textures.at(load.texture);
+                info.isLoading = false;
+                // Keep the placeholder instead of trying again on every use
+                info.filename.clear();
+            }
+            else {
+                load.promise.set_exception(load.error);
+            }
+            it = _asyncLoads.erase(it);
+            continue;
+        }
+
+        if (!load.isUploading) {
+            beginUpload(load);
+        }
+        nBytes += load.compressed ?
+            uploadBlocks(load, budget - nBytes) :
+            uploadRows(load, budget - nBytes);
+        const bool isComplete = load.compressed ?
+            load.nextLevel == static_cast<int>(load.compressed->levels.size()) :
+            load.nextRow == load.image.size().y;
+        if (!isComplete) {
+            // The budget is used up for this frame
+            break;
+        }
+
+        finishUpload(load);
+        if (!load.isReload) {
+            Log::Debug(fmt::format(
+                "Texture created from '{}' [id={}]", load.filename, load.texture
+            ));
+            load.promise.set_value(load.texture);
+        }
+        hasFinished = true;
+        it = _asyncLoads.erase(it);
+    }
+
+    _stagingBuffer->end();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (hasFinished) {
+        // Make the finished textures visible to the other contexts that share them
+        glFlush();
+    }
+}
+
+void TextureManager::beginUpload(AsyncLoad& load) {
+    TextureInfo info;
+    if (load.isReload) {
+        info = _textures.at(load.texture);
+        info.isResident = true;
+    }
+    else {
+        info.filename = load.filename;
+        info.interpolate = load.interpolate;
+        info.anisotropicFilterSize = load.anisotropicFilterSize;
+        info.mipmapLevels = load.mipmapLevels;
+    }
+    if (load.compressed) {
+        info.size = load.compressed->data.size();
+        info.nLevels = static_cast<int>(load.compressed->levels.size());
+    }
+    else {
+        info.size = textureSize(load.image, info.mipmapLevels);
+        info.nLevels = numberOfLevels(load.image, info.mipmapLevels);
+    }
+    info.isLoading = true;
+
+    // With a bound pixel unpack buffer, a null pointer would be read as an offset into it
+    // instead of allocating the storage without data
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    makeRoom(info.size);
+    if (load.isReload) {
+        // A reloaded texture is in use while it is uploaded, so its placeholder moves to
+        // the level after the uploaded ones and stays the only one that is sampled. If
+        // the texture has all levels that OpenGL supports, the placeholder takes the
+        // last one, which is 1 by 1 texel and is written in the frame that completes it
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        load.placeholderLevel = std::min(
+            info.nLevels,
+            numberOfMipmapLevels(ivec2{ maxSize, maxSize }) - 1
+        );
+        glBindTexture(GL_TEXTURE_2D, load.texture);
+        setPlaceholder(load.placeholderLevel);
+    }
+    if (load.compressed) {
+        // The levels are allocated when their upload begins
+        if (!load.isReload) {
+            glGenTextures(1, &load.texture);
+        }
+    }
+    else {
+        load.texture = createTexture(load.image, nullptr, load.texture);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+
+    addTexture(load.texture, std::move(info));
+    load.isUploading = true;
+}
+
+size_t TextureManager::uploadRows(AsyncLoad& load, size_t budget) {
+    const Image& img = load.image;
+    glBindTexture(GL_TEXTURE_2D, load.texture);
+
+    const size_t rowSize = static_cast<size_t>(img.size().x) * img.channels();
+    const int nRows = std::min(
+        img.size().y - load.nextRow,
+        static_cast<int>(std::max<size_t>(budget / rowSize, 1))
+    );
+    const size_t size = rowSize * nRows;
+    const unsigned char* data = img.data() + rowSize * load.nextRow;
+    const GLenum type = textureFormat(img.channels()).first;
+
+    std::optional<size_t> offset = _stagingBuffer->write(data, size);
+    if (offset) {
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            load.nextRow,
+            img.size().x,
+            nRows,
+            type,
+            GL_UNSIGNED_BYTE,
+            reinterpret_cast<const void*>(*offset)
+        );
+    }
+    else {
+        // A single row that is larger than the remaining staging buffer is uploaded
+        // from the image directly
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            load.nextRow,
+            img.size().x,
+            nRows,
+            type,
+            GL_UNSIGNED_BYTE,
+            data
+        );
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+    }
+
+    load.nextRow += nRows;
+    return size;
+}
+
+size_t TextureManager::uploadBlocks(AsyncLoad& load, size_t budget) {
+    const CompressedTexture& texture = *load.compressed;
+    const CompressedTexture::Level& level = texture.levels[load.nextLevel];
+    const GLenum internalFormat = compressedFormat(texture.format, texture.isSrgb);
+    glBindTexture(GL_TEXTURE_2D, load.texture);
+
+    if (load.nextRow == 0) {
+        // The storage of a level is allocated only now, as the placeholder of a reloaded
+        // texture can occupy the last level until then
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glCompressedTexImage2D(
+            GL_TEXTURE_2D,
+            load.nextLevel,
+            internalFormat,
+            level.size.x,
+            level.size.y,
+            0,
+            static_cast<GLsizei>(level.dataSize),
+            nullptr
+        );
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+    }
+
+    // The level is uploaded in whole rows of blocks that cover 4 rows of pixels each
+    const size_t rowSize = level.dataSize / ((level.size.y + 3) / 4);
+    const int nRows = std::min(
+        (level.size.y - load.nextRow + 3) / 4,
+        static_cast<int>(std::max<size_t>(budget / rowSize, 1))
+    );
+    const int height = std::min(nRows * 4, level.size.y - load.nextRow);
+    const size_t size = rowSize * nRows;
+    const unsigned char* data =
+        texture.data.data() + level.offset + rowSize * (load.nextRow / 4);
+
+    std::optional<size_t> offset = _stagingBuffer->write(data, size);
+    if (!offset) {
+        // A single row of blocks that is larger than the remaining staging buffer is
+        // uploaded from the texture directly
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glCompressedTexSubImage2D(
+        GL_TEXTURE_2D,
+        load.nextLevel,
+        0,
+        load.nextRow,
+        level.size.x,
+        height,
+        internalFormat,
+        static_cast<GLsizei>(size),
+        offset ? reinterpret_cast<const void*>(*offset) : data
+    );
+    if (!offset) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+    }
+
+    load.nextRow += height;
+    if (load.nextRow == level.size.y) {
+        load.nextLevel++;
+        load.nextRow = 0;
+    }
+    return size;
+}
+
+void TextureManager::finishUpload(AsyncLoad& load) {
+    TextureInfo& info = _textures.at(load.texture);
+    glBindTexture(GL_TEXTURE_2D, load.texture);
+    if (load.compressed) {
+        // The mipmap levels are taken from the file, as generating them at runtime is
+        // not supported for compressed formats
+        setTextureParameters(info.interpolate, info.nLevels, info.anisotropicFilterSize);
+    }
+    else {
+        finalizeTexture(info.interpolate, info.mipmapLevels, info.anisotropicFilterSize);
+    }
+    info.isLoading = false;
+    info.lastUsed = _frame;
+
+    if (load.isReload) {
+        if (load.placeholderLevel >= info.nLevels) {
+            // The placeholder is no longer sampled and its level is released
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                load.placeholderLevel,
+                GL_RGBA8,
+                0,
+                0,
+                0,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                nullptr
+            );
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _stagingBuffer->buffer);
+        }
+        _statistics.nReloads++;
+        Log::Debug(fmt::format(
+            "Texture reloaded from '{}' [id={}]", info.filename, load.texture
+        ));
+    }
+}
+
+void TextureManager::addTexture(unsigned int textureId, TextureInfo info) {
+    info.lastUsed = _frame;
+    _statistics.nBytesResident += info.size;
+    _statistics.maxBytesResident =
+        std::max(_statistics.maxBytesResident, _statistics.nBytesResident);
+    _textures[textureId] = std::move(info);
+}
+
+void TextureManager::makeRoom(size_t size) {
+    const size_t budget =
+        static_cast<size_t>(Settings::instance().textureMemoryBudget()) * 1024 * 1024;
+    if (budget == 0) {
+        return;
+    }
+
+    while (_statistics.nBytesResident + size > budget) {
+        // Textures that were used in the current frame are still needed for rendering
+        auto lru = _textures.end();
+        for (auto it = _textures.begin(); it != _textures.end(); ++it) {
+            const TextureInfo& info = it->second;
+            const bool isEvictable = info.isResident && !info.isLoading &&
+                !info.filename.empty() && info.lastUsed < _frame;
+            if (isEvictable && (lru == _textures.end() ||
+                info.lastUsed < lru->second.lastUsed))
+            {
+                lru = it;
+            }
+        }
+
+        if (lru == _textures.end()) {
+            if (!_hasWarnedAboutBudget) {
+                Log::Warning(fmt::format(
+                    "Texture memory budget of {} MB is exceeded and no texture can be "
+                    "evicted", budget / (1024 * 1024)
+                ));
+                _hasWarnedAboutBudget = true;
+            }
+            return;
+        }
+        evict(lru->first, lru->second);
+    }
+}
+
+void TextureManager::evict(unsigned int textureId, TextureInfo& info) {
+    ZoneScoped
+
+    GLint unpackBuffer = 0;
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    // Respecifying the levels with an empty size releases their storage. The first level
+    // is replaced by a single transparent texel so that the texture stays complete
+    for (int i = 1; i < info.nLevels; ++i) {
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    }
+    setPlaceholder(0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(unpackBuffer));
+
+    info.isResident = false;
+    _statistics.nBytesResident -= info.size;
+    _statistics.nEvictions++;
+    Log::Debug(fmt::format("Texture evicted '{}' [id={}]", info.filename, textureId));
+}
+
+void TextureManager::use(unsigned int textureId) {
+    const auto it = _textures.find(textureId);
+    if (it == _textures.end()) {
+        return;
+    }
+
+    TextureInfo& info = it->second;
+    info.lastUsed = _frame;
+    if (info.isResident || info.isLoading || info.filename.empty()) {
+        return;
+    }
+
+    info.isLoading = true;
+    std::shared_ptr<AsyncLoad> load = std::make_shared<AsyncLoad>();
+    load->filename = info.filename;
+    load->texture = textureId;
+    load->isReload = true;
+    submitAsyncLoad(std::move(load));
+}
+
+TextureManager::Statistics TextureManager::statistics() const {
+    Statistics res = _statistics;
+    res.nTextures = static_cast<int>(_textures.size());
+    res.nEvicted = static_cast<int>(std::count_if(
+        _textures.begin(),
+        _textures.end(),
+        [](const std::pair<const unsigned int, TextureInfo>& p) {
+            return !p.second.isResident;
+        }
+    ));
+    return res;
+}
+
 void TextureManager::removeTexture(unsigned int textureId) {
-    _textures.erase(
-        std::remove(_textures.begin(), _textures.end(), textureId),
-        _textures.end()
+    const auto it = _textures.find(textureId);
+    if (it != _textures.end()) {
+        if (it->second.isResident) {
+            _statistics.nBytesResident -= it->second.size;
+        }
+        _textures.erase(it);
+    }
+
+    // A pending upload would otherwise continue into the deleted name
+    _asyncLoads.erase(
+        std::remove_if(
+            _asyncLoads.begin(),
+            _asyncLoads.end(),
+            [textureId](const std::shared_ptr<AsyncLoad>& load) {
+                return load->texture == textureId;
+            }
+        ),
+        _asyncLoads.end()
     );
 
     glDeleteTextures(1, &textureId);
@@ -0,0 +1,227 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/videopipe.h>
+
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <sgct/log.h>
+#include <sgct/pixelconversion.h>
+#include <sgct/profiling.h>
+#include <cstring>
+
+#ifndef WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif // WIN32
+
+#define Err(code, msg) Error(Error::Component::Image, code, msg)
+
+namespace sgct {
+
+VideoPipe::VideoPipe(const std::string& command, Format format, ivec2 size, int channels,
+                     int bytesPerChannel, int frameRate, int queueSize,
+                     Settings::CaptureQueuePolicy policy)
+    : _command(command)
+    , _format(format)
+    , _size(size)
+    , _channels(channels)
+    , _bytesPerChannel(bytesPerChannel)
+    , _policy(policy)
+{
+    ZoneScoped
+
+#ifdef WIN32
+    _pipe = _popen(_command.c_str(), "wb");
+#else // WIN32
+    _pipe = popen(_command.c_str(), "w");
+#endif // WIN32
+    if (!_pipe) {
+        throw Err(9018, fmt::format("Could not start encoder '{}'", _command));
+    }
+    // All data is written by the writer thread, nothing is left to be flushed by others
+    std::setvbuf(_pipe, nullptr, _IONBF, 0);
+
+    const size_t frameSize =
+        static_cast<size_t>(_size.x) * _size.y * _channels * _bytesPerChannel;
+    _frames.resize(queueSize, std::vector<unsigned char>(frameSize));
+
+    if (_format == Format::Y4M) {
+        const size_t chromaSize =
+            static_cast<size_t>((_size.x + 1) / 2) * ((_size.y + 1) / 2);
+        _yuv.resize(static_cast<size_t>(_size.x) * _size.y + 2 * chromaSize);
+
+        _header = fmt::format(
+            "YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+            _size.x, _size.y, frameRate
+        );
+    }
+
+    Log::Info(fmt::format(
+        "Streaming {}x{} frames to encoder '{}'", _size.x, _size.y, _command
+    ));
+    _writer = std::thread(&VideoPipe::writerLoop, this);
+}
+
+VideoPipe::~VideoPipe() {
+    // The thread writes all queued frames before it exits
+    {
+        std::unique_lock lock(_mutex);
+        _isRunning = false;
+    }
+    _hasFrame.notify_all();
+    _writer.join();
+
+#ifdef WIN32
+    const int res = _pclose(_pipe);
+#else // WIN32
+    const int res = pclose(_pipe);
+#endif // WIN32
+    if (res != 0) {
+        Log::Warning(fmt::format("Encoder '{}' exited with status {}", _command, res));
+    }
+    Log::Info(fmt::format(
+        "Encoder '{}': {} frames written, {} dropped", _command, _nWritten, _nDropped
+    ));
+}
+
+void VideoPipe::push(const unsigned char* data) {
+    ZoneScoped
+
+    std::unique_lock lock(_mutex);
+    if (_hasFailed) {
+        return;
+    }
+    if (_count == _frames.size()) {
+        if (_policy == Settings::CaptureQueuePolicy::Drop) {
+            _nDropped++;
+            lock.unlock();
+            Log::Warning("Encoder queue full, dropping frame");
+            return;
+        }
+
+        ZoneScopedN("Wait for encoder queue")
+        _hasSpace.wait(lock, [this]() { return _count < _frames.size() || _hasFailed; });
+        if (_hasFailed) {
+            return;
+        }
+    }
+
+    // The writer thread does not touch the free slots, so we can copy without the lock
+    std::vector<unsigned char>& frame = _frames[(_first + _count) % _frames.size()];
+    lock.unlock();
+    std::memcpy(frame.data(), data, frame.size());
+    lock.lock();
+    _count++;
+    lock.unlock();
+    _hasFrame.notify_one();
+}
+
+void VideoPipe::writerLoop() {
+#ifndef WIN32
+    // If the process exits early, writing into the pipe raises a signal that ends the
+    // application. Blocking it on this thread makes the write fail with an error instead
+    // without changing the signal handling of the rest of the application
+    sigset_t sigpipe;
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe, nullptr);
+#endif // WIN32
+
+    if (!_header.empty() &&
+        std::fwrite(_header.data(), 1, _header.size(), _pipe) != _header.size())
+    {
+        consumeBrokenPipeSignal();
+        std::unique_lock lock(_mutex);
+        _hasFailed = true;
+        Log::Error(fmt::format("Could not write to encoder '{}'", _command));
+    }
+
+    while (true) {
+        std::vector<unsigned char>* frame = nullptr;
+        {
+            std::unique_lock lock(_mutex);
+            _hasFrame.wait(lock, [this]() { return _count > 0 || !_isRunning; });
+            if (_count == 0) {
+                // We are shutting down and there is nothing left to do
+                return;
+            }
+            frame = &_frames[_first];
+        }
+
+        // Only this thread sets the failure flag, so it can be read without the lock
+        const bool success = !_hasFailed && writeFrame(*frame);
+
+        {
+            std::unique_lock lock(_mutex);
+            _first = (_first + 1) % _frames.size();
+            _count--;
+            if (success) {
+                _nWritten++;
+            }
+            else if (!_hasFailed) {
+                consumeBrokenPipeSignal();
+                _hasFailed = true;
+                Log::Error(fmt::format(
+                    "Could not write to encoder '{}'. Stopping the capture", _command
+                ));
+            }
+        }
+        _hasSpace.notify_all();
+    }
+}
+
+void VideoPipe::consumeBrokenPipeSignal() {
+#ifndef WIN32
+    // The signal of a failed write stays pending on this thread as it is blocked
+    sigset_t pending;
+    sigpending(&pending);
+    if (sigismember(&pending, SIGPIPE)) {
+        sigset_t sigpipe;
+        sigemptyset(&sigpipe);
+        sigaddset(&sigpipe, SIGPIPE);
+        int signal = 0;
+        sigwait(&sigpipe, &signal);
+    }
+#endif // WIN32
+}
+
+bool VideoPipe::writeFrame(std::vector<unsigned char>& frame) {
+    ZoneScoped
+
+    if (_format == Format::Raw) {
+        return std::fwrite(frame.data(), 1, frame.size(), _pipe) == frame.size();
+    }
+
+    if (_bytesPerChannel == 2) {
+        // Keep the most significant byte of each little-endian 16 bit value
+        const size_t nValues = frame.size() / 2;
+        for (size_t i = 0; i < nValues; ++i) {
+            frame[i] = frame[2 * i + 1];
+        }
+    }
+
+    const size_t lumaSize = static_cast<size_t>(_size.x) * _size.y;
+    const size_t chromaSize = (_yuv.size() - lumaSize) / 2;
+    bgrToYuv420(
+        frame.data(),
+        _size.x,
+        _size.y,
+        _channels,
+        _yuv.data(),
+        _yuv.data() + lumaSize,
+        _yuv.data() + lumaSize + chromaSize
+    );
+
+    constexpr const char FrameHeader[] = "FRAME\n";
+    constexpr const size_t HeaderSize = sizeof(FrameHeader) - 1;
+    return std::fwrite(FrameHeader, 1, HeaderSize, _pipe) == HeaderSize &&
+           std::fwrite(_yuv.data(), 1, _yuv.size(), _pipe) == _yuv.size();
+}
+
+} // namespace sgct
@@ -344,6 +344,10 @@ void Viewport::setMpcdiWarpMesh(std::vector<char> data) {
     _mpcdiWarpMesh = std::move(data);
 }
 
+void Viewport::parseMesh() {
+    _mesh.parseMesh(_mpcdiWarpMesh.empty() ? _meshFilename : "mesh.mpcdi", *this);
+}
+
 void Viewport::loadData() {
     ZoneScoped
 
@@ -332,11 +332,9 @@ void Window::initOGL() {
     initScreenCapture();
     loadShaders();
 
+    const ivec2 res = framebufferResolution();
     for (const std::unique_ptr<Viewport>& vp : _viewports) {
-        const vec2 viewportSize = vec2{
-            _framebufferRes.x * vp->size().x,
-            _framebufferRes.y * vp->size().y
-        };
+        const vec2 viewportSize = vec2{ res.x * vp->size().x, res.y * vp->size().y };
         vp->initialize(
             viewportSize,
             _stereoMode != StereoMode::NoStereo,
@@ -448,6 +446,13 @@ void Window::setFramebufferResolution(ivec2 resolution) {
     }
 }
 
+void Window::setResolutionScale(float scale) {
+    // Deferred for the same reason as the framebuffer resolution above
+    if (scale != _resolutionScale) {
+        _pendingResolutionScale = std::clamp(scale, 0.1f, 1.f);
+    }
+}
+
 void Window::swap(bool takeScreenshot) {
     if (!(_isVisible || _shouldRenderWhileHidden)) {
         return;
@@ -455,6 +460,13 @@ void Window::swap(bool takeScreenshot) {
 
     makeOpenGLContextCurrent();
 
+    if (_screenCaptureLeftOrMono) {
+        _screenCaptureLeftOrMono->processPendingReadbacks();
+    }
+    if (_screenCaptureRight) {
+        _screenCaptureRight->processPendingReadbacks();
+    }
+
     if (takeScreenshot) {
         ZoneScopedN("Take Screenshot")
         if (Settings::instance().captureFromBackBuffer() && _isDoubleBuffered) {
@@ -536,6 +548,17 @@ void Window::updateResolutions() {
 
         _pendingFramebufferRes = std::nullopt;
     }
+
+    if (_pendingResolutionScale.has_value()) {
+        _resolutionScale = *_pendingResolutionScale;
+        _hasNewResolutionScale = true;
+
+        Log::Debug(fmt::format(
+            "Resolution scale changed to {} for window {}", _resolutionScale, _id
+        ));
+
+        _pendingResolutionScale = std::nullopt;
+    }
 }
 
 void Window::setHorizFieldOfView(float hFovDeg) {
@@ -563,7 +586,7 @@ void Window::initWindowResolution(ivec2 resolution) {
 void Window::update() {
     ZoneScoped
 
-    if (!_isVisible || !isWindowResized()) {
+    if (!_isVisible || !(isWindowResized() || _hasNewResolutionScale)) {
         return;
     }
     makeOpenGLContextCurrent();
@@ -593,15 +616,19 @@ void Window::update() {
     }
 
     // resize non linear projection buffers
+    const ivec2 res = framebufferResolution();
     for (const std::unique_ptr<Viewport>& vp : _viewports) {
         if (vp->hasSubViewports()) {
-            const vec2 viewport = vec2{
-                _framebufferRes.x * vp->size().x,
-                _framebufferRes.y * vp->size().y
-            };
-            vp->nonLinearProjection()->update(viewport);
+            NonLinearProjection* nonLinearProj = vp->nonLinearProjection();
+            if (_hasNewResolutionScale) {
+                nonLinearProj->setResolutionScale(_resolutionScale);
+            }
+            const vec2 viewport = vec2{ res.x * vp->size().x, res.y * vp->size().y };
+            nonLinearProj->update(viewport);
         }
     }
+
+    _hasNewResolutionScale = false;
 }
 
 void Window::makeSharedContextCurrent() {
@@ -956,6 +983,8 @@ void Window::initScreenCapture() {
                 case CF::PNG: return ScreenCapture::CaptureFormat::PNG;
                 case CF::TGA: return ScreenCapture::CaptureFormat::TGA;
                 case CF::JPG: return ScreenCapture::CaptureFormat::JPEG;
+                case CF::QOI: return ScreenCapture::CaptureFormat::QOI;
+                case CF::Raw: return ScreenCapture::CaptureFormat::Raw;
                 default: throw std::logic_error("Unhandled case label");
             }
         }(format);
@@ -1014,7 +1043,8 @@ void Window::createTextures() {
 
     GLint max;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max);
-    if (_framebufferRes.x > max || _framebufferRes.y > max) {
+    const ivec2 res = framebufferResolution();
+    if (res.x > max || res.y > max) {
         Log::Error(fmt::format(
             "Window {}: Requested framebuffer too big (Max: {})", _id, max
         ));
@@ -1067,7 +1097,7 @@ void Window::generateTexture(unsigned int& id, Window::TextureType type) {
         }
     }(type);
 
-    const ivec2 res = _framebufferRes;
+    const ivec2 res = framebufferResolution();
     glTexImage2D(
         GL_TEXTURE_2D,
         0,
@@ -1092,7 +1122,8 @@ void Window::createFBOs() {
     TracyGpuZone("Create FBOs")
 
     _finalFBO->setInternalColorFormat(_internalColorFormat);
-    _finalFBO->createFBO(_framebufferRes.x, _framebufferRes.y, _nAASamples, _isMirrored);
+    const ivec2 res = framebufferResolution();
+    _finalFBO->createFBO(res.x, res.y, _nAASamples, _isMirrored);
 
     Log::Debug(fmt::format(
         "Window {}: FBO initiated successfully. Number of samples: {}",
@@ -1201,11 +1232,12 @@ GLFWwindow* Window::windowHandle() const {
 }
 
 ivec2 Window::finalFBODimensions() const {
-    return _framebufferRes;
+    return framebufferResolution();
 }
 
 void Window::resizeFBOs() {
-    if (_useFixResolution) {
+    // A fixed resolution only has to be resized if the resolution scale changed
+    if (_useFixResolution && !_hasNewResolutionScale) {
         return;
     }
 
@@ -1213,7 +1245,8 @@ void Window::resizeFBOs() {
     destroyFBOs();
     createTextures();
 
-    _finalFBO->resizeFBO(_framebufferRes.x, _framebufferRes.y, _nAASamples);
+    const ivec2 res = framebufferResolution();
+    _finalFBO->resizeFBO(res.x, res.y, _nAASamples);
 
     if (!_finalFBO->isMultiSampled()) {
         _finalFBO->bind();
@@ -1291,7 +1324,17 @@ ivec2 Window::resolution() const {
 }
 
 ivec2 Window::framebufferResolution() const {
-    return _framebufferRes;
+    if (_resolutionScale == 1.f) {
+        return _framebufferRes;
+    }
+    return ivec2{
+        std::max(static_cast<int>(_framebufferRes.x * _resolutionScale + 0.5f), 1),
+        std::max(static_cast<int>(_framebufferRes.y * _resolutionScale + 0.5f), 1)
+    };
+}
+
+float Window::resolutionScale() const {
+    return _resolutionScale;
 }
 
 ivec2 Window::initialResolution() const {
@@ -0,0 +1,392 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+#include "equality.h"
+
+#include <sgct/compressedtexture.h>
+#include <sgct/error.h>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    void append32(std::vector<unsigned char>& v, uint32_t value) {
+        const size_t pos = v.size();
+        v.resize(pos + 4);
+        std::memcpy(v.data() + pos, &value, 4);
+    }
+
+    void append64(std::vector<unsigned char>& v, uint64_t value) {
+        const size_t pos = v.size();
+        v.resize(pos + 8);
+        std::memcpy(v.data() + pos, &value, 8);
+    }
+
+    void appendKeyValue(std::vector<unsigned char>& v, const std::string& key,
+                        const std::string& value)
+    {
+        const std::string entry = key + '\0' + value + '\0';
+        append32(v, static_cast<uint32_t>(entry.size()));
+        v.insert(v.end(), entry.begin(), entry.end());
+        while (v.size() % 4 != 0) {
+            v.push_back(0);
+        }
+    }
+
+    // Decodes a BC1 block in the 4-color mode into 16 RGB pixels
+    std::array<std::array<int, 3>, 16> decodeBC1(const unsigned char* block) {
+        auto unpack = [](uint16_t c) {
+            const int r = (c >> 11) & 31;
+            const int g = (c >> 5) & 63;
+            const int b = c & 31;
+            return std::array<int, 3>{
+                (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+            };
+        };
+        uint16_t c0;
+        uint16_t c1;
+        uint32_t indices;
+        std::memcpy(&c0, block, 2);
+        std::memcpy(&c1, block + 2, 2);
+        std::memcpy(&indices, block + 4, 4);
+
+        const std::array<int, 3> p0 = unpack(c0);
+        const std::array<int, 3> p1 = unpack(c1);
+        std::array<std::array<int, 3>, 4> palette = { p0, p1, p0, p1 };
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = (2 * p0[i] + p1[i]) / 3;
+            palette[3][i] = (p0[i] + 2 * p1[i]) / 3;
+        }
+
+        std::array<std::array<int, 3>, 16> res;
+        for (int i = 0; i < 16; ++i) {
+            res[i] = palette[(indices >> (2 * i)) & 3];
+        }
+        return res;
+    }
+
+    CompressedTexture testTexture(CompressedTexture::Format format, ivec2 size,
+                                  int nLevels)
+    {
+        CompressedTexture texture;
+        texture.format = format;
+        size_t offset = 0;
+        for (int i = 0; i < nLevels; ++i) {
+            CompressedTexture::Level level;
+            level.size = ivec2{ std::max(size.x >> i, 1), std::max(size.y >> i, 1) };
+            level.offset = offset;
+            level.dataSize = levelSize(format, level.size);
+            offset += level.dataSize;
+            texture.levels.push_back(level);
+        }
+        texture.data.resize(offset);
+        for (size_t i = 0; i < texture.data.size(); ++i) {
+            texture.data[i] = static_cast<unsigned char>(i * 37 + 11);
+        }
+        return texture;
+    }
+} // namespace
+
+TEST_CASE("CompressedTexture/Sizes", "[CompressedTexture]") {
+    CHECK(numberOfMipmapLevels(ivec2{ 1, 1 }) == 1);
+    CHECK(numberOfMipmapLevels(ivec2{ 16, 4 }) == 5);
+    CHECK(numberOfMipmapLevels(ivec2{ 16384, 8192 }) == 15);
+    CHECK(numberOfMipmapLevels(ivec2{ 5, 3 }) == 3);
+
+    CHECK(blockSize(CompressedTexture::Format::BC1) == 8);
+    CHECK(blockSize(CompressedTexture::Format::BC3) == 16);
+    CHECK(levelSize(CompressedTexture::Format::BC1, ivec2{ 5, 3 }) == 16);
+    CHECK(levelSize(CompressedTexture::Format::BC1Alpha, ivec2{ 1, 1 }) == 8);
+    CHECK(levelSize(CompressedTexture::Format::BC7, ivec2{ 16, 8 }) == 128);
+}
+
+TEST_CASE("CompressedTexture/SolidColor", "[CompressedTexture]") {
+    // Pure colors that can be represented exactly in 5:6:5
+    std::vector<unsigned char> pixels(8 * 4 * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i] = 0;       // B
+        pixels[i + 1] = 255; // G
+        pixels[i + 2] = 255; // R
+        pixels[i + 3] = 128; // A
+    }
+
+    const std::vector<unsigned char> bc1 = compressBlocks(
+        pixels.data(), ivec2{ 8, 4 }, 4, CompressedTexture::Format::BC1
+    );
+    REQUIRE(bc1.size() == 16);
+    for (const std::array<int, 3>& p : decodeBC1(bc1.data())) {
+        CHECK(p == std::array<int, 3>{ 255, 255, 0 });
+    }
+
+    const std::vector<unsigned char> bc3 = compressBlocks(
+        pixels.data(), ivec2{ 8, 4 }, 4, CompressedTexture::Format::BC3
+    );
+    REQUIRE(bc3.size() == 32);
+    CHECK(bc3[0] == 128);
+    CHECK(bc3[1] == 128);
+    for (const std::array<int, 3>& p : decodeBC1(bc3.data() + 8)) {
+        CHECK(p == std::array<int, 3>{ 255, 255, 0 });
+    }
+}
+
+TEST_CASE("CompressedTexture/Gradient", "[CompressedTexture]") {
+    // A gray gradient with a partial block at the border
+    const ivec2 size = ivec2{ 6, 5 };
+    std::vector<unsigned char> pixels(static_cast<size_t>(size.x) * size.y);
+    for (int y = 0; y < size.y; ++y) {
+        for (int x = 0; x < size.x; ++x) {
+            pixels[y * size.x + x] = static_cast<unsigned char>(40 + 10 * x + 5 * y);
+        }
+    }
+
+    const std::vector<unsigned char> bc1 =
+        compressBlocks(pixels.data(), size, 1, CompressedTexture::Format::BC1);
+    REQUIRE(bc1.size() == levelSize(CompressedTexture::Format::BC1, size));
+
+    int maxError = 0;
+    for (int by = 0; by < 2; ++by) {
+        for (int bx = 0; bx < 2; ++bx) {
+            const auto block = decodeBC1(bc1.data() + (by * 2 + bx) * 8);
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    const int px = std::min(bx * 4 + x, size.x - 1);
+                    const int py = std::min(by * 4 + y, size.y - 1);
+                    const int v = pixels[py * size.x + px];
+                    for (int c : block[y * 4 + x]) {
+                        maxError = std::max(maxError, std::abs(c - v));
+                    }
+                }
+            }
+        }
+    }
+    CHECK(maxError <= 8);
+}
+
+TEST_CASE("CompressedTexture/DDSRoundtrip", "[CompressedTexture]") {
+    for (CompressedTexture::Format format : { CompressedTexture::Format::BC1,
+        CompressedTexture::Format::BC3, CompressedTexture::Format::BC7 })
+    {
+        CompressedTexture texture = testTexture(format, ivec2{ 16, 8 }, 5);
+        texture.isSrgb = format == CompressedTexture::Format::BC3;
+        // BC7 blocks cannot be flipped, so they are written and read in the file's order
+        texture.isTopDown = format == CompressedTexture::Format::BC7;
+
+        const std::vector<unsigned char> dds = writeDDS(texture);
+        REQUIRE(isCompressedTexture(dds.data(), dds.size()));
+        const CompressedTexture res = readCompressedTexture(dds.data(), dds.size(), "t");
+
+        // BC1 is written through the DXGI format that includes the 1 bit alpha
+        if (format == CompressedTexture::Format::BC1) {
+            CHECK(res.format == CompressedTexture::Format::BC1Alpha);
+        }
+        else {
+            CHECK(res.format == format);
+        }
+        CHECK(res.isSrgb == texture.isSrgb);
+        CHECK(res.isTopDown == texture.isTopDown);
+        REQUIRE(res.levels.size() == texture.levels.size());
+        for (size_t i = 0; i < res.levels.size(); ++i) {
+            CHECK(res.levels[i].size == texture.levels[i].size);
+            CHECK(res.levels[i].offset == texture.levels[i].offset);
+            CHECK(res.levels[i].dataSize == texture.levels[i].dataSize);
+        }
+        CHECK(res.data == texture.data);
+    }
+}
+
+TEST_CASE("CompressedTexture/DDSFlip", "[CompressedTexture]") {
+    // Two rows of blocks; in the file the upper row comes first and the rows of indices
+    // inside of each block are reversed
+    CompressedTexture texture = testTexture(CompressedTexture::Format::BC1, { 4, 8 }, 1);
+    const std::vector<unsigned char> dds = writeDDS(texture);
+    const unsigned char* data = dds.data() + 148;
+
+    CHECK(std::equal(data, data + 4, texture.data.data() + 8));
+    CHECK(data[4] == texture.data[15]);
+    CHECK(data[5] == texture.data[14]);
+    CHECK(data[6] == texture.data[13]);
+    CHECK(data[7] == texture.data[12]);
+    CHECK(std::equal(data + 8, data + 12, texture.data.data()));
+    CHECK(data[12] == texture.data[7]);
+    CHECK(data[15] == texture.data[4]);
+}
+
+TEST_CASE("CompressedTexture/Orientation", "[CompressedTexture]") {
+    // A level with a height of 6 has two padding rows that cannot be flipped exactly, so
+    // all levels keep the order of the file
+    CompressedTexture texture = testTexture(CompressedTexture::Format::BC1, { 8, 12 }, 3);
+    REQUIRE(texture.levels[1].size == ivec2{ 4, 6 });
+    texture.isTopDown = true;
+    const std::vector<unsigned char> dds = writeDDS(texture);
+    const CompressedTexture res = readCompressedTexture(dds.data(), dds.size(), "t");
+    CHECK(res.isTopDown);
+    CHECK(res.data == texture.data);
+    CHECK(std::equal(texture.data.begin(), texture.data.end(), dds.data() + 148));
+
+    // A texture that is stored from bottom to top cannot be written then
+    texture.isTopDown = false;
+    CHECK_THROWS_AS(writeDDS(texture), sgct::Error);
+    texture = testTexture(CompressedTexture::Format::BC7, { 8, 8 }, 1);
+    CHECK_THROWS_AS(writeDDS(texture), sgct::Error);
+
+    // Heights below 4 only use the first rows of the blocks and are flipped exactly
+    texture = testTexture(CompressedTexture::Format::BC3, { 8, 3 }, 1);
+    const std::vector<unsigned char> small = writeDDS(texture);
+    const CompressedTexture smallRes =
+        readCompressedTexture(small.data(), small.size(), "t");
+    CHECK_FALSE(smallRes.isTopDown);
+    CHECK(smallRes.data == texture.data);
+}
+
+TEST_CASE("CompressedTexture/KTX1", "[CompressedTexture]") {
+    auto createFile = [](const std::string& orientation) {
+        std::vector<unsigned char> file = {
+            0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+        };
+        std::vector<unsigned char> keyValue;
+        if (!orientation.empty()) {
+            appendKeyValue(keyValue, "KTXorientation", orientation);
+        }
+        append32(file, 0x04030201);
+        append32(file, 0);      // glType
+        append32(file, 1);      // glTypeSize
+        append32(file, 0);      // glFormat
+        append32(file, 0x83F3); // glInternalFormat
+        append32(file, 0x1908); // glBaseInternalFormat
+        append32(file, 4);      // width
+        append32(file, 8);      // height
+        append32(file, 0);      // depth
+        append32(file, 0);      // array elements
+        append32(file, 1);      // faces
+        append32(file, 2);      // mipmap levels
+        append32(file, static_cast<uint32_t>(keyValue.size()));
+        file.insert(file.end(), keyValue.begin(), keyValue.end());
+
+        append32(file, 32);
+        for (int i = 0; i < 32; ++i) {
+            file.push_back(static_cast<unsigned char>(i));
+        }
+        append32(file, 16);
+        for (int i = 0; i < 16; ++i) {
+            file.push_back(static_cast<unsigned char>(100 + i));
+        }
+        return file;
+    };
+
+    const std::vector<unsigned char> file = createFile("");
+    const CompressedTexture texture = readCompressedTexture(file.data(), file.size(), "t");
+    CHECK(texture.format == CompressedTexture::Format::BC3);
+    CHECK_FALSE(texture.isSrgb);
+    REQUIRE(texture.levels.size() == 2);
+    CHECK(texture.levels[0].size == ivec2{ 4, 8 });
+    CHECK(texture.levels[1].size == ivec2{ 2, 4 });
+    REQUIRE(texture.data.size() == 48);
+    for (int i = 0; i < 32; ++i) {
+        CHECK(texture.data[i] == i);
+    }
+    CHECK(texture.data[32] == 100);
+
+    // A file that is stored from top to bottom is flipped
+    const std::vector<unsigned char> flipped = createFile("S=r,T=d");
+    const CompressedTexture t2 = readCompressedTexture(flipped.data(), flipped.size(), "t");
+    CHECK_FALSE(t2.isTopDown);
+    CHECK(t2.data[0] == 16);
+    CHECK(t2.data[16] == 0);
+    CHECK(t2.data[16 + 8 + 4] == 15);
+    CHECK(t2.data[16 + 8 + 7] == 12);
+}
+
+TEST_CASE("CompressedTexture/KTX2", "[CompressedTexture]") {
+    auto createFile = [](const std::string& orientation) {
+        std::vector<unsigned char> file = {
+            0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+        };
+        std::vector<unsigned char> keyValue;
+        if (!orientation.empty()) {
+            appendKeyValue(keyValue, "KTXorientation", orientation);
+        }
+        append32(file, 146); // BC7 sRGB
+        append32(file, 1);   // type size
+        append32(file, 8);   // width
+        append32(file, 4);   // height
+        append32(file, 0);   // depth
+        append32(file, 0);   // layers
+        append32(file, 1);   // faces
+        append32(file, 1);   // levels
+        append32(file, 0);   // supercompression
+        append32(file, 0);   // dfd offset
+        append32(file, 0);   // dfd length
+        append32(file, 104); // key/value offset
+        append32(file, static_cast<uint32_t>(keyValue.size()));
+        append64(file, 0);   // sgd offset
+        append64(file, 0);   // sgd length
+
+        append64(file, 104 + keyValue.size());
+        append64(file, 32);
+        append64(file, 32);
+        file.insert(file.end(), keyValue.begin(), keyValue.end());
+        for (int i = 0; i < 32; ++i) {
+            file.push_back(static_cast<unsigned char>(i));
+        }
+        return file;
+    };
+
+    const std::vector<unsigned char> file = createFile("ru");
+    const CompressedTexture texture = readCompressedTexture(file.data(), file.size(), "t");
+    CHECK(texture.format == CompressedTexture::Format::BC7);
+    CHECK(texture.isSrgb);
+    CHECK_FALSE(texture.isTopDown);
+    REQUIRE(texture.levels.size() == 1);
+    CHECK(texture.levels[0].size == ivec2{ 8, 4 });
+    REQUIRE(texture.data.size() == 32);
+    for (int i = 0; i < 32; ++i) {
+        CHECK(texture.data[i] == i);
+    }
+
+    // BC7 textures that are stored from top to bottom cannot be flipped
+    const std::vector<unsigned char> topDown = createFile("rd");
+    const CompressedTexture t2 =
+        readCompressedTexture(topDown.data(), topDown.size(), "t");
+    CHECK(t2.isTopDown);
+    CHECK(t2.data == texture.data);
+}
+
+TEST_CASE("CompressedTexture/Invalid", "[CompressedTexture]") {
+    const std::vector<unsigned char> garbage(256, 42);
+    CHECK_FALSE(isCompressedTexture(garbage.data(), garbage.size()));
+    CHECK_THROWS_AS(
+        readCompressedTexture(garbage.data(), garbage.size(), "t"),
+        sgct::Error
+    );
+
+    // Truncated file
+    CompressedTexture texture = testTexture(CompressedTexture::Format::BC1, { 8, 8 }, 1);
+    std::vector<unsigned char> dds = writeDDS(texture);
+    dds.resize(dds.size() - 1);
+    CHECK_THROWS_AS(readCompressedTexture(dds.data(), dds.size(), "t"), sgct::Error);
+
+    // Cube map
+    dds = writeDDS(texture);
+    const uint32_t caps2 = 0x200;
+    std::memcpy(dds.data() + 4 + 108, &caps2, 4);
+    CHECK_THROWS_AS(readCompressedTexture(dds.data(), dds.size(), "t"), sgct::Error);
+
+    // A header that claims a huge texture is rejected before the memory is allocated
+    for (uint32_t extent : { 65535u, 0x7fffffffu }) {
+        dds = writeDDS(texture);
+        std::memcpy(dds.data() + 4 + 8, &extent, 4);
+        std::memcpy(dds.data() + 4 + 12, &extent, 4);
+        CHECK_THROWS_AS(readCompressedTexture(dds.data(), dds.size(), "t"), sgct::Error);
+    }
+}
@@ -6554,6 +6554,18 @@ TEST_CASE("Capture/Format", "[roundtrip]") {
         sgct::config::Cluster output = sgct::readJsonConfig(str);
         REQUIRE(input == output);
     }
+
+    {
+        sgct::config::Cluster input;
+        input.success = true;
+
+        input.capture = sgct::config::Capture();
+        input.capture->format = sgct::config::Capture::Format::QOI;
+
+        std::string str = sgct::serializeConfig(input);
+        sgct::config::Cluster output = sgct::readJsonConfig(str);
+        REQUIRE(input == output);
+    }
 }
 
 TEST_CASE("Capture/ScreenShotRange", "[roundtrip]") {
@@ -0,0 +1,159 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/correction/decimation.h>
+#include <cmath>
+#include <functional>
+
+using namespace sgct;
+using namespace sgct::correction;
+
+namespace {
+    constexpr const ivec2 Resolution = ivec2{ 1024, 1024 };
+
+    // Creates a grid that covers [-1, 1] with the texture coordinates given by the warp
+    Buffer createGrid(unsigned int nCols, unsigned int nRows,
+                      const std::function<vec2(float, float)>& warp)
+    {
+        Buffer buf;
+        for (unsigned int r = 0; r < nRows; ++r) {
+            for (unsigned int c = 0; c < nCols; ++c) {
+                const float u = static_cast<float>(c) / (nCols - 1);
+                const float v = static_cast<float>(r) / (nRows - 1);
+                const vec2 st = warp(u, v);
+
+                CorrectionMeshVertex vertex;
+                vertex.x = 2.f * u - 1.f;
+                vertex.y = 2.f * v - 1.f;
+                vertex.s = st.x;
+                vertex.t = st.y;
+                vertex.r = 1.f;
+                vertex.g = 1.f;
+                vertex.b = 1.f;
+                vertex.a = 1.f;
+                buf.vertices.push_back(vertex);
+            }
+        }
+        buf.grids = { Grid{ 0, nCols, nRows } };
+        return buf;
+    }
+
+    float signedArea(const CorrectionMeshVertex& a, const CorrectionMeshVertex& b,
+                     const CorrectionMeshVertex& c)
+    {
+        return 0.5f * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+    }
+
+    // Returns the largest texture coordinate error in pixels at the original vertices
+    float maxError(const Buffer& original, const Buffer& decimated) {
+        float res = 0.f;
+        for (const CorrectionMeshVertex& v : original.vertices) {
+            bool isFound = false;
+            for (size_t i = 0; i < decimated.indices.size() && !isFound; i += 3) {
+                const CorrectionMeshVertex& a = decimated.vertices[decimated.indices[i]];
+                const CorrectionMeshVertex& b =
+                    decimated.vertices[decimated.indices[i + 1]];
+                const CorrectionMeshVertex& c =
+                    decimated.vertices[decimated.indices[i + 2]];
+                const float area = signedArea(a, b, c);
+                const float la = signedArea(v, b, c) / area;
+                const float lb = signedArea(a, v, c) / area;
+                const float lc = signedArea(a, b, v) / area;
+                constexpr const float Eps = -1e-5f;
+                if (la < Eps || lb < Eps || lc < Eps) {
+                    continue;
+                }
+                isFound = true;
+                const float s = la * a.s + lb * b.s + lc * c.s;
+                const float t = la * a.t + lb * b.t + lc * c.t;
+                res = std::max(res, std::abs(s - v.s) * Resolution.x);
+                res = std::max(res, std::abs(t - v.t) * Resolution.y);
+            }
+            REQUIRE(isFound);
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("Decimation/Linear", "[Decimation]") {
+    Buffer buf = createGrid(65, 33, [](float u, float v) { return vec2{ u, v }; });
+    const size_t nVertices = buf.vertices.size();
+
+    const size_t nRemoved = decimateMesh(buf, 0.5f, Resolution);
+    CHECK(nRemoved == nVertices - buf.vertices.size());
+    CHECK(buf.vertices.size() <= 9);
+    CHECK(buf.geometryType == 0x0004);
+    CHECK(buf.grids.empty());
+    CHECK(buf.indices.size() % 3 == 0);
+}
+
+TEST_CASE("Decimation/Curved", "[Decimation]") {
+    auto warp = [](float u, float v) {
+        return vec2{ u + 0.05f * std::sin(6.f * u) * v, v + 0.02f * u * u };
+    };
+    const Buffer original = createGrid(97, 65, warp);
+
+    for (float error : { 0.25f, 1.f, 4.f }) {
+        Buffer buf = original;
+        decimateMesh(buf, error, Resolution);
+        CHECK(buf.vertices.size() < original.vertices.size());
+        CHECK(maxError(original, buf) <= error * 1.01f);
+
+        // All triangles have the same orientation and cover the grid exactly, so there
+        // are no cracks or overlaps
+        float area = 0.f;
+        for (size_t i = 0; i < buf.indices.size(); i += 3) {
+            const float a = signedArea(
+                buf.vertices[buf.indices[i]],
+                buf.vertices[buf.indices[i + 1]],
+                buf.vertices[buf.indices[i + 2]]
+            );
+            CHECK(a > 0.f);
+            area += a;
+        }
+        CHECK(area == Approx(4.f));
+    }
+}
+
+TEST_CASE("Decimation/Color", "[Decimation]") {
+    Buffer buf = createGrid(33, 33, [](float u, float v) { return vec2{ u, v }; });
+    // A blend ramp that is not linear has to be kept
+    for (CorrectionMeshVertex& v : buf.vertices) {
+        const float f = (v.x + 1.f) / 2.f;
+        v.r = f * f;
+    }
+    const Buffer original = buf;
+    decimateMesh(buf, 1.f, Resolution);
+    CHECK(buf.vertices.size() > 9);
+    CHECK(buf.vertices.size() < original.vertices.size());
+}
+
+TEST_CASE("Decimation/Not a grid", "[Decimation]") {
+    Buffer buf = createGrid(9, 9, [](float u, float v) { return vec2{ u, v }; });
+    buf.vertices.push_back(CorrectionMeshVertex());
+    const size_t nVertices = buf.vertices.size();
+    buf.indices = { 0, 1, static_cast<unsigned int>(nVertices - 1) };
+    CHECK(decimateMesh(buf, 1.f, Resolution) == 0);
+    CHECK(buf.vertices.size() == nVertices);
+
+    buf.grids.clear();
+    CHECK(decimateMesh(buf, 1.f, Resolution) == 0);
+    CHECK(buf.vertices.size() == nVertices);
+}
+
+TEST_CASE("Decimation/Unused vertices", "[Decimation]") {
+    // Vertices that are not part of a grid and not used by any triangle are removed
+    Buffer buf = createGrid(9, 9, [](float u, float v) { return vec2{ u, v }; });
+    buf.vertices.resize(2 * buf.vertices.size());
+    buf.indices = { 0, 1, 9 };
+    const size_t nRemoved = decimateMesh(buf, 1.f, Resolution);
+    CHECK(nRemoved == 2 * 81 - buf.vertices.size());
+    CHECK(buf.vertices.size() <= 9);
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/image.h>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    struct TestDirectory {
+        TestDirectory() {
+            path = std::filesystem::temp_directory_path() / "sgct-test-image";
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TestDirectory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        std::string file(const std::string& name) const {
+            return (path / name).string();
+        }
+
+        std::filesystem::path path;
+    };
+
+    // Every channel and every byte of a value gets a different pattern, so swapped
+    // channels, swapped bytes, or misplaced rows all show up as a difference
+    void fillTestImage(Image& image) {
+        const size_t nValues =
+            static_cast<size_t>(image.size().x) * image.size().y * image.channels();
+        unsigned char* data = image.data();
+        unsigned int seed = 1;
+        for (size_t i = 0; i < nValues * image.bytesPerChannel(); ++i) {
+            seed = seed * 1103515245 + 12345;
+            // Alternate between smooth areas that compress well and noise
+            const size_t row = i / (static_cast<size_t>(image.size().x) * 16);
+            data[i] = row % 2 == 0 ?
+                static_cast<unsigned char>(i * 7 + row) :
+                static_cast<unsigned char>(seed >> 16);
+        }
+    }
+
+    Image createImage(ivec2 size, int channels, int bytesPerChannel) {
+        Image image;
+        image.setSize(size);
+        image.setChannels(channels);
+        image.setBytesPerChannel(bytesPerChannel);
+        image.allocateOrResizeData();
+        fillTestImage(image);
+        return image;
+    }
+} // namespace
+
+TEST_CASE("Image/Parallel PNG 8 bit", "[Image]") {
+    TestDirectory dir;
+
+    // Large enough to be written in several strips, with a last strip that is shorter.
+    // Smaller images are written by libPNG instead
+    for (int channels : { 1, 2, 3, 4 }) {
+        const ivec2 size = ivec2{ 1031, 1117 };
+        Image image = createImage(size, channels, 1);
+        const std::string path = dir.file("8bit" + std::to_string(channels) + ".png");
+        image.save(path);
+
+        Image loaded;
+        loaded.load(path);
+        REQUIRE(loaded.size().x == size.x);
+        REQUIRE(loaded.size().y == size.y);
+        REQUIRE(loaded.channels() == channels);
+        REQUIRE(loaded.bytesPerChannel() == 1);
+
+        const size_t nBytes = static_cast<size_t>(size.x) * size.y * channels;
+        CHECK(std::equal(image.data(), image.data() + nBytes, loaded.data()));
+    }
+}
+
+TEST_CASE("Image/Parallel PNG 16 bit", "[Image]") {
+    TestDirectory dir;
+
+    for (int channels : { 1, 3, 4 }) {
+        const ivec2 size = ivec2{ 1031, 613 };
+        Image image = createImage(size, channels, 2);
+        const std::string path = dir.file("16bit" + std::to_string(channels) + ".png");
+        image.save(path);
+
+        // 16 bit images are reduced to their most significant byte when they are loaded
+        Image loaded;
+        loaded.load(path);
+        REQUIRE(loaded.size().x == size.x);
+        REQUIRE(loaded.size().y == size.y);
+        REQUIRE(loaded.channels() == channels);
+        REQUIRE(loaded.bytesPerChannel() == 1);
+
+        const size_t nValues = static_cast<size_t>(size.x) * size.y * channels;
+        std::vector<unsigned char> expected(nValues);
+        for (size_t i = 0; i < nValues; ++i) {
+            // The values are stored in little-endian order in memory
+            expected[i] = image.data()[i * 2 + 1];
+        }
+        CHECK(std::equal(expected.begin(), expected.end(), loaded.data()));
+    }
+}
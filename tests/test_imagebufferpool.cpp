@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/imagebufferpool.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace sgct;
+
+TEST_CASE("ImageBufferPool/Alignment", "[ImageBufferPool]") {
+    ImageBufferPool& pool = ImageBufferPool::instance();
+
+    for (size_t size : { size_t(1), size_t(1000), size_t(100000), size_t(5000000) }) {
+        unsigned char* buffer = pool.acquire(size);
+        REQUIRE(buffer != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(buffer) % 64 == 0);
+        buffer[0] = 1;
+        buffer[size - 1] = 2;
+        pool.release(buffer);
+    }
+    pool.release(nullptr);
+
+    ImageBufferPool::destroy();
+}
+
+TEST_CASE("ImageBufferPool/Reuse", "[ImageBufferPool]") {
+    ImageBufferPool& pool = ImageBufferPool::instance();
+
+    // Two requests of slightly different size fall into the same bucket
+    unsigned char* first = pool.acquire(1920 * 1080 * 4);
+    pool.release(first);
+    unsigned char* second = pool.acquire(1920 * 1080 * 4 - 100);
+    CHECK(second == first);
+    pool.release(second);
+
+    const ImageBufferPool::Statistics stats = pool.statistics();
+    CHECK(stats.nAcquired == 2);
+    CHECK(stats.nReused == 1);
+    CHECK(stats.bytesInUse == 0);
+    CHECK(stats.maxBytesInUse >= 1920 * 1080 * 4);
+    CHECK(stats.bytesCached >= 1920 * 1080 * 4);
+
+    pool.trim();
+    CHECK(pool.statistics().bytesCached == 0);
+
+    ImageBufferPool::destroy();
+}
+
+TEST_CASE("ImageBufferPool/Resize", "[ImageBufferPool]") {
+    ImageBufferPool& pool = ImageBufferPool::instance();
+
+    unsigned char* buffer = pool.acquire(100000);
+    for (size_t i = 0; i < 100000; ++i) {
+        buffer[i] = static_cast<unsigned char>(i % 251);
+    }
+
+    // Shrinking keeps the buffer
+    CHECK(pool.resize(buffer, 50000) == buffer);
+
+    buffer = pool.resize(buffer, 3000000);
+    bool isEqual = true;
+    for (size_t i = 0; i < 100000; ++i) {
+        isEqual &= (buffer[i] == static_cast<unsigned char>(i % 251));
+    }
+    CHECK(isEqual);
+    pool.release(buffer);
+
+    CHECK(pool.statistics().bytesInUse == 0);
+
+    ImageBufferPool::destroy();
+}
+
+TEST_CASE("ImageBufferPool/Concurrent creation", "[ImageBufferPool]") {
+    ImageBufferPool::destroy();
+
+    // The first requests come from several threads at once, which must all end up with
+    // the same instance
+    std::vector<ImageBufferPool*> pools(8, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < pools.size(); ++i) {
+        threads.emplace_back([&pools, i]() {
+            ImageBufferPool& pool = ImageBufferPool::instance();
+            pool.release(pool.acquire(100000));
+            pools[i] = &pool;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (ImageBufferPool* pool : pools) {
+        CHECK(pool == &ImageBufferPool::instance());
+    }
+    CHECK(ImageBufferPool::instance().statistics().nAcquired == pools.size());
+
+    ImageBufferPool::destroy();
+}
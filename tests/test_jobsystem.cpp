@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/jobsystem.h>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+TEST_CASE("JobSystem: Submit and wait", "[jobsystem]") {
+    using namespace sgct;
+
+    std::atomic<int> counter = 0;
+    JobSystem::Handle handle = JobSystem::instance().submit([&counter]() { counter++; });
+    for (int i = 0; i < 99; ++i) {
+        JobSystem::instance().submit([&counter]() { counter++; }, handle);
+    }
+    JobSystem::instance().wait(handle);
+    CHECK(counter == 100);
+    CHECK(handle->load() == 0);
+}
+
+TEST_CASE("JobSystem: Nested jobs", "[jobsystem]") {
+    using namespace sgct;
+
+    std::atomic<int> counter = 0;
+    JobSystem::Handle handle = JobSystem::instance().submit([&counter]() {
+        JobSystem::Handle inner = JobSystem::instance().submit([&counter]() {
+            counter++;
+        });
+        JobSystem::instance().wait(inner);
+        counter++;
+    });
+    JobSystem::instance().wait(handle);
+    CHECK(counter == 2);
+}
+
+TEST_CASE("JobSystem: Parallel for", "[jobsystem]") {
+    using namespace sgct;
+
+    std::vector<int> values(1000, 0);
+    JobSystem::instance().parallelFor(
+        0,
+        values.size(),
+        [&values](size_t i) { values[i] = static_cast<int>(i); }
+    );
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(values == expected);
+
+    // Empty ranges and grain sizes larger than the range
+    JobSystem::instance().parallelFor(5, 5, [](size_t) { FAIL(); });
+    std::atomic<int> counter = 0;
+    JobSystem::instance().parallelFor(10, 13, [&counter](size_t) { counter++; }, 64);
+    CHECK(counter == 3);
+
+    JobSystem::destroy();
+}
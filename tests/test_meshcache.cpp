@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/correction/meshcache.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace sgct;
+using namespace sgct::correction;
+
+namespace {
+    struct TestDirectory {
+        TestDirectory() {
+            path = std::filesystem::temp_directory_path() / "sgct-test-meshcache";
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TestDirectory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        std::string file(const std::string& name) const {
+            return (path / name).string();
+        }
+
+        std::filesystem::path path;
+    };
+
+    void writeFile(const std::string& path, const std::string& contents) {
+        std::ofstream file(path, std::ios::binary);
+        file << contents;
+    }
+
+    Buffer testBuffer() {
+        Buffer buf;
+        buf.geometryType = 0x0005;
+        buf.vertices = {
+            { -1.f, -1.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+            { 1.f, -1.f, 1.f, 0.f, 0.5f, 0.5f, 0.5f, 1.f },
+            { 1.f, 1.f, 1.f, 1.f, 0.25f, 0.25f, 0.25f, 1.f }
+        };
+        buf.indices = { 0, 1, 2 };
+        return buf;
+    }
+
+    MeshCacheKey testKey(const std::string& path) {
+        MeshCacheKey key;
+        key.path = path;
+        key.position = vec2{ 0.25f, 0.f };
+        key.size = vec2{ 0.5f, 1.f };
+        key.aspectRatio = 16.f / 9.f;
+        return key;
+    }
+} // namespace
+
+TEST_CASE("MeshCache/Roundtrip", "[MeshCache]") {
+    TestDirectory dir;
+    const std::string mesh = dir.file("mesh.ol");
+    writeFile(mesh, "mesh contents");
+    const MeshCacheKey key = testKey(mesh);
+    const std::string cache = dir.file("cache");
+
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    const Buffer buf = testBuffer();
+    writeMeshCache(cache, key, buf);
+    const std::optional<Buffer> res = readMeshCache(cache, key);
+    REQUIRE(res.has_value());
+    CHECK(res->geometryType == buf.geometryType);
+    REQUIRE(res->vertices.size() == buf.vertices.size());
+    for (size_t i = 0; i < buf.vertices.size(); ++i) {
+        CHECK(res->vertices[i].x == buf.vertices[i].x);
+        CHECK(res->vertices[i].y == buf.vertices[i].y);
+        CHECK(res->vertices[i].s == buf.vertices[i].s);
+        CHECK(res->vertices[i].t == buf.vertices[i].t);
+        CHECK(res->vertices[i].r == buf.vertices[i].r);
+        CHECK(res->vertices[i].a == buf.vertices[i].a);
+    }
+    CHECK(res->indices == buf.indices);
+    CHECK_FALSE(res->viewSetup.has_value());
+}
+
+TEST_CASE("MeshCache/ViewSetup", "[MeshCache]") {
+    TestDirectory dir;
+    const std::string mesh = dir.file("mesh.sgc");
+    writeFile(mesh, "mesh contents");
+    const MeshCacheKey key = testKey(mesh);
+    const std::string cache = dir.file("cache");
+
+    Buffer buf = testBuffer();
+    ViewSetup view;
+    ViewSetup::FieldOfView fov;
+    fov.up = 30.f;
+    fov.down = -20.f;
+    fov.left = -40.f;
+    fov.right = 45.f;
+    fov.orientation = quat{ 0.f, 0.707f, 0.f, 0.707f };
+    view.fieldOfView = fov;
+    view.projectionPlaneOffset = vec3{ 1.f, 2.f, 3.f };
+    buf.viewSetup = view;
+    writeMeshCache(cache, key, buf);
+
+    const std::optional<Buffer> res = readMeshCache(cache, key);
+    REQUIRE(res.has_value());
+    REQUIRE(res->viewSetup.has_value());
+    CHECK_FALSE(res->viewSetup->userPosition.has_value());
+    REQUIRE(res->viewSetup->fieldOfView.has_value());
+    CHECK(res->viewSetup->fieldOfView->up == 30.f);
+    CHECK(res->viewSetup->fieldOfView->down == -20.f);
+    CHECK(res->viewSetup->fieldOfView->left == -40.f);
+    CHECK(res->viewSetup->fieldOfView->right == 45.f);
+    CHECK(res->viewSetup->fieldOfView->orientation.y == 0.707f);
+    CHECK(res->viewSetup->fieldOfView->orientation.w == 0.707f);
+    REQUIRE(res->viewSetup->projectionPlaneOffset.has_value());
+    CHECK(res->viewSetup->projectionPlaneOffset->x == 1.f);
+    CHECK(res->viewSetup->projectionPlaneOffset->y == 2.f);
+    CHECK(res->viewSetup->projectionPlaneOffset->z == 3.f);
+}
+
+TEST_CASE("MeshCache/DifferentViewport", "[MeshCache]") {
+    TestDirectory dir;
+    const std::string mesh = dir.file("mesh.obj");
+    writeFile(mesh, "mesh contents");
+    const std::string cache = dir.file("cache");
+
+    writeMeshCache(cache, testKey(mesh), testBuffer());
+
+    MeshCacheKey key = testKey(mesh);
+    key.position = vec2{ 0.5f, 0.f };
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    key = testKey(mesh);
+    key.aspectRatio = 4.f / 3.f;
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    key = testKey(mesh);
+    key.maxError = 0.5f;
+    key.resolution = ivec2{ 1920, 1080 };
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    key = testKey(mesh);
+    key.useStrips = true;
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    CHECK(readMeshCache(cache, testKey(mesh)).has_value());
+}
+
+TEST_CASE("MeshCache/ChangedSource", "[MeshCache]") {
+    TestDirectory dir;
+    const std::string mesh = dir.file("mesh.csv");
+    writeFile(mesh, "mesh contents");
+    const MeshCacheKey key = testKey(mesh);
+    const std::string cache = dir.file("cache");
+    writeMeshCache(cache, key, testBuffer());
+
+    // Touching the file without changing its contents keeps the entry valid
+    std::filesystem::last_write_time(
+        mesh,
+        std::filesystem::last_write_time(mesh) + std::chrono::hours(1)
+    );
+    CHECK(readMeshCache(cache, key).has_value());
+
+    writeFile(mesh, "other contents");
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+
+    std::filesystem::remove(mesh);
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+}
+
+TEST_CASE("MeshCache/Corrupt", "[MeshCache]") {
+    TestDirectory dir;
+    const std::string mesh = dir.file("mesh.simcad");
+    writeFile(mesh, "mesh contents");
+    const MeshCacheKey key = testKey(mesh);
+    const std::string cache = dir.file("cache");
+    writeMeshCache(cache, key, testBuffer());
+
+    // Truncating the entry invalidates it
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(cache))
+    {
+        std::filesystem::resize_file(e.path(), std::filesystem::file_size(e.path()) - 1);
+    }
+    CHECK_FALSE(readMeshCache(cache, key).has_value());
+}
+
+TEST_CASE("MeshCache/Hash", "[MeshCache]") {
+    // Reference values of the 64-bit FNV-1a hash
+    CHECK(hashMeshData(nullptr, 0) == 0xcbf29ce484222325ull);
+    const unsigned char a[] = { 'a' };
+    CHECK(hashMeshData(a, 1) == 0xaf63dc4c8601ec8cull);
+}
@@ -0,0 +1,171 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/correction/optimization.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace sgct;
+using namespace sgct::correction;
+
+namespace {
+    constexpr const unsigned int Triangles = 0x0004;
+    constexpr const unsigned int TriangleStrip = 0x0005;
+
+    Buffer createGrid(unsigned int nCols, unsigned int nRows) {
+        Buffer buf;
+        for (unsigned int r = 0; r < nRows; ++r) {
+            for (unsigned int c = 0; c < nCols; ++c) {
+                CorrectionMeshVertex v;
+                v.x = static_cast<float>(c);
+                v.y = static_cast<float>(r);
+                buf.vertices.push_back(v);
+            }
+        }
+        buf.grids = { Grid{ 0, nCols, nRows } };
+        return buf;
+    }
+
+    // Two counter-clockwise triangles per cell, row by row
+    Buffer createGridTriangles(unsigned int nCols, unsigned int nRows) {
+        Buffer buf = createGrid(nCols, nRows);
+        for (unsigned int r = 0; r < nRows - 1; ++r) {
+            for (unsigned int c = 0; c < nCols - 1; ++c) {
+                const unsigned int i = r * nCols + c;
+                buf.indices.insert(buf.indices.end(), { i, i + 1, i + nCols + 1 });
+                buf.indices.insert(buf.indices.end(), { i, i + nCols + 1, i + nCols });
+            }
+        }
+        buf.geometryType = Triangles;
+        return buf;
+    }
+
+    // One strip per row that is separated by restart indices
+    Buffer createGridStrips(unsigned int nCols, unsigned int nRows) {
+        Buffer buf = createGrid(nCols, nRows);
+        for (unsigned int r = 0; r < nRows - 1; ++r) {
+            if (r > 0) {
+                buf.indices.push_back(PrimitiveRestartIndex);
+            }
+            for (unsigned int c = 0; c < nCols; ++c) {
+                buf.indices.push_back((r + 1) * nCols + c);
+                buf.indices.push_back(r * nCols + c);
+            }
+        }
+        buf.geometryType = TriangleStrip;
+        return buf;
+    }
+
+    // Returns the positions of all triangles, with each triangle rotated so that its
+    // winding is kept but the order of the triangles and vertices does not matter
+    std::vector<std::array<float, 6>> triangles(const Buffer& buffer) {
+        std::vector<unsigned int> list;
+        const std::vector<unsigned int>& idx = buffer.indices;
+        if (buffer.geometryType == Triangles) {
+            list = idx;
+        }
+        else {
+            size_t start = 0;
+            for (size_t i = 0; i < idx.size(); ++i) {
+                if (idx[i] == PrimitiveRestartIndex) {
+                    start = i + 1;
+                }
+                else if (i >= start + 2) {
+                    const bool isOdd = (i - start) % 2 == 1;
+                    list.push_back(isOdd ? idx[i - 1] : idx[i - 2]);
+                    list.push_back(isOdd ? idx[i - 2] : idx[i - 1]);
+                    list.push_back(idx[i]);
+                }
+            }
+        }
+
+        std::vector<std::array<float, 6>> res;
+        for (size_t i = 0; i < list.size(); i += 3) {
+            std::array<const CorrectionMeshVertex*, 3> v = {
+                &buffer.vertices[list[i]],
+                &buffer.vertices[list[i + 1]],
+                &buffer.vertices[list[i + 2]]
+            };
+            auto less = [](const CorrectionMeshVertex* a, const CorrectionMeshVertex* b) {
+                return a->x < b->x || (a->x == b->x && a->y < b->y);
+            };
+            std::rotate(v.begin(), std::min_element(v.begin(), v.end(), less), v.end());
+            res.push_back({ v[0]->x, v[0]->y, v[1]->x, v[1]->y, v[2]->x, v[2]->y });
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+} // namespace
+
+TEST_CASE("MeshOptimization/Triangles", "[MeshOptimization]") {
+    const Buffer original = createGridTriangles(200, 100);
+    Buffer buf = original;
+    optimizeMesh(buf, false);
+
+    CHECK(buf.geometryType == Triangles);
+    CHECK(buf.grids.empty());
+    CHECK(buf.vertices.size() == original.vertices.size());
+    CHECK(triangles(buf) == triangles(original));
+
+    // Rows that are wider than the cache load every vertex twice
+    CHECK(averageCacheMissRatio(original) == Approx(1.f).margin(0.05f));
+    CHECK(averageCacheMissRatio(buf) < 0.8f);
+
+    // The vertices are stored in the order in which they are used
+    unsigned int next = 0;
+    for (unsigned int i : buf.indices) {
+        REQUIRE(i <= next);
+        if (i == next) {
+            next++;
+        }
+    }
+}
+
+TEST_CASE("MeshOptimization/Strips", "[MeshOptimization]") {
+    const Buffer original = createGridStrips(65, 33);
+    CHECK(triangles(original).size() == 2 * 64 * 32);
+
+    Buffer list = original;
+    optimizeMesh(list, false);
+    CHECK(list.geometryType == Triangles);
+    CHECK(triangles(list) == triangles(original));
+
+    Buffer strips = original;
+    optimizeMesh(strips, true);
+    CHECK(strips.geometryType == TriangleStrip);
+    CHECK(strips.indices.size() < list.indices.size());
+    CHECK(triangles(strips) == triangles(original));
+    CHECK(averageCacheMissRatio(strips) < averageCacheMissRatio(original));
+}
+
+TEST_CASE("MeshOptimization/Cleanup", "[MeshOptimization]") {
+    Buffer buf = createGrid(3, 3);
+    buf.geometryType = Triangles;
+    // A degenerate triangle, an invalid index, and vertices that are never used
+    buf.indices = { 0, 1, 4, 4, 4, 3, 1, 2, 9 };
+
+    optimizeMesh(buf, true);
+    CHECK(buf.geometryType == Triangles);
+    REQUIRE(buf.vertices.size() == 3);
+    CHECK(buf.vertices[buf.indices[0]].x == 0.f);
+    CHECK(buf.vertices[buf.indices[1]].x == 1.f);
+    CHECK(buf.vertices[buf.indices[2]].y == 1.f);
+}
+
+TEST_CASE("MeshOptimization/Unsupported", "[MeshOptimization]") {
+    Buffer buf = createGrid(3, 3);
+    buf.geometryType = 0x0001; // = GL_LINES
+    buf.indices = { 0, 8, 2, 6 };
+    optimizeMesh(buf, true);
+    CHECK(buf.indices == std::vector<unsigned int>{ 0, 8, 2, 6 });
+    CHECK(buf.vertices.size() == 9);
+    CHECK(buf.grids.size() == 1);
+}
@@ -0,0 +1,273 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/correction/domeprojection.h>
+#include <sgct/correction/obj.h>
+#include <sgct/correction/paulbourke.h>
+#include <sgct/correction/pfm.h>
+#include <sgct/correction/tokenizer.h>
+#include <sgct/error.h>
+#include <sgct/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace sgct;
+using namespace sgct::correction;
+
+namespace {
+    struct TestFile {
+        explicit TestFile(const std::string& name, const std::string& contents) {
+            path = (std::filesystem::temp_directory_path() / name).string();
+            std::ofstream file(path, std::ios::binary);
+            file << contents;
+        }
+
+        ~TestFile() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+
+        std::string path;
+    };
+} // namespace
+
+TEST_CASE("Tokenizer/Lines", "[MeshParsing]") {
+    const std::string data = "first line\r\n\nthird\tline  \nlast";
+    Tokenizer tokenizer(data.data(), data.size());
+    CHECK(tokenizer.countLines() == 4);
+
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.lineNumber() == 1);
+    CHECK(tokenizer.nextToken() == "first");
+    CHECK(tokenizer.rest() == "line");
+    CHECK(tokenizer.nextToken() == "line");
+    CHECK(tokenizer.nextToken().empty());
+
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.nextToken().empty());
+
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.nextToken() == "third");
+    CHECK(tokenizer.nextToken() == "line");
+    CHECK(tokenizer.nextToken().empty());
+
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.lineNumber() == 4);
+    CHECK(tokenizer.rest() == "last");
+
+    CHECK_FALSE(tokenizer.nextLine());
+}
+
+TEST_CASE("Tokenizer/Separators", "[MeshParsing]") {
+    const std::string data = "0.5;-1.25; 3;4\n";
+    Tokenizer tokenizer(data.data(), data.size());
+    CHECK(tokenizer.countLines() == 1);
+    REQUIRE(tokenizer.nextLine());
+
+    float f = 0.f;
+    REQUIRE(tokenizer.nextNumber(f, ";"));
+    CHECK(f == 0.5f);
+    REQUIRE(tokenizer.nextNumber(f, ";"));
+    CHECK(f == -1.25f);
+    unsigned int u = 0;
+    REQUIRE(tokenizer.nextNumber(u, ";"));
+    CHECK(u == 3);
+    int i = 0;
+    REQUIRE(tokenizer.nextNumber(i, ";"));
+    CHECK(i == 4);
+    CHECK_FALSE(tokenizer.nextNumber(i, ";"));
+}
+
+TEST_CASE("Tokenizer/Numbers", "[MeshParsing]") {
+    float f = 0.f;
+    CHECK(parseNumber("1e-3", f));
+    CHECK(f == 1e-3f);
+    CHECK(parseNumber("+2.5", f));
+    CHECK(f == 2.5f);
+    CHECK(parseNumber("-0", f));
+    CHECK_FALSE(parseNumber("", f));
+    CHECK_FALSE(parseNumber("+", f));
+    CHECK_FALSE(parseNumber("1.5x", f));
+    CHECK_FALSE(parseNumber("abc", f));
+
+    int i = 0;
+    CHECK(parseNumber("-42", i));
+    CHECK(i == -42);
+    CHECK_FALSE(parseNumber("4.2", i));
+    CHECK_FALSE(parseNumber("99999999999", i));
+
+    unsigned int u = 0;
+    CHECK(parseNumber("42", u));
+    CHECK(u == 42);
+    CHECK_FALSE(parseNumber("-1", u));
+}
+
+TEST_CASE("MeshParsing/OBJ", "[MeshParsing]") {
+    TestFile file(
+        "sgct-test-mesh.obj",
+        "# comment\n"
+        "v -1 -1 0\r\n"
+        "v 1 -1 0\n"
+        "v 1 1 0\n"
+        "vt 0 0\n"
+        "vt 1 0\n"
+        "vt 1 1\n"
+        "vn 0 0 1\n"
+        "f 1/1/1 2/2/1 3/3/1\n"
+    );
+    const Buffer buf = generateOBJMesh(file.path);
+    REQUIRE(buf.vertices.size() == 3);
+    CHECK(buf.vertices[1].x == 1.f);
+    CHECK(buf.vertices[1].y == -1.f);
+    CHECK(buf.vertices[1].s == 1.f);
+    CHECK(buf.vertices[1].t == 0.f);
+    CHECK(buf.vertices[2].a == 1.f);
+    CHECK(buf.indices == std::vector<unsigned int>{ 0, 1, 2 });
+}
+
+TEST_CASE("MeshParsing/OBJ Errors", "[MeshParsing]") {
+    {
+        TestFile file("sgct-test-mesh.obj", "v 0 0 0\nv 1 1 0\nvt 0 0\n");
+        CHECK_THROWS_AS(generateOBJMesh(file.path), Error);
+    }
+    {
+        TestFile file("sgct-test-mesh.obj", "v 0 0 0\nvt 0 0\nf 1 1 2\n");
+        CHECK_THROWS_AS(generateOBJMesh(file.path), Error);
+    }
+    {
+        TestFile file("sgct-test-mesh.obj", "v 0 zero 0\nvt 0 0\n");
+        CHECK_THROWS_AS(generateOBJMesh(file.path), Error);
+    }
+    CHECK_THROWS_AS(generateOBJMesh("sgct-test-does-not-exist.obj"), Error);
+}
+
+TEST_CASE("MeshParsing/DomeProjection", "[MeshParsing]") {
+    TestFile file(
+        "sgct-test-mesh.csv",
+        "x;y;u;v;column;row\n"
+        "0;0;0;0;0;0\n"
+        "1;0;1;0;1;0\n"
+        "0;1;0;1;0;1\n"
+        "1;1;1;1;1;1\n"
+    );
+    const Buffer buf = generateDomeProjectionMesh(file.path, vec2{ 0.f, 0.f },
+        vec2{ 1.f, 1.f });
+    REQUIRE(buf.vertices.size() == 4);
+    CHECK(buf.vertices[1].x == 1.f);
+    CHECK(buf.vertices[1].y == 1.f);
+    CHECK(buf.vertices[1].s == 1.f);
+    CHECK(buf.vertices[1].t == 1.f);
+    CHECK(buf.vertices[2].y == -1.f);
+}
+
+TEST_CASE("MeshParsing/PaulBourke", "[MeshParsing]") {
+    TestFile file(
+        "sgct-test-mesh.data",
+        "2\n"
+        "2 2\n"
+        "-1 -1 0 0 1\n"
+        "1 -1 1 0 0.5\n"
+        "-1 1 0 1 1\n"
+        "1 1 1 1 1\n"
+    );
+    const Buffer buf = generatePaulBourkeMesh(file.path, vec2{ 0.f, 0.f },
+        vec2{ 1.f, 1.f }, 1.f);
+    REQUIRE(buf.vertices.size() == 4);
+    CHECK(buf.vertices[1].x == 1.f);
+    CHECK(buf.vertices[1].r == 0.5f);
+    CHECK(buf.indices == std::vector<unsigned int>{ 0, 1, 3, 0, 3, 2 });
+}
+
+TEST_CASE("MeshParsing/PFM", "[MeshParsing]") {
+    // 2 eyes side by side with 2x2 correction values each
+    const uint32_t one = 1;
+    const bool isLittleEndian = *reinterpret_cast<const unsigned char*>(&one) == 1;
+    for (bool littleEndian : { true, false }) {
+        std::string contents = littleEndian ? "PF\n4 2\n-1.0\n" : "PF\n4 2\n1.0\n";
+        for (int i = 0; i < 8; ++i) {
+            const float values[3] = { (i % 4) * 0.25f, (i / 4) * 0.5f, 0.f };
+            for (float value : values) {
+                char bytes[sizeof(float)];
+                std::memcpy(bytes, &value, sizeof(float));
+                if (littleEndian != isLittleEndian) {
+                    std::reverse(bytes, bytes + sizeof(float));
+                }
+                contents.append(bytes, sizeof(float));
+            }
+        }
+        TestFile file("sgct-test-mesh.pfm", contents);
+
+        const Buffer buf = generatePerEyeMeshFromPFMImage(file.path, vec2{ 0.f, 0.f },
+            vec2{ 1.f, 1.f });
+        REQUIRE(buf.vertices.size() == 8);
+        // x = 0.25 and y = 0.5 are converted into the [-1, 1] range
+        CHECK(buf.vertices[3].x == -0.5f);
+        CHECK(buf.vertices[3].y == 0.f);
+        // The second eye starts at the second half of every row
+        CHECK(buf.vertices[4].x == 0.f);
+        CHECK(buf.vertices[4].y == -1.f);
+        // Only the vertices of the first eye are used by the triangles
+        REQUIRE(buf.grids.size() == 1);
+        CHECK(buf.grids[0].nCols * buf.grids[0].nRows == 4);
+        for (unsigned int i : buf.indices) {
+            CHECK(i < 4);
+        }
+    }
+
+    TestFile truncated("sgct-test-mesh.pfm", "PF\n4 2\n-1.0\n0000");
+    CHECK_THROWS_AS(generatePerEyeMeshFromPFMImage(truncated.path, vec2{ 0.f, 0.f },
+        vec2{ 1.f, 1.f }), Error);
+}
+
+TEST_CASE("MeshParsing/OBJ Benchmark", "[.][benchmark]") {
+    // Regular grid with about a million vertices, as produced by calibration software
+    constexpr const int N = 1000;
+    std::string contents;
+    contents.reserve(static_cast<size_t>(N) * N * 64);
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            contents += fmt::format(
+                "v {:.6f} {:.6f} 0\n", 2.f * x / (N - 1) - 1.f, 2.f * y / (N - 1) - 1.f
+            );
+        }
+    }
+    for (int y = 0; y < N; ++y) {
+        for (int x = 0; x < N; ++x) {
+            contents += fmt::format(
+                "vt {:.6f} {:.6f}\n", float(x) / (N - 1), float(y) / (N - 1)
+            );
+        }
+    }
+    for (int y = 0; y < N - 1; ++y) {
+        for (int x = 0; x < N - 1; ++x) {
+            const int i0 = y * N + x + 1;
+            const int i1 = i0 + 1;
+            const int i2 = i0 + N + 1;
+            const int i3 = i0 + N;
+            contents += fmt::format("f {} {} {}\nf {} {} {}\n", i0, i1, i2, i0, i2, i3);
+        }
+    }
+    TestFile file("sgct-test-benchmark.obj", contents);
+
+    const auto begin = std::chrono::steady_clock::now();
+    const Buffer buf = generateOBJMesh(file.path);
+    const auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(buf.vertices.size() == static_cast<size_t>(N) * N);
+    REQUIRE(buf.indices.size() == static_cast<size_t>(N - 1) * (N - 1) * 6);
+    const double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+    WARN(fmt::format(
+        "Parsed {} MB OBJ mesh with {} vertices in {:.1f} ms",
+        contents.size() / (1024 * 1024), buf.vertices.size(), ms
+    ));
+}
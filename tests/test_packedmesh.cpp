@@ -0,0 +1,125 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/correction/packedmesh.h>
+#include <cstdint>
+#include <cstring>
+
+using namespace sgct;
+using namespace sgct::correction;
+
+namespace {
+    CorrectionMeshVertex createVertex(float x, float y, float s, float t, float r) {
+        CorrectionMeshVertex v;
+        v.x = x;
+        v.y = y;
+        v.s = s;
+        v.t = t;
+        v.r = r;
+        v.g = 1.f;
+        v.b = 1.f;
+        v.a = 1.f;
+        return v;
+    }
+
+    template <typename T>
+    T read(const std::vector<unsigned char>& data, size_t offset) {
+        T res;
+        std::memcpy(&res, data.data() + offset, sizeof(T));
+        return res;
+    }
+} // namespace
+
+TEST_CASE("PackedMesh/Normalized", "[PackedMesh]") {
+    Buffer buf;
+    buf.vertices = {
+        createVertex(-1.f, -1.f, 0.f, 0.f, 1.f),
+        createVertex(1.f, -1.f, 1.f, 0.f, 1.f),
+        createVertex(0.f, 1.f, 0.5f, 1.f, 1.f)
+    };
+    buf.indices = { 0, 1, 2 };
+
+    const PackedMesh mesh = packMesh(buf);
+    CHECK(mesh.positionFormat == PackedMesh::PositionFormat::Normalized16);
+    CHECK(mesh.colorFormat == PackedMesh::ColorFormat::Constant);
+    CHECK(mesh.constantColor.x == 1.f);
+    CHECK(mesh.vertexSize == 8);
+    CHECK(mesh.texCoordOffset == 4);
+    REQUIRE(mesh.vertices.size() == 3 * 8);
+    CHECK(read<int16_t>(mesh.vertices, 0) == -32767);
+    CHECK(read<int16_t>(mesh.vertices, 8) == 32767);
+    CHECK(read<uint16_t>(mesh.vertices, 8 + 4) == 65535);
+    CHECK(read<uint16_t>(mesh.vertices, 16 + 4) == 32768);
+    CHECK(read<uint16_t>(mesh.vertices, 16 + 6) == 65535);
+
+    CHECK(mesh.has16BitIndices);
+    REQUIRE(mesh.indices.size() == 3 * sizeof(uint16_t));
+    CHECK(read<uint16_t>(mesh.indices, 4) == 2);
+}
+
+TEST_CASE("PackedMesh/Colors", "[PackedMesh]") {
+    Buffer buf;
+    buf.vertices = {
+        createVertex(0.f, 0.f, 0.f, 0.f, 0.f),
+        createVertex(0.f, 0.f, 0.f, 0.f, 1.f)
+    };
+    const PackedMesh mesh = packMesh(buf);
+    CHECK(mesh.colorFormat == PackedMesh::ColorFormat::Normalized8);
+    CHECK(mesh.vertexSize == 12);
+    CHECK(mesh.colorOffset == 8);
+    CHECK(read<uint8_t>(mesh.vertices, 8) == 0);
+    CHECK(read<uint8_t>(mesh.vertices, 12 + 8) == 255);
+
+    buf.vertices[1].r = 2.f;
+    const PackedMesh overbright = packMesh(buf);
+    CHECK(overbright.colorFormat == PackedMesh::ColorFormat::Float);
+    CHECK(overbright.vertexSize == 8 + 16);
+    CHECK(read<float>(overbright.vertices, 24 + 8) == 2.f);
+}
+
+TEST_CASE("PackedMesh/Fallback", "[PackedMesh]") {
+    Buffer buf;
+    // Texture coordinates outside of [0, 1] are used for repeating textures
+    buf.vertices = {
+        createVertex(0.f, 0.f, -0.5f, 0.f, 1.f),
+        createVertex(0.f, 0.f, 1.f, 0.f, 1.f)
+    };
+    buf.indices = { 0, 1, 70000 };
+
+    const PackedMesh mesh = packMesh(buf);
+    CHECK(mesh.positionFormat == PackedMesh::PositionFormat::Float);
+    CHECK(mesh.vertexSize == 16);
+    CHECK(read<float>(mesh.vertices, 8) == -0.5f);
+    CHECK_FALSE(mesh.has16BitIndices);
+    REQUIRE(mesh.indices.size() == 3 * sizeof(unsigned int));
+    CHECK(read<unsigned int>(mesh.indices, 8) == 70000);
+}
+
+TEST_CASE("PackedMesh/PrimitiveRestart", "[PackedMesh]") {
+    Buffer buf;
+    buf.vertices.resize(6);
+    buf.indices = { 0, 1, 2, PrimitiveRestartIndex, 3, 4, 5 };
+    buf.geometryType = 0x0005; // = GL_TRIANGLE_STRIP
+
+    const PackedMesh mesh = packMesh(buf);
+    CHECK(mesh.hasPrimitiveRestart);
+    CHECK(mesh.has16BitIndices);
+    REQUIRE(mesh.indices.size() == 7 * sizeof(uint16_t));
+    CHECK(read<uint16_t>(mesh.indices, 3 * sizeof(uint16_t)) == 65535);
+    CHECK(read<uint16_t>(mesh.indices, 6 * sizeof(uint16_t)) == 5);
+
+    // A vertex with the index 65535 would be taken for a restart
+    buf.vertices.resize(65536);
+    buf.indices.back() = 65535;
+    const PackedMesh large = packMesh(buf);
+    CHECK(large.hasPrimitiveRestart);
+    CHECK_FALSE(large.has16BitIndices);
+    CHECK(read<unsigned int>(large.indices, 3 * sizeof(unsigned int)) == 0xffffffff);
+}
@@ -0,0 +1,205 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/pixelconversion.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    std::vector<unsigned char> testPixels(size_t nPixels, int channels) {
+        std::vector<unsigned char> res(nPixels * channels);
+        for (size_t i = 0; i < res.size(); ++i) {
+            res[i] = static_cast<unsigned char>(i * 7 + 3);
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("PixelConversion: Swap red and blue", "[pixelconversion]") {
+    // Sizes that are not a multiple of the vector width exercise the scalar tail
+    for (int channels : { 1, 2, 3, 4 }) {
+        for (size_t nPixels : { 0, 1, 5, 16, 17, 33, 1000 }) {
+            std::vector<unsigned char> data = testPixels(nPixels, channels);
+            std::vector<unsigned char> expected = data;
+            if (channels >= 3) {
+                for (size_t i = 0; i < nPixels; ++i) {
+                    std::swap(expected[i * channels], expected[i * channels + 2]);
+                }
+            }
+
+            sgct::swapRedBlue(data.data(), nPixels, channels);
+            CHECK(data == expected);
+        }
+    }
+}
+
+TEST_CASE("PixelConversion: Byte swap", "[pixelconversion]") {
+    for (size_t n : { 0, 1, 7, 8, 31, 100 }) {
+        std::vector<uint16_t> data(n);
+        std::vector<uint16_t> expected(n);
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = static_cast<uint16_t>(i * 0x0102 + 0x0A0B);
+            expected[i] = static_cast<uint16_t>((data[i] << 8) | (data[i] >> 8));
+        }
+
+        sgct::byteSwap16(data.data(), n);
+        CHECK(data == expected);
+    }
+}
+
+TEST_CASE("PixelConversion: Deinterleave float pixels", "[pixelconversion]") {
+    for (bool swapBytes : { false, true }) {
+        for (size_t nPixels : { 0, 1, 3, 4, 5, 17, 100 }) {
+            std::vector<float> pixels(nPixels * 3);
+            std::vector<float> expectedR(nPixels);
+            std::vector<float> expectedG(nPixels);
+            for (size_t i = 0; i < nPixels; ++i) {
+                expectedR[i] = static_cast<float>(i) * 0.5f + 1.f;
+                expectedG[i] = -static_cast<float>(i) * 0.25f;
+                pixels[i * 3] = expectedR[i];
+                pixels[i * 3 + 1] = expectedG[i];
+                pixels[i * 3 + 2] = 1000.f;
+            }
+
+            std::vector<unsigned char> data(pixels.size() * sizeof(float) + 1);
+            // Start at an odd address as the values in PFM files are not aligned
+            unsigned char* src = data.data() + 1;
+            if (!pixels.empty()) {
+                std::memcpy(src, pixels.data(), pixels.size() * sizeof(float));
+            }
+            if (swapBytes) {
+                for (size_t i = 0; i < pixels.size(); ++i) {
+                    std::reverse(src + i * 4, src + i * 4 + 4);
+                }
+            }
+
+            std::vector<float> r(nPixels);
+            std::vector<float> g(nPixels);
+            sgct::deinterleaveRG32F(r.data(), g.data(), src, nPixels, swapBytes);
+            CHECK(r == expectedR);
+            CHECK(g == expectedG);
+        }
+    }
+}
+
+TEST_CASE("PixelConversion: Half to 8 bit", "[pixelconversion]") {
+    // 0, 0.25, 0.5, 1, 2, -1, +inf, NaN, smallest normal, 0.75, smallest denormal
+    const std::vector<uint16_t> values = {
+        0x0000, 0x3400, 0x3800, 0x3C00, 0x4000, 0xBC00, 0x7C00, 0x7E00, 0x0400, 0x3A00,
+        0x0001
+    };
+    const std::vector<int> expected = { 0, 64, 128, 255, 255, 0, 255, 0, 0, 191, 0 };
+
+    std::vector<unsigned char> res(values.size());
+    sgct::halfToUnorm8(res.data(), values.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        // Vectorized and scalar code may round differently by one step
+        CHECK(std::abs(res[i] - expected[i]) <= 1);
+    }
+}
+
+TEST_CASE("PixelConversion: BGR to YUV 4:2:0 colors", "[pixelconversion]") {
+    struct Color {
+        unsigned char b, g, r;
+        int y, u, v;
+    };
+    // The limited range values of black, white and the primary colors
+    const std::vector<Color> colors = {
+        { 0, 0, 0, 16, 128, 128 },
+        { 255, 255, 255, 235, 128, 128 },
+        { 0, 0, 255, 82, 90, 240 },
+        { 0, 255, 0, 144, 54, 34 },
+        { 255, 0, 0, 41, 240, 110 }
+    };
+
+    for (const Color& c : colors) {
+        for (int channels : { 3, 4 }) {
+            constexpr const int Width = 19;
+            constexpr const int Height = 5;
+            std::vector<unsigned char> src(Width * Height * channels, 255);
+            for (size_t i = 0; i < Width * Height; ++i) {
+                src[i * channels + 0] = c.b;
+                src[i * channels + 1] = c.g;
+                src[i * channels + 2] = c.r;
+            }
+
+            std::vector<unsigned char> y(Width * Height);
+            std::vector<unsigned char> u(10 * 3);
+            std::vector<unsigned char> v(10 * 3);
+            sgct::bgrToYuv420(
+                src.data(), Width, Height, channels, y.data(), u.data(), v.data()
+            );
+            for (unsigned char val : y) {
+                CHECK(val == c.y);
+            }
+            for (unsigned char val : u) {
+                CHECK(val == c.u);
+            }
+            for (unsigned char val : v) {
+                CHECK(val == c.v);
+            }
+        }
+    }
+}
+
+TEST_CASE("PixelConversion: BGR to YUV 4:2:0 layout", "[pixelconversion]") {
+    // The bottom row of the source image is the top row of the output and odd sizes
+    // duplicate the last row and column when computing the chroma values
+    for (int channels : { 3, 4 }) {
+        for (int width : { 1, 2, 9, 16, 21, 64 }) {
+            for (int height : { 1, 2, 3, 8 }) {
+                std::vector<unsigned char> src = testPixels(width * height, channels);
+
+                const int cw = (width + 1) / 2;
+                const int ch = (height + 1) / 2;
+                std::vector<unsigned char> y(width * height);
+                std::vector<unsigned char> u(cw * ch);
+                std::vector<unsigned char> v(cw * ch);
+                sgct::bgrToYuv420(
+                    src.data(), width, height, channels, y.data(), u.data(), v.data()
+                );
+
+                auto pixel = [&](int col, int row) {
+                    const int r = height - 1 - std::min(row, height - 1);
+                    const int c = std::min(col, width - 1);
+                    return src.data() + (r * width + c) * channels;
+                };
+                auto avg = [](int a, int b) { return (a + b + 1) >> 1; };
+
+                for (int row = 0; row < height; ++row) {
+                    for (int col = 0; col < width; ++col) {
+                        const unsigned char* p = pixel(col, row);
+                        const int expected =
+                            ((25 * p[0] + 129 * p[1] + 66 * p[2] + 128) >> 8) + 16;
+                        CHECK(y[row * width + col] == expected);
+                    }
+                }
+                for (int row = 0; row < ch; ++row) {
+                    for (int col = 0; col < cw; ++col) {
+                        int c[3];
+                        for (int i = 0; i < 3; ++i) {
+                            c[i] = avg(
+                                avg(pixel(2 * col, 2 * row)[i],
+                                    pixel(2 * col, 2 * row + 1)[i]),
+                                avg(pixel(2 * col + 1, 2 * row)[i],
+                                    pixel(2 * col + 1, 2 * row + 1)[i])
+                            );
+                        }
+                        const int eu = ((112 * c[0] - 74 * c[1] - 38 * c[2] + 128) >> 8);
+                        const int ev = ((-18 * c[0] - 94 * c[1] + 112 * c[2] + 128) >> 8);
+                        CHECK(u[row * cw + col] == eu + 128);
+                        CHECK(v[row * cw + col] == ev + 128);
+                    }
+                }
+            }
+        }
+    }
+}
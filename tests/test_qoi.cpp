@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/qoi.h>
+#include <vector>
+
+namespace {
+    // An image with flat areas, gradients, and noise so that all chunk types are used
+    std::vector<unsigned char> testImage(int width, int height, int channels) {
+        std::vector<unsigned char> res(static_cast<size_t>(width) * height * channels);
+        unsigned int seed = 1;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                unsigned char* p = res.data() + (y * width + x) * channels;
+                seed = seed * 1103515245 + 12345;
+                for (int c = 0; c < channels; ++c) {
+                    if (y < height / 4) {
+                        p[c] = 42;
+                    }
+                    else if (y < height / 2) {
+                        p[c] = static_cast<unsigned char>(x + c * 3);
+                    }
+                    else if (y < 3 * height / 4) {
+                        p[c] = static_cast<unsigned char>(x * (c + 1) * 11);
+                    }
+                    else {
+                        p[c] = static_cast<unsigned char>(seed >> (8 + c * 5));
+                    }
+                }
+            }
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("QOI: Round trip", "[qoi]") {
+    for (int channels : { 3, 4 }) {
+        for (int width : { 1, 7, 64, 200 }) {
+            for (int height : { 1, 4, 33 }) {
+                std::vector<unsigned char> image = testImage(width, height, channels);
+                std::vector<unsigned char> file =
+                    sgct::encodeQOI(image.data(), width, height, channels);
+
+                std::optional<sgct::QOIInfo> info =
+                    sgct::readQOIHeader(file.data(), file.size());
+                REQUIRE(info.has_value());
+                CHECK(info->width == width);
+                CHECK(info->height == height);
+                CHECK(info->channels == channels);
+
+                std::vector<unsigned char> decoded(image.size());
+                REQUIRE(sgct::decodeQOI(file.data(), file.size(), decoded.data()));
+                CHECK(decoded == image);
+            }
+        }
+    }
+}
+
+TEST_CASE("QOI: File layout", "[qoi]") {
+    // Two BGR pixels stored bottom to top: the top pixel is red, the bottom one is blue
+    const std::vector<unsigned char> image = { 200, 0, 0, 0, 0, 200 };
+    const std::vector<unsigned char> file = sgct::encodeQOI(image.data(), 1, 2, 3);
+
+    const std::vector<unsigned char> expected = {
+        'q', 'o', 'i', 'f', 0, 0, 0, 1, 0, 0, 0, 2, 3, 0,
+        0xFE, 200, 0, 0,   // red as RGB
+        0xFE, 0, 0, 200,   // blue as RGB
+        0, 0, 0, 0, 0, 0, 0, 1
+    };
+    CHECK(file == expected);
+}
+
+TEST_CASE("QOI: Index starts transparent", "[qoi]") {
+    // The index of the specification starts out with all pixels as transparent black,
+    // so an opaque black pixel cannot be encoded as an index chunk before it was seen.
+    // BGRA pixels stored bottom to top: the top pixel is red, the bottom one is black
+    const std::vector<unsigned char> image = { 0, 0, 0, 255, 0, 0, 255, 255 };
+    const std::vector<unsigned char> file = sgct::encodeQOI(image.data(), 1, 2, 4);
+    const std::vector<unsigned char> expected = {
+        'q', 'o', 'i', 'f', 0, 0, 0, 1, 0, 0, 0, 2, 4, 0,
+        0x5A,   // red as the difference (-1, 0, 0) to the initial opaque black
+        0x7A,   // opaque black as the difference (1, 0, 0)
+        0, 0, 0, 0, 0, 0, 0, 1
+    };
+    CHECK(file == expected);
+
+    // Written by hand according to the specification: index 0 for transparent black
+    // followed by opaque red
+    const std::vector<unsigned char> spec = {
+        'q', 'o', 'i', 'f', 0, 0, 0, 1, 0, 0, 0, 2, 4, 0,
+        0x00,
+        0xFF, 255, 0, 0, 255,
+        0, 0, 0, 0, 0, 0, 0, 1
+    };
+    std::vector<unsigned char> decoded(2 * 4);
+    REQUIRE(sgct::decodeQOI(spec.data(), spec.size(), decoded.data()));
+    CHECK(decoded == std::vector<unsigned char>{ 0, 0, 255, 255, 0, 0, 0, 0 });
+}
+
+TEST_CASE("QOI: Long runs", "[qoi]") {
+    // A run is limited to 62 pixels, a uniform image needs multiple run chunks
+    std::vector<unsigned char> image(200 * 4, 0);
+    for (size_t i = 3; i < image.size(); i += 4) {
+        image[i] = 255;
+    }
+    const std::vector<unsigned char> file = sgct::encodeQOI(image.data(), 200, 1, 4);
+    // 200 pixels equal to the initial pixel = 3 runs of 62 and one run of 14
+    CHECK(file.size() == 14 + 4 + 8);
+
+    std::vector<unsigned char> decoded(image.size());
+    REQUIRE(sgct::decodeQOI(file.data(), file.size(), decoded.data()));
+    CHECK(decoded == image);
+}
+
+TEST_CASE("QOI: Invalid files", "[qoi]") {
+    std::vector<unsigned char> image = testImage(16, 16, 4);
+    std::vector<unsigned char> file = sgct::encodeQOI(image.data(), 16, 16, 4);
+    std::vector<unsigned char> decoded(image.size());
+
+    SECTION("Truncated") {
+        file.resize(file.size() / 2);
+        CHECK_FALSE(sgct::decodeQOI(file.data(), file.size(), decoded.data()));
+    }
+
+    SECTION("Wrong magic") {
+        file[0] = 'x';
+        CHECK_FALSE(sgct::readQOIHeader(file.data(), file.size()).has_value());
+        CHECK_FALSE(sgct::decodeQOI(file.data(), file.size(), decoded.data()));
+    }
+
+    SECTION("Invalid channels") {
+        file[12] = 2;
+        CHECK_FALSE(sgct::readQOIHeader(file.data(), file.size()).has_value());
+    }
+}
@@ -0,0 +1,122 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2022                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <sgct/rawcapture.h>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace sgct;
+
+namespace {
+    struct TestFile {
+        TestFile() {
+            std::filesystem::path p = std::filesystem::temp_directory_path();
+            path = (p / "sgct-test.sgctraw").string();
+        }
+
+        ~TestFile() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+
+        std::string path;
+    };
+
+    RawFrameHeader testHeader(uint64_t frameNumber, uint32_t windowId) {
+        RawFrameHeader header;
+        header.windowId = windowId;
+        header.frameNumber = frameNumber;
+        // Frames of different sizes that are not multiples of the frame alignment
+        header.width = 13 + static_cast<int32_t>(frameNumber % 7);
+        header.height = 11;
+        header.channels = 3;
+        header.bytesPerChannel = 1;
+        header.dataSize = static_cast<uint64_t>(header.width) * header.height *
+            header.channels * header.bytesPerChannel;
+        return header;
+    }
+
+    std::vector<unsigned char> testData(const RawFrameHeader& header) {
+        std::vector<unsigned char> data(header.dataSize);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<unsigned char>(
+                i + header.frameNumber * 31 + header.windowId
+            );
+        }
+        return data;
+    }
+} // namespace
+
+TEST_CASE("RawCapture/Write and read", "[RawCapture]") {
+    TestFile file;
+
+    constexpr const uint64_t nFrames = 50;
+    {
+        RawCaptureWriter writer(file.path, 1024 * 1024);
+        for (uint64_t i = 0; i < nFrames; ++i) {
+            const RawFrameHeader header = testHeader(i, 0);
+            writer.append(header, testData(header).data());
+        }
+    }
+
+    // The preallocated space is removed when the writer is destroyed
+    CHECK(std::filesystem::file_size(file.path) < 64 * 1024);
+
+    RawCaptureReader reader(file.path);
+    std::vector<unsigned char> data;
+    for (uint64_t i = 0; i < nFrames; ++i) {
+        std::optional<RawFrameHeader> header = reader.nextFrame(data);
+        REQUIRE(header.has_value());
+        CHECK(header->frameNumber == i);
+        CHECK(header->width == testHeader(i, 0).width);
+        CHECK(data == testData(*header));
+    }
+    CHECK_FALSE(reader.nextFrame(data).has_value());
+}
+
+TEST_CASE("RawCapture/Grow from multiple threads", "[RawCapture]") {
+    TestFile file;
+
+    // A small growth size remaps the file many times while other threads are writing
+    constexpr const uint32_t nThreads = 4;
+    constexpr const uint64_t nFrames = 100;
+    {
+        RawCaptureWriter writer(file.path, 4096);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < nThreads; ++t) {
+            threads.emplace_back([&writer, t]() {
+                for (uint64_t i = 0; i < nFrames; ++i) {
+                    const RawFrameHeader header = testHeader(i, t);
+                    writer.append(header, testData(header).data());
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // The frames of the threads are interleaved, but each thread's frames are in order
+    RawCaptureReader reader(file.path);
+    std::vector<uint64_t> nextFrame(nThreads, 0);
+    std::vector<unsigned char> data;
+    bool isCorrect = true;
+    for (uint64_t i = 0; i < nThreads * nFrames; ++i) {
+        std::optional<RawFrameHeader> header = reader.nextFrame(data);
+        REQUIRE(header.has_value());
+        REQUIRE(header->windowId < nThreads);
+        isCorrect &= header->frameNumber == nextFrame[header->windowId];
+        isCorrect &= data == testData(*header);
+        nextFrame[header->windowId]++;
+    }
+    CHECK(isCorrect);
+    CHECK_FALSE(reader.nextFrame(data).has_value());
+}